@@ -37,13 +37,25 @@ MeshEntity* getMeshEntity(MeshElement* me)
 
 MeshElement* createMeshElement(Mesh* m, MeshEntity* e)
 {
-  return new VectorElement(static_cast<VectorField*>(
-        m->getCoordinateField()), e);
+  VectorField* f = static_cast<VectorField*>(m->getCoordinateField());
+  Element* pooled = f->takeElement(Field::MESH_ELEMENTS);
+  if (pooled) {
+    pooled->reset(e, 0);
+    return static_cast<MeshElement*>(pooled);
+  }
+  MeshElement* me = new VectorElement(f, e);
+  f->adoptElement(me);
+  return me;
 }
 
 void destroyMeshElement(MeshElement* e)
 {
-  delete e;
+  giveElement(Field::MESH_ELEMENTS, e);
+}
+
+void resetMeshElement(MeshElement* me, MeshEntity* e)
+{
+  me->reset(e, 0);
 }
 
 Field* makeField(
@@ -206,17 +218,46 @@ void getComponents(Field* f, MeshEntity* e, int node, double* components)
 
 Element* createElement(Field* f, MeshElement* e)
 {
-  return f->getElement(e);
+  Element* pooled = f->takeElement(Field::ELEMENTS);
+  if (pooled) {
+    pooled->reset(e->getEntity(), e);
+    return pooled;
+  }
+  Element* fe = f->getElement(e);
+  f->adoptElement(fe);
+  return fe;
 }
 
 Element* createElement(Field* f, MeshEntity* e)
 {
-  return new Element(f,e);
+  Element* pooled = f->takeElement(Field::ENTITY_ELEMENTS);
+  if (pooled) {
+    pooled->reset(e, 0);
+    return pooled;
+  }
+  Element* fe = new Element(f,e);
+  f->adoptElement(fe);
+  return fe;
 }
 
+/* elements with a parent came from Field::getElement and have the
+   field's element class, the others are plain Elements */
 void destroyElement(Element* e)
 {
-  delete e;
+  int kind = e->getParent() ? Field::ELEMENTS : Field::ENTITY_ELEMENTS;
+  giveElement(kind, e);
+}
+
+void resetElement(Element* e, MeshElement* me)
+{
+  PCU_ALWAYS_ASSERT(e->getParent());
+  e->reset(me->getEntity(), me);
+}
+
+void resetElement(Element* e, MeshEntity* entity)
+{
+  PCU_ALWAYS_ASSERT( ! e->getParent());
+  e->reset(entity, 0);
 }
 
 MeshElement* getMeshElement(Element* e)
@@ -283,9 +324,9 @@ int countIntPoints(MeshElement* e, int order)
 
 void getIntPoint(MeshElement* e, int order, int point, Vector3& param)
 {
-  IntegrationPoint const* p = 
-    getIntegration(e->getType())->getAccurate(order)->getPoint(point);
-  param = p->param;
+  Integration const* in = getIntegration(e->getType())->getAccurate(order);
+  param = in->getPoint(point)->param;
+  e->setIntPoint(in, point, param);
 }
 
 double getIntWeight(MeshElement* e, int order, int point)
@@ -348,7 +389,7 @@ void getMatrixNodes(Element* e, NewArray<Matrix3x3>& values)
 void getShapeValues(Element* e, Vector3 const& local,
     NewArray<double>& values)
 {
-  e->getShape()->getValues(e->getMesh(), e->getEntity(), local,values);
+  e->getShapeValues(local,values);
 }
 
 void getShapeGrads(Element* e, Vector3 const& local,
@@ -392,17 +433,30 @@ void accumulate(Field* f, Sharing* shr)
   accumulateFieldData(f->getData(), shr);
 }
 
+void synchronize(Field* f, Exchange* x)
+{
+  synchronizeFieldData(f->getData(), x);
+}
+
+void accumulate(Field* f, Exchange* x, bool ghosts, bool deterministic)
+{
+  accumulateFieldData(f->getData(), x, ghosts, deterministic);
+}
+
 void fail(const char* why)
 {
   fprintf(stderr,"APF FAILED: %s\n",why);
   abort();
 }
 
-void freeze(Field* f)
+void freeze(Field* f, int layout)
 {
-  if (isFrozen(f)) return;
+  if (isFrozen(f)) {
+    if (getArrayLayout(f) == layout) return;
+    unfreezeFieldData<double>(f);
+  }
   f->getMesh()->hasFrozenFields = true;
-  freezeFieldData<double>(f);
+  freezeFieldData<double>(f, layout);
 }
 
 void unfreeze(Field* f)
@@ -63,9 +63,21 @@ MeshEntity * getMeshEntity(MeshElement * me);
   *
   * \details This only destroys the apf::MeshElement object,
   * the underlying mesh entity and field data are unaffected.
+  * The object is kept for reuse by the next apf::createMeshElement.
+  * It may be destroyed after the mesh or its coordinate field,
+  * in which case it is simply freed.
   */
 void destroyMeshElement(MeshElement* e);
 
+/** \brief Rebind a Mesh Element to another entity of the same mesh.
+  *
+  * \details This reuses the storage of the Mesh Element, which is
+  * cheaper than destroying it and creating a new one inside loops.
+  * Field Elements built on it must be rebound with apf::resetElement
+  * before their next use.
+  */
+void resetMeshElement(MeshElement* me, MeshEntity* e);
+
 /** \brief The type of value the field stores.
   *
   * \details The near future may bring more complex tensors.
@@ -230,9 +242,26 @@ Element* createElement(Field* f, MeshElement* e);
 Element* createElement(Field* f, MeshEntity* e);
 
 /** \brief Destroy a Field Element.
- */
+  *
+  * \details The object is kept by its field for reuse by the next
+  * apf::createElement of that field.
+  * It may be destroyed after its field, in which case it is
+  * simply freed.
+  */
 void destroyElement(Element* e);
 
+/** \brief Rebind a Field Element to a Mesh Element.
+  *
+  * \details The Field Element must have been created from a
+  * Mesh Element, typically the same one after apf::resetMeshElement.
+  * Node data storage is reused when the element type is unchanged.
+  */
+void resetElement(Element* e, MeshElement* me);
+
+/** \brief Rebind a Field Element without a parent Mesh Element
+    to another entity. */
+void resetElement(Element* e, MeshEntity* entity);
+
 /** \brief Get the Mesh Element of a Field Element.
   *
   * \details Each apf::Element operates over
@@ -559,6 +588,43 @@ void synchronize(Field* f, Sharing* shr = 0);
   */
 void accumulate(Field* f, Sharing* shr = 0);
 
+/** \brief Precomputed communication for repeated
+  apf::synchronize and apf::accumulate calls */
+struct Exchange;
+
+/** \brief Precompute the communication of synchronize and accumulate.
+  \details Using the ownership and copies described by an apf::Sharing
+  object, which is deleted as in apf::synchronize, and the ghost copies
+  of the mesh, this lists for each peer the entities whose values
+  are exchanged, in the same order on both parts.
+  The calls that use it then send only values.
+  The result serves all fields of the same shape
+  until the mesh is modified.
+  */
+Exchange* makeExchange(Field* f, Sharing* shr = 0);
+
+/** \brief Free an apf::Exchange */
+void destroyExchange(Exchange* x);
+
+/** \brief Synchronize field values using a precomputed exchange.
+  \details As apf::synchronize, owners send values to
+  their copies and ghosts. Entities without values send zeros.
+  */
+void synchronize(Field* f, Exchange* x);
+
+/** \brief Add field values using a precomputed exchange.
+  \details As apf::accumulate, the owner of each entity adds the
+  values of its copies and sends the sum back to all copies
+  and ghosts. Entities without values count as zeros.
+  \param ghosts if true, ghosts also add their values to the owner.
+         This must agree on all parts.
+  \param deterministic if true, owners add the incoming values in
+         increasing part order instead of order of arrival, so
+         sums are bitwise identical from run to run
+  */
+void accumulate(Field* f, Exchange* x, bool ghosts = false,
+    bool deterministic = false);
+
 /** \brief Declare failure of code inside APF.
   \details This function prints the string as an APF
   failure to stderr and then calls abort.
@@ -567,8 +633,22 @@ void accumulate(Field* f, Sharing* shr = 0);
   */
 void fail(const char* why) __attribute__((noreturn));
 
-/** \brief Convert a Field from Tag to array storage. */
-void freeze(Field* f);
+/** \brief Orderings of the array storage of frozen fields */
+enum ArrayLayout {
+  /** \brief the components of each node are contiguous */
+  NODE_MAJOR,
+  /** \brief each component is contiguous over all nodes */
+  COMPONENT_MAJOR
+};
+
+/** \brief Convert a Field from Tag to array storage.
+  \details On meshes with dense entity indices (see
+  apf::Mesh::getTypeIndex, provided by MDS) the nodes are stored
+  by dimension, then type, then entity index, and found without
+  any lookups. Other meshes order the nodes by an overlap numbering.
+  Freezing a frozen field with another layout reorders it.
+  \param layout select from apf::ArrayLayout */
+void freeze(Field* f, int layout = NODE_MAJOR);
 
 /** \brief Convert a Field from array to Tag storage. */
 void unfreeze(Field* f);
@@ -583,6 +663,18 @@ bool isFrozen(Field* f);
  */
 double* getArrayData(Field* f);
 
+/** \brief Return the number of values in the array of a frozen field
+  \details with MDS indices this may include unused entries left
+  by destroyed entities */
+int countArrayData(Field* f);
+
+/** \brief Return the apf::ArrayLayout of a frozen field */
+int getArrayLayout(Field* f);
+
+/** \brief Return the position of a nodal component of a frozen field
+  in the array given by apf::getArrayData */
+int getArrayIndex(Field* f, MeshEntity* e, int node, int component);
+
 /** \brief Initialize all nodal values with all-zero components */
 void zeroField(Field* f);
 
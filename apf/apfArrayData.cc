@@ -8,19 +8,44 @@ template <class T>
 class ArrayDataOf : public FieldDataOf<T>
 {
   public:
+    ArrayDataOf(int l):
+      layout(l),
+      num_var(0),
+      dataArray(0)
+    {
+    }
     virtual void init(FieldBase* f)
     {
       /* this class inherits a variable (field),
          lets initialize it */
       this->field = f;
       /* this has to set up the array */
+      Mesh* m = f->getMesh();
       FieldShape* s = f->getShape();
-      const char* name = s->getName();
-      Numbering* n = f->getMesh()->findNumbering(name);
-      if (n) apf::destroyNumbering(n);
-      num_var = numberOverlapNodes(f->getMesh(),name,s);
-      arraySize = f->countComponents()*countNodes(num_var);
-      dataArray = new T[arraySize];
+      if (!hasTypeIndices(m)) {
+        /* no dense indices, number the nodes instead */
+        const char* name = s->getName();
+        Numbering* n = m->findNumbering(name);
+        if (n) apf::destroyNumbering(n);
+        num_var = numberOverlapNodes(m,name,s);
+        nodeCount = countNodes(num_var);
+      } else {
+        /* the nodes of entity (i) of type (t) start at
+           offsets[t] + i * nodesOn[t], ordered by dimension */
+        nodeCount = 0;
+        for (int d = 0; d <= m->getDimension(); ++d)
+          for (int t = 0; t < Mesh::TYPES; ++t) {
+            if (Mesh::typeDimension[t] != d)
+              continue;
+            nodesOn[t] = s->countNodesOn(t);
+            offsets[t] = nodeCount;
+            if (nodesOn[t])
+              nodeCount += m->countTypeIndices(t) * nodesOn[t];
+          }
+      }
+      components = f->countComponents();
+      arraySize = components*nodeCount;
+      dataArray = new T[arraySize]();
     }
     virtual ~ArrayDataOf()
     {
@@ -42,23 +67,33 @@ class ArrayDataOf : public FieldDataOf<T>
     virtual void get(MeshEntity* e, T* data)
     {
       /* this retrieves all the data associated with (e) */
-      int first_node_index = getNumber(this->num_var,e,0,0);
+      int first = getFirstNode(e);
       int num_nodes = this->field->countNodesOn(e);
-      int num_components = this->field->countComponents();
-      int start = first_node_index*num_components;
-      for (int i=0; i<num_nodes*num_components; i++) {
-         data[i] = this->dataArray[start+i];
+      if (layout == NODE_MAJOR) {
+        T const* p = this->dataArray + first*components;
+        for (int i=0; i<num_nodes*components; i++)
+          data[i] = p[i];
+      } else {
+        for (int n=0; n<num_nodes; n++)
+          for (int c=0; c<components; c++)
+            data[n*components+c] =
+              this->dataArray[c*nodeCount+first+n];
       }
     }
     virtual void set(MeshEntity* e, T const* data)
     {
       /* this stores all the data associated with (e) */
-      int first_node_index = getNumber(this->num_var,e,0,0);
+      int first = getFirstNode(e);
       int num_nodes = this->field->countNodesOn(e);
-      int num_components = this->field->countComponents();
-      int start = first_node_index*num_components;
-      for (int i=0; i<num_nodes*num_components; i++) {
-          this->dataArray[start+i] = data[i];
+      if (layout == NODE_MAJOR) {
+        T* p = this->dataArray + first*components;
+        for (int i=0; i<num_nodes*components; i++)
+          p[i] = data[i];
+      } else {
+        for (int n=0; n<num_nodes; n++)
+          for (int c=0; c<components; c++)
+            this->dataArray[c*nodeCount+first+n] =
+              data[n*components+c];
       }
     }
 
@@ -69,19 +104,53 @@ class ArrayDataOf : public FieldDataOf<T>
     T* getDataArray() {
       return this->dataArray;
     }
+    int getSize() {
+      return arraySize;
+    }
+    int getLayout() {
+      return layout;
+    }
+    int getIndex(MeshEntity* e, int node, int component)
+    {
+      int n = getFirstNode(e) + node;
+      if (layout == NODE_MAJOR)
+        return n*components + component;
+      return component*nodeCount + n;
+    }
 
   private:
+    /* an empty mesh needs no storage either way */
+    static bool hasTypeIndices(Mesh* m)
+    {
+      MeshIterator* it = m->begin(0);
+      MeshEntity* v = m->iterate(it);
+      m->end(it);
+      return !v || m->getTypeIndex(v) != -1;
+    }
+    int getFirstNode(MeshEntity* e)
+    {
+      if (num_var)
+        return getNumber(this->num_var,e,0,0);
+      Mesh* m = this->field->getMesh();
+      int t = m->getType(e);
+      return offsets[t] + m->getTypeIndex(e)*nodesOn[t];
+    }
     /* data variables go here */
+    int layout;
     Numbering* num_var; 
+    int offsets[Mesh::TYPES];
+    int nodesOn[Mesh::TYPES];
+    int nodeCount;
+    int components;
     int arraySize;
     T* dataArray;
 };
 
 template <class T>
-void freezeFieldData(FieldBase* field)
+void freezeFieldData(FieldBase* field, int layout)
 {
   /* make a new data store of array type */
-  ArrayDataOf<T>* newData = new ArrayDataOf<T>();
+  ArrayDataOf<T>* newData = new ArrayDataOf<T>(layout);
   /* call the init function to setup storage */
   newData->init(field);
   /* get the old data store */
@@ -107,8 +176,8 @@ void unfreezeFieldData(FieldBase* field) {
 }
 
 /* instantiate here */
-template void freezeFieldData<int>(FieldBase* field);
-template void freezeFieldData<double>(FieldBase* field);
+template void freezeFieldData<int>(FieldBase* field, int layout);
+template void freezeFieldData<double>(FieldBase* field, int layout);
 template void unfreezeFieldData<int>(FieldBase* field);
 template void unfreezeFieldData<double>(FieldBase* field);
 
@@ -122,4 +191,26 @@ double* getArrayData(Field* f) {
   }
 }
 
+static ArrayDataOf<double>* getArray(Field* f)
+{
+  if (!isFrozen(f))
+    fail("array data requested for a field that is not frozen");
+  return static_cast<ArrayDataOf<double>*>(f->getData());
+}
+
+int countArrayData(Field* f)
+{
+  return getArray(f)->getSize();
+}
+
+int getArrayLayout(Field* f)
+{
+  return getArray(f)->getLayout();
+}
+
+int getArrayIndex(Field* f, MeshEntity* e, int node, int component)
+{
+  return getArray(f)->getIndex(e, node, component);
+}
+
 }
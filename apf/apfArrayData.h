@@ -13,7 +13,7 @@
 namespace apf {
 
 template <class T>
-void freezeFieldData(FieldBase* base);
+void freezeFieldData(FieldBase* base, int layout);
 template <class T>
 void unfreezeFieldData(FieldBase* base);
 }
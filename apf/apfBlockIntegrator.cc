@@ -0,0 +1,245 @@
+/*
+ * Copyright 2011 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "apfBlockIntegrator.h"
+#include "apfIntegrate.h"
+#include "apfShapeTable.h"
+#include "apfField.h"
+#include "apfFieldData.h"
+#include "apfMesh.h"
+#include <cmath>
+#include <sstream>
+#include <algorithm>
+
+namespace apf {
+
+double IntegrationBlock::getWeight(int p) const
+{
+  return integration->getPoint(p)->weight;
+}
+
+Vector3 const& IntegrationBlock::getParam(int p) const
+{
+  return integration->getPoint(p)->param;
+}
+
+BlockIntegrator::BlockIntegrator(int o, int n):
+  order(o),
+  blockSize(n)
+{
+}
+
+BlockIntegrator::~BlockIntegrator()
+{
+}
+
+int BlockIntegrator::addField(Field* f)
+{
+  fields.push_back(f);
+  return static_cast<int>(fields.size()) - 1;
+}
+
+void BlockIntegrator::parallelReduce()
+{
+}
+
+void BlockIntegrator::process(Mesh* m)
+{
+  int d = m->getDimension();
+  MeshEntity* e;
+  MeshIterator* it = m->begin(d);
+  while ((e = m->iterate(it))) {
+    if ( ! m->isOwned(e)) continue;
+    int type = m->getType(e);
+    pending[type].push_back(e);
+    if (static_cast<int>(pending[type].size()) == blockSize)
+      processBlock(m, type);
+  }
+  m->end(it);
+  for (int type = 0; type < Mesh::TYPES; ++type)
+    if (!pending[type].empty())
+      processBlock(m, type);
+  this->parallelReduce();
+}
+
+static ShapeTable const* getTable(FieldShape* s, int type,
+    Integration const* in)
+{
+  ShapeTable const* t = getShapeTable(s, type, in);
+  if (!t) {
+    std::stringstream ss;
+    ss << "BlockIntegrator: the " << s->getName()
+       << " shape functions can not be tabulated\n";
+    std::string str = ss.str();
+    fail(str.c_str());
+  }
+  return t;
+}
+
+void BlockIntegrator::processBlock(Mesh* m, int type)
+{
+  IntegrationBlock& b = block;
+  b.type = type;
+  b.elements.assign(pending[type].begin(), pending[type].end());
+  pending[type].clear();
+  b.size = static_cast<int>(b.elements.size());
+  b.stride = blockSize;
+  b.integration = getIntegration(type)->getAccurate(order);
+  if (!b.integration) {
+    std::stringstream ss;
+    ss << "BlockIntegrator: no integration of order " << order
+       << " for " << Mesh::typeName[type] << '\n';
+    std::string str = ss.str();
+    fail(str.c_str());
+  }
+  b.points = b.integration->countPoints();
+  int dim = Mesh::typeDimension[type];
+  ShapeTable const* t = getTable(m->getShape(), type, b.integration);
+  gatherNodes(m->getCoordinateField(), t->countNodes(), 3, b.coordinates);
+  evaluateGeometry(t, dim);
+  b.fields.resize(fields.size());
+  for (size_t f = 0; f < fields.size(); ++f) {
+    t = getTable(fields[f]->getShape(), type, b.integration);
+    int nc = fields[f]->countComponents();
+    b.fields[f].components = nc;
+    gatherNodes(fields[f], t->countNodes(), nc, b.fields[f].nodes);
+    evaluateField(t, f, dim);
+  }
+  this->atBlock(b);
+}
+
+void BlockIntegrator::gatherNodes(Field* f, int nodes, int components,
+    std::vector<double>& out)
+{
+  IntegrationBlock& b = block;
+  int s = b.stride;
+  int nv = nodes * components;
+  out.assign(nv * s, 0);
+  NewArray<double> data;
+  FieldDataOf<double>* fd = f->getData();
+  for (int e = 0; e < b.size; ++e) {
+    fd->getElementData(b.elements[e], data);
+    for (int i = 0; i < nv; ++i)
+      out[i * s + e] = data[i];
+  }
+}
+
+/* computes coordinates, differential volumes and the (pseudo) inverse
+   Jacobian at every point. J has one row per parent direction, the
+   inverse follows getJacobianInverse and the volume follows
+   getJacobianDeterminant */
+void BlockIntegrator::evaluateGeometry(ShapeTable const* t, int dim)
+{
+  IntegrationBlock& b = block;
+  int n = b.size;
+  int s = b.stride;
+  int nodes = t->countNodes();
+  b.x.assign(b.points * 3 * s, 0);
+  b.dV.assign(b.points * s, 0);
+  b.jacobianInverse.assign(b.points * 9 * s, 0);
+  std::vector<double> jac(9 * s);
+  for (int p = 0; p < b.points; ++p) {
+    double const* sv = t->getValues(p);
+    Vector3 const* sg = t->getLocalGradients(p);
+    double* x = &b.x[p * 3 * s];
+    double* J = &jac[0];
+    std::fill(jac.begin(), jac.end(), 0);
+    for (int a = 0; a < nodes; ++a)
+      for (int c = 0; c < 3; ++c) {
+        double const* X = &b.coordinates[(a * 3 + c) * s];
+        for (int e = 0; e < n; ++e)
+          x[c * s + e] += sv[a] * X[e];
+        for (int r = 0; r < dim; ++r) {
+          double gr = sg[a][r];
+          double* Jrc = J + (r * 3 + c) * s;
+          for (int e = 0; e < n; ++e)
+            Jrc[e] += gr * X[e];
+        }
+      }
+    double* dV = &b.dV[p * s];
+    double* inv = &b.jacobianInverse[p * 9 * s];
+    for (int e = 0; e < n; ++e) {
+      Vector3 r0(J[0 * s + e], J[1 * s + e], J[2 * s + e]);
+      Vector3 r1(J[3 * s + e], J[4 * s + e], J[5 * s + e]);
+      Vector3 r2(J[6 * s + e], J[7 * s + e], J[8 * s + e]);
+      if (dim == 3) {
+        /* the columns of the inverse are the cross products
+           of the rows over the determinant */
+        Vector3 c0 = cross(r1, r2);
+        Vector3 c1 = cross(r2, r0);
+        Vector3 c2 = cross(r0, r1);
+        double det = r0 * c0;
+        dV[e] = det;
+        for (int i = 0; i < 3; ++i) {
+          inv[(i * 3 + 0) * s + e] = c0[i] / det;
+          inv[(i * 3 + 1) * s + e] = c1[i] / det;
+          inv[(i * 3 + 2) * s + e] = c2[i] / det;
+        }
+      } else if (dim == 2) {
+        /* (J J^T)^{-1} J, transposed */
+        double aa = r0 * r0;
+        double ab = r0 * r1;
+        double bb = r1 * r1;
+        double det = aa * bb - ab * ab;
+        dV[e] = std::sqrt(det);
+        for (int i = 0; i < 3; ++i) {
+          inv[(i * 3 + 0) * s + e] = (bb * r0[i] - ab * r1[i]) / det;
+          inv[(i * 3 + 1) * s + e] = (aa * r1[i] - ab * r0[i]) / det;
+        }
+      } else {
+        double aa = r0 * r0;
+        dV[e] = std::sqrt(aa);
+        for (int i = 0; i < 3; ++i)
+          inv[(i * 3 + 0) * s + e] = r0[i] / aa;
+      }
+    }
+  }
+}
+
+void BlockIntegrator::evaluateField(ShapeTable const* t, int f, int dim)
+{
+  IntegrationBlock& b = block;
+  IntegrationBlock::FieldValues& fv = b.fields[f];
+  int n = b.size;
+  int s = b.stride;
+  int nc = fv.components;
+  int nodes = t->countNodes();
+  fv.values.assign(b.points * nc * s, 0);
+  fv.grads.assign(b.points * nc * 3 * s, 0);
+  std::vector<double> local(nc * 3 * s);
+  for (int p = 0; p < b.points; ++p) {
+    double const* sv = t->getValues(p);
+    Vector3 const* sg = t->getLocalGradients(p);
+    double* v = &fv.values[p * nc * s];
+    std::fill(local.begin(), local.end(), 0);
+    for (int a = 0; a < nodes; ++a)
+      for (int c = 0; c < nc; ++c) {
+        double const* U = &fv.nodes[(a * nc + c) * s];
+        for (int e = 0; e < n; ++e)
+          v[c * s + e] += sv[a] * U[e];
+        for (int r = 0; r < dim; ++r) {
+          double gr = sg[a][r];
+          double* L = &local[(c * 3 + r) * s];
+          for (int e = 0; e < n; ++e)
+            L[e] += gr * U[e];
+        }
+      }
+    double const* inv = &b.jacobianInverse[p * 9 * s];
+    double* g = &fv.grads[p * nc * 3 * s];
+    for (int c = 0; c < nc; ++c)
+      for (int i = 0; i < 3; ++i)
+        for (int r = 0; r < dim; ++r) {
+          double const* L = &local[(c * 3 + r) * s];
+          double const* I = &inv[(i * 3 + r) * s];
+          double* G = &g[(c * 3 + i) * s];
+          for (int e = 0; e < n; ++e)
+            G[e] += I[e] * L[e];
+        }
+  }
+}
+
+}
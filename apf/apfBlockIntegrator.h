@@ -0,0 +1,143 @@
+/*
+ * Copyright 2011 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APFBLOCKINTEGRATOR_H
+#define APFBLOCKINTEGRATOR_H
+
+/** \file apfBlockIntegrator.h
+  \brief Integration over blocks of elements of the same type */
+
+#include "apf.h"
+#include "apfMesh.h"
+#include <vector>
+
+namespace apf {
+
+class Integration;
+class ShapeTable;
+
+/** \brief Values at the integration points of a block of elements
+  *
+  * \details All elements of a block have the same type and use the
+  * same integration rule. Arrays are laid out with the element index
+  * varying fastest: entry [i * getStride() + e] is component i for
+  * element e, so loops over the elements of a block are contiguous.
+  */
+class IntegrationBlock
+{
+  public:
+    /** \brief the element type, select from apf::Mesh::Type */
+    int getType() const {return type;}
+    /** \brief the number of elements in this block */
+    int count() const {return size;}
+    /** \brief the distance between components in the arrays,
+        no less than count() */
+    int getStride() const {return stride;}
+    /** \brief get element (e) of this block */
+    MeshEntity* getElement(int e) const {return elements[e];}
+    /** \brief the number of integration points per element */
+    int countPoints() const {return points;}
+    /** \brief the integration weight of point (p) */
+    double getWeight(int p) const;
+    /** \brief the parent coordinates of point (p) */
+    Vector3 const& getParam(int p) const;
+    /** \brief differential volumes at point (p), one per element */
+    double const* getDV(int p) const
+    {
+      return &dV[p * stride];
+    }
+    /** \brief global coordinates at point (p), 3 components */
+    double const* getCoordinates(int p) const
+    {
+      return &x[p * 3 * stride];
+    }
+    /** \brief values of field number (f) at point (p)
+      * \details the field has apf::countComponents components */
+    double const* getValues(int f, int p) const
+    {
+      return &fields[f].values[p * fields[f].components * stride];
+    }
+    /** \brief gradients of field number (f) at point (p)
+      * \details component (3 * i + j) is the derivative of field
+      * component i along global direction j */
+    double const* getGrads(int f, int p) const
+    {
+      return &fields[f].grads[p * fields[f].components * 3 * stride];
+    }
+  private:
+    friend class BlockIntegrator;
+    struct FieldValues
+    {
+      int components;
+      std::vector<double> nodes;
+      std::vector<double> values;
+      std::vector<double> grads;
+    };
+    int type;
+    int size;
+    int stride;
+    int points;
+    Integration const* integration;
+    std::vector<MeshEntity*> elements;
+    std::vector<double> coordinates;
+    std::vector<double> x;
+    std::vector<double> dV;
+    std::vector<double> jacobianInverse;
+    std::vector<FieldValues> fields;
+};
+
+/** \brief Integrates over a Mesh in blocks of elements
+  *
+  * \details Owned elements are grouped by type into blocks of up to
+  * blockSize elements. For each block the nodal values of the
+  * coordinates and of every added field are gathered, then the
+  * Jacobians, differential volumes, field values and field gradients
+  * are computed at all integration points of all elements at once,
+  * and atBlock is called once per block.
+  *
+  * The coordinate field and the added fields must use shape functions
+  * that can be tabulated (see apf::FieldShape::canTabulate), which
+  * holds for the Lagrange and serendipity shapes.
+  */
+class BlockIntegrator
+{
+  public:
+    /** \brief Construct a BlockIntegrator given an order of accuracy
+      * and the largest number of elements in a block. */
+    BlockIntegrator(int o, int blockSize = 64);
+    virtual ~BlockIntegrator();
+    /** \brief Evaluate this field in every block.
+      *
+      * \returns the index of the field in
+      * apf::IntegrationBlock::getValues and getGrads
+      */
+    int addField(Field* f);
+    /** \brief Run the BlockIntegrator over the local Mesh. */
+    void process(Mesh* m);
+    /** \brief User callback: accumulation over a block. */
+    virtual void atBlock(IntegrationBlock const& b) = 0;
+    /** \brief User callback: parallel reduction.
+      *
+      * \details as in apf::Integrator */
+    virtual void parallelReduce();
+  protected:
+    int order;
+  private:
+    void processBlock(Mesh* m, int type);
+    void gatherNodes(Field* f, int nodes, int components,
+        std::vector<double>& out);
+    void evaluateGeometry(ShapeTable const* t, int dim);
+    void evaluateField(ShapeTable const* t, int f, int dim);
+    int blockSize;
+    std::vector<Field*> fields;
+    std::vector<MeshEntity*> pending[Mesh::TYPES];
+    IntegrationBlock block;
+};
+
+}
+
+#endif
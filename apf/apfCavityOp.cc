@@ -6,6 +6,7 @@
  */
 
 #include <PCU.h>
+#include <pcu_util.h>
 #include "apfCavityOp.h"
 #include "apf.h"
 #include "apfMesh2.h"
@@ -16,8 +17,24 @@ CavityOp::CavityOp(Mesh* m, bool cm):
   mesh(m),
   isRequesting(false),
   canModify(cm),
+  incremental(false),
   movedByDeletion(false),
   iterator(0),
+  movedTag(0),
+  revisitTag(0),
+  sharing(0)
+{
+}
+
+CavityOp::CavityOp(Mesh* m, bool cm, bool inc):
+  mesh(m),
+  isRequesting(false),
+  canModify(cm),
+  incremental(inc),
+  movedByDeletion(false),
+  iterator(0),
+  movedTag(0),
+  revisitTag(0),
   sharing(0)
 {
 }
@@ -59,14 +76,23 @@ void CavityOp::applyLocallyWithModification(int d)
   while ((e = mesh2->iterate(this->iterator)))
   {
     if ( ! sharing->isOwned(e)) continue;
-    setEntity(e);
+    if (setEntity(e) == REQUEST)
+      deferEntity(e);
   }
   mesh2->end(this->iterator);
+  this->iterator = 0;
 }
 
 void CavityOp::preDeletion(MeshEntity* e)
 {
   Mesh2* mesh2 = static_cast<Mesh2*>(mesh);
+  /* worklist passes have no iterator to protect,
+     but the worklist itself must forget the entity */
+  if ( ! this->iterator)
+  {
+    forgetWorklistEntity(e);
+    return;
+  }
   if (( ! mesh2->isDone(this->iterator))&&
       (e == mesh2->deref(this->iterator)))
   {
@@ -90,32 +116,201 @@ void CavityOp::applyLocallyWithoutModification(int d)
     Outcome o = setEntity(e);
     if (o == OK)
       apply();
+    else if (o == REQUEST)
+      deferEntity(e);
   }
   mesh->end(entities);
 }
 
+/* during a worklist pass the revisit tag of each worklist
+   entity holds its position, so preDeletion can clear the
+   slot and no deleted entity is dereferenced afterwards */
+void CavityOp::forgetWorklistEntity(MeshEntity* e)
+{
+  if (( ! revisitTag) || ( ! mesh->hasTag(e, revisitTag)))
+    return;
+  int i;
+  mesh->getIntTag(e, revisitTag, &i);
+  PCU_ALWAYS_ASSERT(worklist[i] == e);
+  worklist[i] = 0;
+  mesh->removeTag(e, revisitTag);
+}
+
+/* slots cleared because an earlier apply()
+   deleted their entity are skipped by both loops */
+void CavityOp::applyToWorklistWithModification()
+{
+  this->iterator = 0;
+  for (int i = 0; i < (int)worklist.size(); ++i)
+    mesh->setIntTag(worklist[i], revisitTag, &i);
+  isRequesting = false;
+  for (size_t i = 0; i < worklist.size(); ++i)
+  {
+    MeshEntity* e = worklist[i];
+    if ( ! e)
+      continue;
+    if (sharing->isOwned(e) && setEntity(e) == OK)
+      apply();
+  }
+  isRequesting = true;
+  for (size_t i = 0; i < worklist.size(); ++i)
+  {
+    MeshEntity* e = worklist[i];
+    if ( ! e)
+      continue;
+    if (( ! sharing->isOwned(e)) || setEntity(e) != REQUEST)
+      mesh->removeTag(e, revisitTag);
+  }
+  worklist.clear();
+}
+
+void CavityOp::applyToWorklistWithoutModification()
+{
+  isRequesting = true;
+  for (size_t i = 0; i < worklist.size(); ++i)
+  {
+    MeshEntity* e = worklist[i];
+    Outcome o = setEntity(e);
+    if (o == OK)
+      apply();
+    if (o != REQUEST)
+      mesh->removeTag(e, revisitTag);
+  }
+  worklist.clear();
+}
+
+void CavityOp::deferEntity(MeshEntity* e)
+{
+  if (( ! incremental) || mesh->hasTag(e, revisitTag))
+    return;
+  int dummy = 1;
+  mesh->setIntTag(e, revisitTag, &dummy);
+}
+
+/* tags travel with migrated entities, so elements
+   tagged here arrive tagged on their new part */
+void CavityOp::markMovingElements(Migration* plan)
+{
+  int dummy = 1;
+  for (int i = 0; i < plan->count(); ++i)
+    mesh->setIntTag(plan->get(i), movedTag, &dummy);
+}
+
+/* the worklist holds the owned entities that were deferred
+   plus those touching a vertex of a migrated element,
+   since those are the only cavities that may have changed.
+   the scans below only read tags, which is much cheaper
+   than calling setEntity on every entity */
+void CavityOp::buildWorklist(int d)
+{
+  MeshIterator* it = mesh->begin(mesh->getDimension());
+  MeshEntity* elem;
+  while ((elem = mesh->iterate(it)))
+  {
+    if ( ! mesh->hasTag(elem, movedTag))
+      continue;
+    mesh->removeTag(elem, movedTag);
+    Downward verts;
+    int nv = mesh->getDownward(elem, 0, verts);
+    for (int i = 0; i < nv; ++i)
+    {
+      Adjacent near;
+      mesh->getAdjacent(verts[i], d, near);
+      for (size_t j = 0; j < near.getSize(); ++j)
+        deferEntity(near[j]);
+    }
+  }
+  mesh->end(it);
+  /* non-owned candidates are forwarded to their copies,
+     since ownership may have moved to a part that did
+     not receive any elements */
+  worklist.clear();
+  PCU_Comm_Begin();
+  it = mesh->begin(d);
+  MeshEntity* e;
+  while ((e = mesh->iterate(it)))
+  {
+    if ( ! mesh->hasTag(e, revisitTag))
+      continue;
+    if (sharing->isOwned(e))
+    {
+      worklist.push_back(e);
+      continue;
+    }
+    CopyArray copies;
+    sharing->getCopies(e, copies);
+    APF_ITERATE(CopyArray, copies, cit)
+      PCU_COMM_PACK(cit->peer, cit->entity);
+    mesh->removeTag(e, revisitTag);
+  }
+  mesh->end(it);
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive())
+  {
+    PCU_COMM_UNPACK(e);
+    if (sharing->isOwned(e) && ! mesh->hasTag(e, revisitTag))
+    {
+      deferEntity(e);
+      worklist.push_back(e);
+    }
+  }
+}
+
+/* NormalSharing only queries the mesh, so one object
+   stays valid across migrations. MatchedSharing caches
+   neighbor element counts and has to be rebuilt. */
+void CavityOp::updateSharing()
+{
+  if (sharing && ! mesh->hasMatching())
+    return;
+  delete sharing;
+  sharing = apf::getSharing(mesh);
+}
+
 void CavityOp::applyToDimension(int d)
 {
+  if (incremental)
+  {
+    movedTag = mesh->createIntTag("apf_cavity_moved", 1);
+    revisitTag = mesh->createIntTag("apf_cavity_revisit", 1);
+  }
+  bool isFirstRound = true;
   /* the iteration count of this loop is hard to predict,
    * but typical cavity definitions should cause a small
    * constant number of iterations that does not grow
    * with parallelism
    */
   do {
-    delete sharing;
-    sharing = apf::getSharing(mesh);
+    updateSharing();
     /* apply the operator to all local cavities
+       (or just the worklist in incremental mode)
        and request missing cavity elements */
-    if (this->canModify)
+    if (incremental && ( ! isFirstRound))
+    {
+      this->buildWorklist(d);
+      if (this->canModify)
+        this->applyToWorklistWithModification();
+      else
+        this->applyToWorklistWithoutModification();
+    }
+    else if (this->canModify)
       this->applyLocallyWithModification(d);
     else
       this->applyLocallyWithoutModification(d);
+    isFirstRound = false;
     /* this is the exit of the loop:
        tryToPull will return false when no requests
        were made by any process, which should imply
        that all mesh entities that needed to be operated
        on have been. */
   } while (tryToPull());
+  if (incremental)
+  {
+    removeTagFromDimension(mesh, revisitTag, d);
+    mesh->destroyTag(revisitTag);
+    mesh->destroyTag(movedTag);
+    revisitTag = movedTag = 0;
+  }
   delete sharing;
   sharing = 0;
 }
@@ -225,6 +420,8 @@ bool CavityOp::tryToPull()
   Migration* plan = new Migration(mesh);
   for (std::size_t i=0; i < pulls.size(); ++i)
     markElements(plan,pulls[i].e,pulls[i].to);
+  if (incremental)
+    markMovingElements(plan);
   mesh->migrate(plan); //plan deleted here
   return true;
 }
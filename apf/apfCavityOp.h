@@ -60,6 +60,16 @@ namespace apf {
    To have an efficient CavityOp, setEntity() should
    store the cavity as a local variable for apply() to use.
 
+   If the operator is constructed in incremental mode,
+   only the first round visits every entity of the dimension.
+   Subsequent rounds visit a worklist made of entities that
+   returned REQUEST and entities near elements that were migrated,
+   so operators whose SKIP/OK outcome only changes when their
+   cavity changes avoid re-evaluating the whole part.
+   Entities created by apply() are never added to the worklist,
+   so later rounds only visit them when they are near
+   a migrated element.
+
    mesh modifying operators should call preDeletion(e) before
    actually deleting an entity to prevent a crash due to
    iterator invalidation.
@@ -73,6 +83,12 @@ class CavityOp
       \param canModify true iff the operator can create or
                        destroy mesh entities */
     CavityOp(Mesh* m, bool canModify = false);
+    /** \brief constructor
+      \param canModify true iff the operator can create or
+                       destroy mesh entities
+      \param incremental true to revisit only entities near
+                         changed cavities after the first round */
+    CavityOp(Mesh* m, bool canModify, bool incremental);
     /** \brief outcome of a setEntity call */
     enum Outcome {
       /** \brief skip the given entity */
@@ -102,9 +118,20 @@ class CavityOp
     bool tryToPull();
     void applyLocallyWithModification(int d);
     void applyLocallyWithoutModification(int d);
+    void applyToWorklistWithModification();
+    void applyToWorklistWithoutModification();
+    void markMovingElements(Migration* plan);
+    void buildWorklist(int d);
+    void deferEntity(MeshEntity* e);
+    void forgetWorklistEntity(MeshEntity* e);
+    void updateSharing();
     bool canModify;
+    bool incremental;
     bool movedByDeletion;
     MeshIterator* iterator;
+    std::vector<MeshEntity*> worklist;
+    MeshTag* movedTag;
+    MeshTag* revisitTag;
   protected:
     Sharing* sharing;
 };
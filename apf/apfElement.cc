@@ -9,6 +9,7 @@
 #include "apfShape.h"
 #include "apfMesh.h"
 #include "apfVectorElement.h"
+#include "apfShapeTable.h"
 
 namespace apf {
 
@@ -21,21 +22,40 @@ void Element::init(Field* f, MeshEntity* e, VectorElement* p)
   parent = p;
   nen = shape->countNodes();
   nc = f->countComponents();
+  integration = 0;
+  point = 0;
+  tabulated = 0;
+  table = 0;
   getNodeData();
 }
 
 Element::Element(Field* f, MeshEntity* e)
 {
   init(f,e,0);
+  pool = 0;
 }
 
 Element::Element(Field* f, VectorElement* p)
 {
   init(f,p->getEntity(),p);
+  pool = 0;
 }
 
 Element::~Element()
 {
+  releaseElementPool(pool);
+}
+
+void Element::reset(MeshEntity* e, VectorElement* p)
+{
+  EntityShape* oldShape = shape;
+  Integration const* oldTabulated = tabulated;
+  ShapeTable const* oldTable = table;
+  init(field, e, p);
+  if (shape == oldShape) {
+    tabulated = oldTabulated;
+    table = oldTable;
+  }
 }
 
 Matrix3x3 getJacobianInverse(Matrix3x3 J, int dim)
@@ -78,9 +98,15 @@ void Element::getGlobalGradients(Vector3 const& local,
   Matrix3x3 J;
   parent->getJacobian(local,J);
   Matrix3x3 jinv = getJacobianInverse(J, getDimension());
+  globalGradients.allocate(nen);
+  Vector3 const* tabulatedGradients = getTabulatedGradients(local);
+  if (tabulatedGradients) {
+    for (int i=0; i < nen; ++i)
+      globalGradients[i] = jinv * tabulatedGradients[i];
+    return;
+  }
   NewArray<Vector3> localGradients;
   shape->getLocalGradients(mesh, entity, local,localGradients);
-  globalGradients.allocate(nen);
   for (int i=0; i < nen; ++i)
     globalGradients[i] = jinv * localGradients[i];
 }
@@ -88,12 +114,72 @@ void Element::getGlobalGradients(Vector3 const& local,
 void Element::getComponents(Vector3 const& xi, double* c)
 {
   NewArray<double> shapeValues;
-  shape->getValues(mesh, entity, xi, shapeValues);
+  double const* values = getTabulatedValues(xi);
+  if (!values) {
+    shape->getValues(mesh, entity, xi, shapeValues);
+    values = &shapeValues[0];
+  }
   for (int ci = 0; ci < nc; ++ci)
     c[ci] = 0;
   for (int ni = 0; ni < nen; ++ni)
     for (int ci = 0; ci < nc; ++ci)
-      c[ci] += nodeData[ni * nc + ci] * shapeValues[ni];
+      c[ci] += nodeData[ni * nc + ci] * values[ni];
+}
+
+void Element::getShapeValues(Vector3 const& xi, NewArray<double>& values)
+{
+  double const* tabulatedValues = getTabulatedValues(xi);
+  if (!tabulatedValues) {
+    shape->getValues(mesh, entity, xi, values);
+    return;
+  }
+  values.allocate(nen);
+  for (int i=0; i < nen; ++i)
+    values[i] = tabulatedValues[i];
+}
+
+void Element::setIntPoint(Integration const* in, int p, Vector3 const& xi)
+{
+  integration = in;
+  point = p;
+  pointXi = xi;
+}
+
+/* the current integration point is kept by the mesh element,
+   which is this element or its parent. the table is used only
+   when (xi) is exactly that point */
+int Element::getTableRow(Vector3 const& xi)
+{
+  Element* source = parent ? parent : this;
+  Integration const* in = source->integration;
+  if (!in)
+    return -1;
+  Vector3 const& p = source->pointXi;
+  if (p[0] != xi[0] || p[1] != xi[1] || p[2] != xi[2])
+    return -1;
+  if (in != tabulated) {
+    table = getShapeTable(field->getShape(), getType(), in);
+    tabulated = in;
+  }
+  if (!table)
+    return -1;
+  return source->point;
+}
+
+double const* Element::getTabulatedValues(Vector3 const& xi)
+{
+  int row = getTableRow(xi);
+  if (row < 0)
+    return 0;
+  return table->getValues(row);
+}
+
+Vector3 const* Element::getTabulatedGradients(Vector3 const& xi)
+{
+  int row = getTableRow(xi);
+  if (row < 0)
+    return 0;
+  return table->getLocalGradients(row);
 }
 
 void Element::getNodeData()
@@ -16,6 +16,8 @@ namespace apf {
 
 class EntityShape;
 class VectorElement;
+class Integration;
+class ShapeTable;
 
 class Element
 {
@@ -32,10 +34,23 @@ class Element
     MeshEntity* getEntity() {return entity;}
     Mesh* getMesh() {return mesh;}
     EntityShape* getShape() {return shape;}
+    Field* getField() {return field;}
+    /* binds this element to another entity and parent, the node data
+       storage is reused when the number of nodes is unchanged */
+    void reset(MeshEntity* e, VectorElement* p);
     void getComponents(Vector3 const& xi, double* c);
+    void getShapeValues(Vector3 const& xi, NewArray<double>& values);
+    /* marks (xi) as point (p) of rule (in), so that evaluations here
+       and in elements built on this one can use tabulated shapes */
+    void setIntPoint(Integration const* in, int p, Vector3 const& xi);
+    /* the free lists this element returns to, see Field::adoptElement */
+    ElementPool* getPool() {return pool;}
+    void setPool(ElementPool* p) {pool = p;}
   protected:
     void init(Field* f, MeshEntity* e, VectorElement* p);
     void getNodeData();
+    double const* getTabulatedValues(Vector3 const& xi);
+    Vector3 const* getTabulatedGradients(Vector3 const& xi);
     Field* field;
     Mesh* mesh;
     MeshEntity* entity;
@@ -44,6 +59,14 @@ class Element
     int nen;
     int nc;
     NewArray<double> nodeData;
+  private:
+    int getTableRow(Vector3 const& xi);
+    Integration const* integration;
+    int point;
+    Vector3 pointXi;
+    Integration const* tabulated;
+    ShapeTable const* table;
+    ElementPool* pool;
 };
 
 Matrix3x3 getJacobianInverse(Matrix3x3 J, int dim);
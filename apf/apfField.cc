@@ -8,6 +8,7 @@
 #include "apfField.h"
 #include "apfShape.h"
 #include "apfTagData.h"
+#include "apfElement.h"
 
 namespace apf {
 
@@ -51,6 +52,70 @@ void FieldBase::rename(const char* newName)
   name = newName;
 }
 
+/* enough for the elements of a cavity */
+static const size_t maxFreeElements = 64;
+
+struct ElementPool
+{
+  /* zero once the field is destroyed */
+  Field* field;
+  /* one for the field and one per adopted element */
+  int references;
+  std::vector<Element*> freeElements[Field::ELEMENT_KINDS];
+};
+
+void releaseElementPool(ElementPool* p)
+{
+  if (p && ! --p->references)
+    delete p;
+}
+
+Field::~Field()
+{
+  if ( ! pool)
+    return;
+  for (int k = 0; k < ELEMENT_KINDS; ++k) {
+    std::vector<Element*>& v = pool->freeElements[k];
+    for (size_t i = 0; i < v.size(); ++i)
+      delete v[i];
+    v.clear();
+  }
+  pool->field = 0;
+  releaseElementPool(pool);
+}
+
+Element* Field::takeElement(int kind)
+{
+  if ( ! pool)
+    return 0;
+  std::vector<Element*>& v = pool->freeElements[kind];
+  if (v.empty())
+    return 0;
+  Element* e = v.back();
+  v.pop_back();
+  return e;
+}
+
+void Field::adoptElement(Element* e)
+{
+  if ( ! pool) {
+    pool = new ElementPool();
+    pool->field = this;
+    pool->references = 1;
+  }
+  ++pool->references;
+  e->setPool(pool);
+}
+
+void giveElement(int kind, Element* e)
+{
+  ElementPool* p = e->getPool();
+  if (p && p->field && p->freeElements[kind].size() < maxFreeElements)
+    p->freeElements[kind].push_back(e);
+  else
+    delete e;
+}
+
 FieldDataOf<double>* Field::getData()
 {
   return static_cast<FieldDataOf<double>*>(data);
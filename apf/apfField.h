@@ -9,6 +9,7 @@
 #define APFFIELD_H
 
 #include <string>
+#include <vector>
 #include "apfMesh.h"
 
 namespace apf {
@@ -49,18 +50,38 @@ template <class T>
 class FieldDataOf;
 
 class VectorElement;
+class Element;
+struct ElementPool;
 
 class Field : public FieldBase
 {
   public:
+    Field():pool(0) {}
+    virtual ~Field();
     virtual Element* getElement(VectorElement* e) = 0;
     virtual int getValueType() const = 0;
     virtual int getScalarType() {return Mesh::DOUBLE;}
     FieldDataOf<double>* getData();
     virtual void project(Field* from) = 0;
     virtual void axpy(double a, Field* x) = 0;
+    /* destroyed elements are kept for reuse by kind: elements from
+       getElement, elements without a parent, and mesh elements of a
+       coordinate field */
+    enum { ELEMENTS, ENTITY_ELEMENTS, MESH_ELEMENTS, ELEMENT_KINDS };
+    Element* takeElement(int kind);
+    /* lets (e) return to this field's lists when it is destroyed */
+    void adoptElement(Element* e);
+  private:
+    ElementPool* pool;
 };
 
+/* keeps (e) for reuse by the field it was adopted by, or deletes
+   it if that field no longer exists */
+void giveElement(int kind, Element* e);
+/* adopted elements hold a reference to the lists of their field,
+   which outlive the field until the last such element is deleted */
+void releaseElementPool(ElementPool* p);
+
 class FieldOp
 {
   public:
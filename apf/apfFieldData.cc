@@ -3,6 +3,8 @@
 #include "apfShape.h"
 #include <pcu_util.h>
 #include <cstdlib>
+#include <algorithm>
+#include <map>
 
 namespace apf {
 
@@ -173,6 +175,283 @@ void accumulateFieldData(FieldDataOf<double>* data, Sharing* shr)
   synchronizeFieldData(data, shr);
 }
 
+ExchangePeer* Exchange::findPeer(int peer)
+{
+  size_t lo = 0;
+  size_t hi = peers.size();
+  while (lo < hi)
+  {
+    size_t mid = (lo + hi) / 2;
+    if (peers[mid].peer < peer)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+  if (lo < peers.size() && peers[lo].peer == peer)
+    return &peers[lo];
+  return 0;
+}
+
+typedef std::map<int, ExchangePeer> PeerMap;
+
+/* tells the copies and ghosts of the owned entity (e)
+   where its owner lists them */
+static void sendExchange(Mesh* m, Sharing* shr, MeshEntity* e,
+    PeerMap& peers)
+{
+  CopyArray copies;
+  shr->getCopies(e, copies);
+  for (size_t i = 0; i < copies.getSize(); ++i)
+  {
+    int to = copies[i].peer;
+    bool ghost = false;
+    PCU_COMM_PACK(to, copies[i].entity);
+    PCU_COMM_PACK(to, ghost);
+    peers[to].owned.push_back(e);
+  }
+  Copies ghosts;
+  if (m->getGhosts(e, ghosts))
+    APF_ITERATE(Copies, ghosts, git)
+    {
+      int to = git->first;
+      bool ghost = true;
+      PCU_COMM_PACK(to, git->second);
+      PCU_COMM_PACK(to, ghost);
+      peers[to].ghosted.push_back(e);
+    }
+}
+
+static Exchange* receiveExchange(Mesh* m, FieldShape* s, Sharing* shr,
+    PeerMap& peers)
+{
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive())
+  {
+    MeshEntity* e;
+    bool ghost;
+    PCU_COMM_UNPACK(e);
+    PCU_COMM_UNPACK(ghost);
+    ExchangePeer& p = peers[PCU_Comm_Sender()];
+    if (ghost)
+      p.ghosts.push_back(e);
+    else
+      p.copies.push_back(e);
+  }
+  delete shr;
+  Exchange* x = new Exchange();
+  x->mesh = m;
+  x->shape = s;
+  x->peers.reserve(peers.size());
+  APF_ITERATE(PeerMap, peers, it)
+  {
+    x->peers.push_back(it->second);
+    x->peers.back().peer = it->first;
+  }
+  return x;
+}
+
+/* one round of messages tells every copy and ghost where its
+   owner lists it, after which only values need to travel */
+Exchange* makeExchange(Field* f, Sharing* shr)
+{
+  Mesh* m = f->getMesh();
+  FieldShape* s = f->getShape();
+  if (!shr)
+    shr = getSharing(m);
+  PeerMap peers;
+  PCU_Comm_Begin();
+  for (int d = 0; d < 4; ++d)
+  {
+    if ( ! s->hasNodesIn(d))
+      continue;
+    MeshEntity* e;
+    MeshIterator* it = m->begin(d);
+    while ((e = m->iterate(it)))
+      if (s->countNodesOn(m->getType(e)) &&
+          ( ! m->isGhost(e)) && shr->isOwned(e))
+        sendExchange(m, shr, e, peers);
+    m->end(it);
+  }
+  return receiveExchange(m, s, shr, peers);
+}
+
+Exchange* makeExchange(Mesh* m, int dim, Sharing* shr)
+{
+  if (!shr)
+    shr = getSharing(m);
+  PeerMap peers;
+  PCU_Comm_Begin();
+  MeshEntity* e;
+  MeshIterator* it = m->begin(dim);
+  while ((e = m->iterate(it)))
+    if (( ! m->isGhost(e)) && shr->isOwned(e))
+      sendExchange(m, shr, e, peers);
+  m->end(it);
+  return receiveExchange(m, 0, shr, peers);
+}
+
+void destroyExchange(Exchange* x)
+{
+  delete x;
+}
+
+static size_t countValues(FieldBase* f,
+    std::vector<MeshEntity*> const& es)
+{
+  size_t n = 0;
+  for (size_t i = 0; i < es.size(); ++i)
+    n += f->countValuesOn(es[i]);
+  return n;
+}
+
+/* entities without values count as zeros */
+static void getEntityValues(FieldDataOf<double>* data, MeshEntity* e,
+    int n, double* out)
+{
+  if (data->hasEntity(e))
+    data->get(e, out);
+  else
+    for (int i = 0; i < n; ++i)
+      out[i] = 0;
+}
+
+static double* getValues(FieldDataOf<double>* data,
+    std::vector<MeshEntity*> const& es, double* out)
+{
+  FieldBase* f = data->getField();
+  for (size_t i = 0; i < es.size(); ++i)
+  {
+    int n = f->countValuesOn(es[i]);
+    getEntityValues(data, es[i], n, out);
+    out += n;
+  }
+  return out;
+}
+
+static double const* setValues(FieldDataOf<double>* data,
+    std::vector<MeshEntity*> const& es, double const* in)
+{
+  FieldBase* f = data->getField();
+  for (size_t i = 0; i < es.size(); ++i)
+  {
+    data->set(es[i], in);
+    in += f->countValuesOn(es[i]);
+  }
+  return in;
+}
+
+static double const* addValues(FieldDataOf<double>* data,
+    std::vector<MeshEntity*> const& es, double const* in)
+{
+  FieldBase* f = data->getField();
+  std::vector<double> values;
+  for (size_t i = 0; i < es.size(); ++i)
+  {
+    int n = f->countValuesOn(es[i]);
+    values.resize(n);
+    getEntityValues(data, es[i], n, &values[0]);
+    for (int j = 0; j < n; ++j)
+      values[j] += in[j];
+    data->set(es[i], &values[0]);
+    in += n;
+  }
+  return in;
+}
+
+static void checkExchange(FieldBase* f, Exchange* x)
+{
+  PCU_ALWAYS_ASSERT(f->getMesh() == x->mesh);
+  PCU_ALWAYS_ASSERT(f->getShape() == x->shape);
+}
+
+void synchronizeFieldData(FieldDataOf<double>* data, Exchange* x)
+{
+  FieldBase* f = data->getField();
+  checkExchange(f, x);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < x->peers.size(); ++i)
+  {
+    ExchangePeer& p = x->peers[i];
+    size_t n = countValues(f, p.owned) + countValues(f, p.ghosted);
+    if (!n)
+      continue;
+    p.buffer.resize(n);
+    double* out = getValues(data, p.owned, &p.buffer[0]);
+    getValues(data, p.ghosted, out);
+    PCU_Comm_Pack(p.peer, &p.buffer[0], n * sizeof(double));
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Listen())
+  {
+    ExchangePeer* p = x->findPeer(PCU_Comm_Sender());
+    PCU_ALWAYS_ASSERT(p);
+    size_t n = countValues(f, p->copies) + countValues(f, p->ghosts);
+    double const* in = static_cast<double const*>(
+        PCU_Comm_Extract(n * sizeof(double)));
+    in = setValues(data, p->copies, in);
+    setValues(data, p->ghosts, in);
+  }
+}
+
+/* copies (and ghosts if asked) send their values to the owner,
+   which adds them and sends the sums back out. To be
+   deterministic the owner buffers all messages and adds them in
+   peer order rather than in order of arrival. */
+void accumulateFieldData(FieldDataOf<double>* data, Exchange* x,
+    bool ghosts, bool deterministic)
+{
+  FieldBase* f = data->getField();
+  checkExchange(f, x);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < x->peers.size(); ++i)
+  {
+    ExchangePeer& p = x->peers[i];
+    size_t n = countValues(f, p.copies);
+    if (ghosts)
+      n += countValues(f, p.ghosts);
+    if (!n)
+      continue;
+    p.buffer.resize(n);
+    double* out = getValues(data, p.copies, &p.buffer[0]);
+    if (ghosts)
+      getValues(data, p.ghosts, out);
+    PCU_Comm_Pack(p.peer, &p.buffer[0], n * sizeof(double));
+  }
+  PCU_Comm_Send();
+  std::vector<ExchangePeer*> received;
+  while (PCU_Comm_Listen())
+  {
+    ExchangePeer* p = x->findPeer(PCU_Comm_Sender());
+    PCU_ALWAYS_ASSERT(p);
+    size_t n = countValues(f, p->owned);
+    if (ghosts)
+      n += countValues(f, p->ghosted);
+    double const* in = static_cast<double const*>(
+        PCU_Comm_Extract(n * sizeof(double)));
+    if (deterministic)
+    {
+      p->buffer.assign(in, in + n);
+      received.push_back(p);
+      continue;
+    }
+    in = addValues(data, p->owned, in);
+    if (ghosts)
+      addValues(data, p->ghosted, in);
+  }
+  if (deterministic)
+  { /* x->peers is sorted, so are pointers into it */
+    std::sort(received.begin(), received.end());
+    for (size_t i = 0; i < received.size(); ++i)
+    {
+      ExchangePeer* p = received[i];
+      double const* in = addValues(data, p->owned, &p->buffer[0]);
+      if (ghosts)
+        addValues(data, p->ghosted, in);
+    }
+  }
+  synchronizeFieldData(data, x);
+}
+
 template <class T>
 void FieldDataOf<T>::setNodeComponents(MeshEntity* e, int node,
     T const* components)
@@ -9,6 +9,7 @@
 #define APFFIELDDATA_H
 
 #include <string>
+#include <vector>
 #include "apfField.h"
 #include "apfShape.h"
 
@@ -40,6 +41,40 @@ void copyFieldData(FieldDataOf<T>* to, FieldDataOf<T>* from);
 
 void accumulateFieldData(FieldDataOf<double>* data, Sharing* shr);
 
+/* the entities whose values are exchanged with one peer.
+   owned[i] on this part and copies[i] on the peer are the same
+   entity, as are ghosted[i] here and ghosts[i] there. */
+struct ExchangePeer
+{
+  int peer;
+  std::vector<MeshEntity*> owned;
+  std::vector<MeshEntity*> copies;
+  std::vector<MeshEntity*> ghosted;
+  std::vector<MeshEntity*> ghosts;
+  /* message storage kept between calls */
+  std::vector<double> buffer;
+};
+
+struct Exchange
+{
+  Mesh* mesh;
+  /* zero for an exchange of one dimension */
+  FieldShape* shape;
+  /* sorted by peer */
+  std::vector<ExchangePeer> peers;
+  /* zero if nothing is exchanged with (peer) */
+  ExchangePeer* findPeer(int peer);
+};
+
+/* lists all entities of dimension (dim) regardless of nodes,
+   for values other than those of a field such as tags */
+Exchange* makeExchange(Mesh* m, int dim, Sharing* shr = 0);
+
+void synchronizeFieldData(FieldDataOf<double>* data, Exchange* x);
+
+void accumulateFieldData(FieldDataOf<double>* data, Exchange* x,
+    bool ghosts, bool deterministic);
+
 template <class T>
 class FieldDataOf : public FieldData
 {
@@ -110,26 +110,12 @@ double getCofactor(Matrix<M,N> const& A, std::size_t i, std::size_t j)
   return sign * dM;
 }
 
-template <std::size_t M, std::size_t N>
-double getDeterminant(Matrix<M,N> const& A)
-{
-  double d = 0;
-  for (std::size_t i = 0; i < M; ++i)
-    d += A[i][0] * getCofactor(A, i, 0);
-  return d;
-}
-
-double getDeterminant(Matrix<1,1> const& A)
-{
-  return A[0][0];
-}
-
 template Matrix<1,1> getMinor(Matrix<2,2> const& A, std::size_t i, std::size_t j);
 template Matrix<2,2> getMinor(Matrix<3,3> const& A, std::size_t i, std::size_t j);
 template Matrix<3,3> getMinor(Matrix<4,4> const& A, std::size_t i, std::size_t j);
 
-template double getDeterminant(Matrix<2,2> const& A);
-template double getDeterminant(Matrix<3,3> const& A);
-template double getDeterminant(Matrix<4,4> const& A);
+template double getCofactor(Matrix<2,2> const& A, std::size_t i, std::size_t j);
+template double getCofactor(Matrix<3,3> const& A, std::size_t i, std::size_t j);
+template double getCofactor(Matrix<4,4> const& A, std::size_t i, std::size_t j);
 
 }
@@ -138,10 +138,62 @@ template <std::size_t M, std::size_t N>
 double getCofactor(Matrix<M,N> const& A, std::size_t i, std::size_t j);
 
 /** \brief get the determinant of a matrix A
- \details this is only instantiated for square matrices up to 4 by 4 */
+ \details this is only defined for square matrices up to 4 by 4,
+ which are specialized below with closed forms */
 template <std::size_t M, std::size_t N>
 double getDeterminant(Matrix<M,N> const& A);
 
+/** \brief determinant of a 1 by 1 matrix */
+template <>
+inline double getDeterminant(Matrix<1,1> const& A)
+{
+  return A[0][0];
+}
+
+/** \brief determinant of a 2 by 2 matrix */
+template <>
+inline double getDeterminant(Matrix<2,2> const& A)
+{
+  return A[0][0]*A[1][1] - A[0][1]*A[1][0];
+}
+
+/** \brief determinant of a 3 by 3 matrix, as a triple product */
+template <>
+inline double getDeterminant(Matrix<3,3> const& A)
+{
+  return A[0] * cross(A[1],A[2]);
+}
+
+/** \brief the 2 by 2 minors of a 4 by 4 matrix
+  \details (s) come from the first two rows and (c) from the last
+  two, both ordered by columns 01, 02, 03, 12, 13, 23 */
+inline void getPairMinors(Matrix<4,4> const& A, double* s, double* c)
+{
+  s[0] = A[0][0]*A[1][1] - A[1][0]*A[0][1];
+  s[1] = A[0][0]*A[1][2] - A[1][0]*A[0][2];
+  s[2] = A[0][0]*A[1][3] - A[1][0]*A[0][3];
+  s[3] = A[0][1]*A[1][2] - A[1][1]*A[0][2];
+  s[4] = A[0][1]*A[1][3] - A[1][1]*A[0][3];
+  s[5] = A[0][2]*A[1][3] - A[1][2]*A[0][3];
+  c[0] = A[2][0]*A[3][1] - A[3][0]*A[2][1];
+  c[1] = A[2][0]*A[3][2] - A[3][0]*A[2][2];
+  c[2] = A[2][0]*A[3][3] - A[3][0]*A[2][3];
+  c[3] = A[2][1]*A[3][2] - A[3][1]*A[2][2];
+  c[4] = A[2][1]*A[3][3] - A[3][1]*A[2][3];
+  c[5] = A[2][2]*A[3][3] - A[3][2]*A[2][3];
+}
+
+/** \brief determinant of a 4 by 4 matrix
+  \details by the Laplace expansion over the first two rows */
+template <>
+inline double getDeterminant(Matrix<4,4> const& A)
+{
+  double s[6], c[6];
+  getPairMinors(A, s, c);
+  return s[0]*c[5] - s[1]*c[4] + s[2]*c[3]
+       + s[3]*c[2] - s[4]*c[1] + s[5]*c[0];
+}
+
 /** \brief get the matrix of cofactors for a given matrix */
 inline Matrix<3,3> cofactor(Matrix<3,3> const &m)
 {
@@ -161,7 +213,8 @@ inline Matrix<2,2> invert(Matrix<2,2> const& m)
   return a / getDeterminant(m);
 }
 
-/** \brief invert a 3 by 3 matrix */
+/** \brief invert a 3 by 3 matrix
+  \details the first row of the adjugate gives the determinant */
 inline Matrix<3,3> invert(Matrix<3,3> const& m)
 {
   Matrix<3,3> x = transpose(m);
@@ -169,7 +222,63 @@ inline Matrix<3,3> invert(Matrix<3,3> const& m)
   r[0] = cross(x[1],x[2]);
   r[1] = cross(x[2],x[0]);
   r[2] = cross(x[0],x[1]);
-  return r / getDeterminant(m);
+  return r / (x[0] * r[0]);
+}
+
+/** \brief invert a 4 by 4 matrix
+  \details the adjugate is built from the same 2 by 2 minors
+  as the determinant */
+inline Matrix<4,4> invert(Matrix<4,4> const& m)
+{
+  double s[6], c[6];
+  getPairMinors(m, s, c);
+  double det = s[0]*c[5] - s[1]*c[4] + s[2]*c[3]
+             + s[3]*c[2] - s[4]*c[1] + s[5]*c[0];
+  Matrix<4,4> r;
+  r[0][0] =  m[1][1]*c[5] - m[1][2]*c[4] + m[1][3]*c[3];
+  r[0][1] = -m[0][1]*c[5] + m[0][2]*c[4] - m[0][3]*c[3];
+  r[0][2] =  m[3][1]*s[5] - m[3][2]*s[4] + m[3][3]*s[3];
+  r[0][3] = -m[2][1]*s[5] + m[2][2]*s[4] - m[2][3]*s[3];
+  r[1][0] = -m[1][0]*c[5] + m[1][2]*c[2] - m[1][3]*c[1];
+  r[1][1] =  m[0][0]*c[5] - m[0][2]*c[2] + m[0][3]*c[1];
+  r[1][2] = -m[3][0]*s[5] + m[3][2]*s[2] - m[3][3]*s[1];
+  r[1][3] =  m[2][0]*s[5] - m[2][2]*s[2] + m[2][3]*s[1];
+  r[2][0] =  m[1][0]*c[4] - m[1][1]*c[2] + m[1][3]*c[0];
+  r[2][1] = -m[0][0]*c[4] + m[0][1]*c[2] - m[0][3]*c[0];
+  r[2][2] =  m[3][0]*s[4] - m[3][1]*s[2] + m[3][3]*s[0];
+  r[2][3] = -m[2][0]*s[4] + m[2][1]*s[2] - m[2][3]*s[0];
+  r[3][0] = -m[1][0]*c[3] + m[1][1]*c[1] - m[1][2]*c[0];
+  r[3][1] =  m[0][0]*c[3] - m[0][1]*c[1] + m[0][2]*c[0];
+  r[3][2] = -m[3][0]*s[3] + m[3][1]*s[1] - m[3][2]*s[0];
+  r[3][3] =  m[2][0]*s[3] - m[2][1]*s[1] + m[2][2]*s[0];
+  return r / det;
+}
+
+/** \brief get the determinants of (n) square matrices
+  \details the loop body is a closed form without branches or
+  calls, so compilers can vectorize it across the matrices */
+template <std::size_t N>
+void getDeterminants(std::size_t n, Matrix<N,N> const* A, double* d)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    d[i] = getDeterminant(A[i]);
+}
+
+/** \brief invert (n) square matrices of size 2, 3 or 4 */
+template <std::size_t N>
+void invert(std::size_t n, Matrix<N,N> const* A, Matrix<N,N>* inverses)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    inverses[i] = invert(A[i]);
+}
+
+/** \brief multiply (n) pairs of matrices, c[i] = a[i] * b[i] */
+template <std::size_t M, std::size_t N, std::size_t O>
+void multiply(std::size_t n, Matrix<M,N> const* a, Matrix<N,O> const* b,
+    Matrix<M,O>* c)
+{
+  for (std::size_t i = 0; i < n; ++i)
+    c[i] = a[i] * b[i];
 }
 
 /** \brief convenience wrapper over apf::Matrix<3,3>
@@ -180,6 +180,21 @@ void Mesh::snapToModel(ModelEntity* m, Vector3 const& p, Vector3& x)
   gmi_eval(getModel(), (gmi_ent*)m, &p[0], &x[0]);
 }
 
+void Mesh::snapToModel(ModelEntity* m, int n, Vector3 const* p, Vector3* x)
+{
+  if (!n)
+    return;
+  std::vector<double> params(n * 2);
+  std::vector<double> points(n * 3);
+  for (int i = 0; i < n; ++i) {
+    params[i * 2 + 0] = p[i][0];
+    params[i * 2 + 1] = p[i][1];
+  }
+  gmi_eval_batch(getModel(), (gmi_ent*)m, n, &params[0], &points[0]);
+  for (int i = 0; i < n; ++i)
+    x[i] = Vector3(&points[i * 3]);
+}
+
 void Mesh::getParamOn(ModelEntity* g, MeshEntity* e, Vector3& p)
 {
   ModelEntity* from_g = toModel(e);
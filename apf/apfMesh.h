@@ -285,6 +285,9 @@ class Mesh
     bool canSnap();
     /** \brief evaluate parametric coordinate (p) as a spatial point (x) */
     void snapToModel(ModelEntity* m, Vector3 const& p, Vector3& x);
+    /** \brief evaluate (n) parametric coordinates on one model entity
+      \details uses gmi_eval_batch, so models can amortize the queries */
+    void snapToModel(ModelEntity* m, int n, Vector3 const* p, Vector3* x);
     /** \brief reparameterize mesh vertex (e) onto model entity (g) */
     void getParamOn(ModelEntity* g, MeshEntity* e, Vector3& p);
     /** \brief get the periodic properties of a model entity
@@ -338,6 +341,16 @@ class Mesh
       \returns an estimate of how many bytes are needed
       to store an entity of (type) */
     virtual double getElementBytes(int) {return 1.0;}
+    /** \brief get the array index of an entity among those of its type
+      \details meshes that store each entity type in an array, such as
+      MDS, return indices below countTypeIndices(getType(e)) that stay
+      fixed until the mesh is modified. Other meshes return -1.
+      This lets per-entity data be found by arithmetic alone. */
+    virtual int getTypeIndex(MeshEntity*) {return -1;}
+    /** \brief the bound on getTypeIndex for entities of (type)
+      \details this may exceed count(type) when entities
+      have been destroyed */
+    virtual int countTypeIndices(int) {return 0;}
     /** \brief associate a field with this mesh
       \details most users don't need this, functions in apf.h
                automatically call it */
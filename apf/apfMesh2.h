@@ -136,6 +136,30 @@ void migrateSilent(Mesh2* m, Migration* plan);
   be performed as several consecutive migrations. */
 void setMigrationLimit(size_t maxElements);
 
+/** \brief observes the entities changed by apf::migrate
+  \details before() is called for every local entity whose existence,
+  residence, or remote copies the migration may change, while it is still
+  unchanged.  after() is called once the migration is done for each of
+  those entities that still exists and for every entity this part
+  received.  Together they let callers update per-part data from the
+  entities that actually moved instead of the whole part. */
+class MigrationObserver
+{
+  public:
+    virtual ~MigrationObserver() {}
+    virtual void before(Mesh2* m, MeshEntity* e) = 0;
+    virtual void after(Mesh2* m, MeshEntity* e) = 0;
+};
+
+/** \brief set the observer of subsequent migrations on this process
+  \details there is one observer per process. an observer that is set
+  while another one is active should forward the calls it receives to
+  the previous one and restore it when done, so nested users are not
+  silently cut off.
+  \param o the new observer, or zero to remove it
+  \returns the observer that was set before */
+MigrationObserver* setMigrationObserver(MigrationObserver* o);
+
 class Field;
 
 /** \brief add a field (times a factor) to the mesh coordinates
@@ -206,7 +230,8 @@ void packParts(int to, Parts& parts);
 void unpackParts(Parts& parts);
 void moveEntities(
     Mesh2* m,
-    EntityVector senders[4]);
+    EntityVector senders[4],
+    EntityVector* received = 0);
 void updateMatching(
     Mesh2* m,
     EntityVector affected[4],
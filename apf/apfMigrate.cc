@@ -674,7 +674,8 @@ static void setupRemotes(
 
 void moveEntities(
     Mesh2* m,
-    EntityVector senders[4])
+    EntityVector senders[4],
+    EntityVector* received)
 {
   DynamicArray<MeshTag*> tags;
   m->getTags(tags);
@@ -684,9 +685,12 @@ void moveEntities(
     PCU_Comm_Begin();
     sendEntities(m,senders[dimension],tags);
     PCU_Comm_Send();
-    EntityVector received;
-    receiveEntities(m,tags,received);
-    setupRemotes(m,received,senders[dimension]);
+    EntityVector newEntities;
+    receiveEntities(m,tags,newEntities);
+    setupRemotes(m,newEntities,senders[dimension]);
+    if (received)
+      received->insert(received->end(),
+          newEntities.begin(), newEntities.end());
   }
 }
 
@@ -836,20 +840,71 @@ void deleteOldEntities(
     }
 }
 
+static MigrationObserver* migrationObserver = 0;
+
+MigrationObserver* setMigrationObserver(MigrationObserver* o)
+{
+  MigrationObserver* previous = migrationObserver;
+  migrationObserver = o;
+  return previous;
+}
+
+static void observeBefore(Mesh2* m, EntityVector affected[4])
+{
+  for (int d=0; d < 4; ++d)
+    APF_ITERATE(EntityVector,affected[d],it)
+      migrationObserver->before(m,*it);
+}
+
+/* the affected entities that remain on this part,
+   gathered before deleteOldEntities destroys the rest */
+static void getRemaining(
+    Mesh2* m,
+    EntityVector affected[4],
+    EntityVector& remaining)
+{
+  int rank = PCU_Comm_Self();
+  for (int d=0; d < 4; ++d)
+    APF_ITERATE(EntityVector,affected[d],it)
+    {
+      Parts residence;
+      m->getResidence(*it,residence);
+      if (residence.count(rank))
+        remaining.push_back(*it);
+    }
+}
+
+static void observeAfter(Mesh2* m, EntityVector& remaining,
+    EntityVector& received)
+{
+  APF_ITERATE(EntityVector,remaining,it)
+    migrationObserver->after(m,*it);
+  APF_ITERATE(EntityVector,received,it)
+    migrationObserver->after(m,*it);
+}
+
 /* this is the main migration routine */
 static void migrate1(Mesh2* m, Migration* plan)
 {
   EntityVector affected[4];
   getAffected(m,plan,affected);
+  if (migrationObserver)
+    observeBefore(m,affected);
   EntityVector senders[4];
   getSenders(m,affected,senders);
   reduceMatchingToSenders(m,senders);
   updateResidences(m,plan,affected);
   delete plan;
-  moveEntities(m,senders);
+  EntityVector received;
+  moveEntities(m,senders,migrationObserver ? &received : 0);
   updateMatching(m,affected,senders);
+  EntityVector remaining;
+  if (migrationObserver)
+    getRemaining(m,affected,remaining);
   deleteOldEntities(m,affected);
   m->acceptChanges();
+  if (migrationObserver)
+    observeAfter(m,remaining,received);
 }
 
 const size_t maxMigrationLimit = 10*1000*1000;
@@ -13,6 +13,7 @@
 #include "apfShape.h"
 #include "apfTagData.h"
 #include <pcu_util.h>
+#include <algorithm>
 
 namespace apf {
 
@@ -574,6 +575,242 @@ void synchronize(GlobalNumbering* n, Sharing* shr)
   synchronizeFieldData<long>(n->getData(), shr);
 }
 
+NodeNumberings::NodeNumberings():
+  owned(0),
+  overlap(0),
+  global(0),
+  ownedCount(0),
+  overlapCount(0),
+  globalStart(0),
+  globalCount(0)
+{
+}
+
+/* the graph connecting the first (n) nodes of (overlap) when they
+   share an element, in compressed rows with sorted neighbors */
+struct NodeGraph
+{
+  NodeGraph(Mesh* m, Numbering* overlap, int n)
+  {
+    std::vector<std::pair<int,int> > pairs;
+    NewArray<int> nodes;
+    MeshIterator* it = m->begin(m->getDimension());
+    MeshEntity* e;
+    while ((e = m->iterate(it)))
+    {
+      int nn = getElementNumbers(overlap, e, nodes);
+      for (int i = 0; i < nn; ++i)
+        if (nodes[i] < n)
+          for (int j = 0; j < nn; ++j)
+            if (j != i && nodes[j] < n)
+              pairs.push_back(std::make_pair(nodes[i], nodes[j]));
+    }
+    m->end(it);
+    std::sort(pairs.begin(), pairs.end());
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    offsets.assign(n + 1, 0);
+    for (size_t i = 0; i < pairs.size(); ++i)
+      ++offsets[pairs[i].first + 1];
+    for (int i = 0; i < n; ++i)
+      offsets[i + 1] += offsets[i];
+    adjacency.resize(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i)
+      adjacency[i] = pairs[i].second;
+  }
+  int count() const {return static_cast<int>(offsets.size()) - 1;}
+  int degree(int v) const {return offsets[v + 1] - offsets[v];}
+  std::vector<int> offsets;
+  std::vector<int> adjacency;
+};
+
+struct ByDegree
+{
+  ByDegree(NodeGraph const& graph):g(graph) {}
+  bool operator()(int a, int b) const
+  {
+    return g.degree(a) < g.degree(b);
+  }
+  NodeGraph const& g;
+};
+
+/* Cuthill-McKee breadth first search from (root), marking the nodes
+   it reaches with (stamp) and appending them to (order) level by
+   level, neighbors by increasing degree. Returns the number of
+   levels and sets (last) to where the last level starts. */
+static int search(NodeGraph const& g, int root, int stamp,
+    std::vector<int>& mark, std::vector<int>& order, size_t& last)
+{
+  mark[root] = stamp;
+  order.push_back(root);
+  int levels = 0;
+  size_t level = order.size() - 1;
+  while (level < order.size())
+  {
+    size_t end = order.size();
+    last = level;
+    ++levels;
+    for (size_t i = level; i < end; ++i)
+    {
+      int v = order[i];
+      size_t first = order.size();
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+      {
+        int u = g.adjacency[j];
+        if (mark[u] != stamp)
+        {
+          mark[u] = stamp;
+          order.push_back(u);
+        }
+      }
+      std::stable_sort(order.begin() + first, order.end(), ByDegree(g));
+    }
+    level = end;
+  }
+  return levels;
+}
+
+/* starts each connected component at a pseudo-peripheral node found
+   as by George and Liu, then reverses the Cuthill-McKee order.
+   (number) maps each node to its new number */
+static void reverseCuthillMcKee(NodeGraph const& g,
+    std::vector<int>& number)
+{
+  int n = g.count();
+  std::vector<int> order;
+  order.reserve(n);
+  std::vector<int> mark(n, -1);
+  std::vector<int> scratch;
+  int stamp = 0;
+  for (int start = 0; start < n; ++start)
+  {
+    if (mark[start] != -1)
+      continue;
+    int root = start;
+    size_t last;
+    scratch.clear();
+    int levels = search(g, root, ++stamp, mark, scratch, last);
+    while (true)
+    {
+      int best = scratch[last];
+      for (size_t i = last; i < scratch.size(); ++i)
+        if (g.degree(scratch[i]) < g.degree(best))
+          best = scratch[i];
+      scratch.clear();
+      int bestLevels = search(g, best, ++stamp, mark, scratch, last);
+      if (bestLevels <= levels)
+        break;
+      root = best;
+      levels = bestLevels;
+    }
+    search(g, root, ++stamp, mark, order, last);
+  }
+  PCU_ALWAYS_ASSERT(static_cast<int>(order.size()) == n);
+  number.resize(n);
+  for (int i = 0; i < n; ++i)
+    number[order[i]] = n - 1 - i;
+}
+
+/* gives the nodes of (entities) consecutive numbers from (next) */
+static void numberConsecutive(Numbering* n,
+    std::vector<MeshEntity*> const& entities, int& next)
+{
+  FieldDataOf<int>* data = n->getData();
+  std::vector<int> nodes;
+  for (size_t i = 0; i < entities.size(); ++i)
+  {
+    nodes.resize(n->countNodesOn(entities[i]));
+    for (size_t j = 0; j < nodes.size(); ++j)
+      nodes[j] = next++;
+    data->set(entities[i], &nodes[0]);
+  }
+}
+
+void numberAllNodes(
+    Mesh* mesh,
+    const char* name,
+    NodeNumberings& out,
+    int order,
+    FieldShape* s,
+    Sharing* shr)
+{
+  if (!s)
+    s = mesh->getShape();
+  if (!shr)
+    shr = getSharing(mesh);
+  std::string prefix = name;
+  out.owned = createNumbering(mesh, (prefix + "_owned").c_str(), s, 1);
+  out.overlap = createNumbering(mesh, (prefix + "_overlap").c_str(), s, 1);
+  out.global = createGlobalNumbering(mesh,
+      (prefix + "_global").c_str(), s);
+  std::vector<MeshEntity*> owned;
+  std::vector<MeshEntity*> others;
+  for (int d = 0; d < 4; ++d)
+  {
+    if ( ! s->hasNodesIn(d))
+      continue;
+    MeshIterator* it = mesh->begin(d);
+    MeshEntity* e;
+    while ((e = mesh->iterate(it)))
+    {
+      if ( ! s->countNodesOn(mesh->getType(e)))
+        continue;
+      if (shr->isOwned(e))
+        owned.push_back(e);
+      else
+        others.push_back(e);
+    }
+    mesh->end(it);
+  }
+  int next = 0;
+  numberConsecutive(out.overlap, owned, next);
+  out.ownedCount = next;
+  numberConsecutive(out.overlap, others, next);
+  out.overlapCount = next;
+  FieldDataOf<int>* overlapData = out.overlap->getData();
+  std::vector<int> renumber;
+  if (order == RCM_ORDER)
+  {
+    NodeGraph graph(mesh, out.overlap, out.ownedCount);
+    reverseCuthillMcKee(graph, renumber);
+  }
+  out.globalStart = PCU_Exscan_Long(out.ownedCount);
+  out.globalCount = PCU_Add_Long(out.ownedCount);
+  FieldDataOf<int>* ownedData = out.owned->getData();
+  FieldDataOf<long>* globalData = out.global->getData();
+  std::vector<int> nodes;
+  std::vector<long> globals;
+  for (size_t i = 0; i < owned.size(); ++i)
+  {
+    MeshEntity* e = owned[i];
+    nodes.resize(out.overlap->countNodesOn(e));
+    globals.resize(nodes.size());
+    overlapData->get(e, &nodes[0]);
+    for (size_t j = 0; j < nodes.size(); ++j)
+    {
+      if ( ! renumber.empty())
+        nodes[j] = renumber[nodes[j]];
+      globals[j] = out.globalStart + nodes[j];
+    }
+    if ( ! renumber.empty())
+      overlapData->set(e, &nodes[0]);
+    ownedData->set(e, &nodes[0]);
+    globalData->set(e, &globals[0]);
+  }
+  /* this deletes (shr), as numberOwnedNodes does */
+  synchronize(out.global, shr);
+}
+
+void destroyNodeNumberings(NodeNumberings& n)
+{
+  if (n.owned)
+    destroyNumbering(n.owned);
+  if (n.overlap)
+    destroyNumbering(n.overlap);
+  if (n.global)
+    destroyGlobalNumbering(n.global);
+  n = NodeNumberings();
+}
+
 void destroyGlobalNumbering(GlobalNumbering* n)
 {
   n->getMesh()->removeGlobalNumbering(n);
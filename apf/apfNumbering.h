@@ -14,6 +14,7 @@
 #include "apf.h"
 #include "apfDynamicArray.h"
 #include "apfMesh.h"
+#include <vector>
 
 namespace apf {
 
@@ -204,6 +205,93 @@ void destroyGlobalNumbering(GlobalNumbering* n);
 /** \brief see the Numbering equivalent */
 void getNodes(GlobalNumbering* n, DynamicArray<Node>& nodes);
 
+/** \brief Orderings of owned nodes for apf::numberAllNodes */
+enum NodeOrder {
+  /** \brief mesh iteration order, as apf::numberOwnedNodes */
+  ITERATION_ORDER,
+  /** \brief reverse Cuthill-McKee order of the graph connecting
+      nodes of the same element, which reduces matrix bandwidth */
+  RCM_ORDER
+};
+
+/** \brief The numberings made by apf::numberAllNodes */
+struct NodeNumberings
+{
+  NodeNumberings();
+  /** \brief local numbers of the owned nodes */
+  Numbering* owned;
+  /** \brief local numbers of all nodes: the owned nodes keep
+      their owned numbers and the others follow them */
+  Numbering* overlap;
+  /** \brief global numbers of all nodes, synchronized */
+  GlobalNumbering* global;
+  /** \brief the number of owned nodes on this part */
+  int ownedCount;
+  /** \brief the number of nodes on this part */
+  int overlapCount;
+  /** \brief the global number of the first owned node */
+  long globalStart;
+  /** \brief the number of nodes over all parts */
+  long globalCount;
+};
+
+/** \brief make the owned, overlap and global node numberings at once
+  \details the nodes are visited in one pass over the mesh and the
+  global offsets come from a single prefix scan. The numberings are
+  named (name) with the suffixes _owned, _overlap and _global.
+  \param order select from apf::NodeOrder
+  \param s if non-zero, use nodes from this FieldShape, otherwise
+           use the mesh's coordinate nodes
+  \param shr if non-zero, use this Sharing to determine ownership,
+             otherwise call apf::getSharing */
+void numberAllNodes(
+    Mesh* mesh,
+    const char* name,
+    NodeNumberings& out,
+    int order = ITERATION_ORDER,
+    FieldShape* s = 0,
+    Sharing* shr = 0);
+
+/** \brief destroy the numberings made by apf::numberAllNodes */
+void destroyNodeNumberings(NodeNumberings& n);
+
+/** \brief Compressed row nonzero structure of a matrix
+  \details rows and columns are the numbers of nodal components,
+  two of which are coupled when they share an element. */
+struct Sparsity
+{
+  /** \brief the rows of this part, sorted */
+  std::vector<long> rows;
+  /** \brief the columns of row (i) are in
+      [offsets[i], offsets[i + 1]) */
+  std::vector<int> offsets;
+  /** \brief the columns of each row, sorted */
+  std::vector<long> columns;
+  /** \brief per row, the number of columns that are rows of this
+      part, as for the diagonal block of a parallel matrix */
+  std::vector<int> diagonalCounts;
+  /** \brief per row, the number of other columns */
+  std::vector<int> offDiagonalCounts;
+  /** \brief the index of (row) in apf::Sparsity::rows, or -1 */
+  int findRow(long row) const;
+};
+
+/** \brief get the local nonzero structure of a Numbering
+  \details every numbered component is a row, coupled to the
+  components sharing an element of dimension (dim) on this part.
+  Fixed and unnumbered components are left out. */
+void getSparsity(Numbering* n, int dim, Sparsity& out);
+
+/** \brief get the nonzero structure of the rows owned by this part
+  \details the rows are the components on owned entities. Couplings
+  made by elements of other parts are sent to the owners, so the
+  rows are complete. The non-owned nodes must be numbered, as after
+  apf::synchronize or apf::numberAllNodes.
+  \param shr if non-zero, use this Sharing to determine ownership,
+             otherwise call apf::getSharing */
+void getSparsity(GlobalNumbering* n, int dim, Sparsity& out,
+    Sharing* shr = 0);
+
 /** \brief Number by adjacency graph traversal
   \details a plain single-integer tag is used to
   number the vertices and elements of a mesh */
@@ -1,6 +1,10 @@
 #include "apfPartition.h"
 #include "apfMesh2.h"
 #include "apf.h"
+#include <PCU.h>
+#include <algorithm>
+#include <map>
+#include <vector>
 
 namespace apf {
 
@@ -68,4 +72,124 @@ void remapPartition(apf::Mesh2* m, Remap& remap)
   m->acceptChanges();
 }
 
+struct Overlap
+{
+  double weight;
+  int from;
+  int to;
+};
+
+static bool operator<(Overlap const& a, Overlap const& b)
+{
+  if (a.weight != b.weight)
+    return a.weight > b.weight;
+  if (a.from != b.from)
+    return a.from < b.from;
+  return a.to < b.to;
+}
+
+/* the weight this part keeps under each planned part id */
+static void getOverlap(Migration* plan, MeshTag* weights,
+    std::vector<int>& dest, std::map<int, double>& row)
+{
+  Mesh* m = plan->getMesh();
+  int self = m->getId();
+  MeshIterator* it = m->begin(m->getDimension());
+  MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int to = plan->has(e) ? plan->sending(e) : self;
+    double w = 1;
+    if (weights)
+      m->getDoubleTag(e, weights, &w);
+    row[to] += w;
+    dest.push_back(to);
+  }
+  m->end(it);
+}
+
+/* greedy maximum weight matching of planned part ids to current parts.
+   the heaviest remaining overlap is matched first, which keeps at least
+   half of the best possible weight in place, and the identity is kept
+   if it does better. returns the new part id of each planned part id */
+static void matchParts(std::vector<Overlap>& overlaps, int peers,
+    std::vector<int>& perm)
+{
+  std::sort(overlaps.begin(), overlaps.end());
+  perm.assign(peers, -1);
+  std::vector<bool> taken(peers, false);
+  double kept = 0;
+  double identity = 0;
+  for (size_t i = 0; i < overlaps.size(); ++i) {
+    Overlap& o = overlaps[i];
+    if (o.from == o.to)
+      identity += o.weight;
+    if (perm[o.to] != -1 || taken[o.from])
+      continue;
+    perm[o.to] = o.from;
+    taken[o.from] = true;
+    kept += o.weight;
+  }
+  if (kept <= identity) {
+    for (int i = 0; i < peers; ++i)
+      perm[i] = i;
+    return;
+  }
+  for (int i = 0; i < peers; ++i)
+    if (perm[i] == -1 && !taken[i]) {
+      perm[i] = i;
+      taken[i] = true;
+    }
+  int next = 0;
+  for (int i = 0; i < peers; ++i)
+    if (perm[i] == -1) {
+      while (taken[next])
+        ++next;
+      perm[i] = next;
+      taken[next] = true;
+    }
+}
+
+Migration* remapMigration(Migration* plan, MeshTag* weights)
+{
+  Mesh* m = plan->getMesh();
+  int self = m->getId();
+  int peers = PCU_Comm_Peers();
+  std::vector<int> dest;
+  std::map<int, double> row;
+  getOverlap(plan, weights, dest, row);
+  delete plan;
+  /* only the nonzero overlaps travel to the first rank */
+  PCU_Comm_Begin();
+  for (std::map<int, double>::iterator it = row.begin();
+       it != row.end(); ++it) {
+    Overlap o;
+    o.weight = it->second;
+    o.from = self;
+    o.to = it->first;
+    PCU_COMM_PACK(0, o);
+  }
+  PCU_Comm_Send();
+  std::vector<Overlap> overlaps;
+  while (PCU_Comm_Receive()) {
+    Overlap o;
+    PCU_COMM_UNPACK(o);
+    overlaps.push_back(o);
+  }
+  std::vector<int> perm(peers, 0);
+  if (!PCU_Comm_Self())
+    matchParts(overlaps, peers, perm);
+  PCU_Add_Ints(&perm[0], peers);
+  plan = new Migration(m);
+  MeshIterator* it = m->begin(m->getDimension());
+  MeshEntity* e;
+  size_t i = 0;
+  while ((e = m->iterate(it))) {
+    int to = perm[dest[i++]];
+    if (to != self)
+      plan->send(e, to);
+  }
+  m->end(it);
+  return plan;
+}
+
 }
@@ -175,6 +175,22 @@ private:
            interface */
 void remapPartition(apf::Mesh2* m, Remap& remap);
 
+/** \brief relabel a balancing plan so that less weight migrates
+  \details global repartitioners produce part ids that are only labels,
+           and using them as-is can move most elements even when a
+           permutation of the labels would keep most of them in place.
+           This function builds the overlap of element weight between the
+           current parts and the planned parts, chooses a permutation of
+           the planned part ids that keeps a large overlap in place, and
+           returns the relabeled plan.
+           The plan must send elements to part ids in [0, peers).
+           This is a collective call.
+  \param plan the plan of a Balancer, it is deleted
+  \param weights the element weight tag of one double, or zero for unit
+                 weights
+  \returns the relabeled plan */
+Migration* remapMigration(Migration* plan, MeshTag* weights = 0);
+
 }
 
 #endif
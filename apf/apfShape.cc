@@ -39,6 +39,11 @@ void FieldShape::getNodeXi(int, int, Vector3&)
   fail("unimplemented getNodeXi called");
 }
 
+bool FieldShape::canTabulate()
+{
+  return false;
+}
+
 void FieldShape::registerSelf(const char* name_)
 {
   std::string name = name_;
@@ -347,6 +352,7 @@ class Linear : public FieldShape
         return 0;
     }
     int getOrder() {return 1;}
+    bool canTabulate() {return true;}
     void getNodeXi(int, int, Vector3& xi)
     {
       xi = Vector3(0,0,0);
@@ -465,6 +471,7 @@ class QuadraticBase : public FieldShape
       return shapes[type];
     }
     int getOrder() {return 2;}
+    bool canTabulate() {return true;}
     void getNodeXi(int, int, Vector3& xi)
     {
       /* for vertex nodes, mid-edge nodes,
@@ -864,6 +871,7 @@ class LagrangeCubic : public FieldShape
         return 0;
     }
     int getOrder() {return 3;}
+    bool canTabulate() {return true;}
     void getNodeXi(int type, int node, Vector3& xi)
     {
       PCU_ALWAYS_ASSERT(node < 2);
@@ -959,6 +967,7 @@ class Constant : public FieldShape
         return 0;
    }
     int getOrder() {return 0;}
+    bool canTabulate() {return true;}
   private:
     std::string name;
 };
@@ -96,6 +96,11 @@ class FieldShape
     virtual void getNodeXi(int type, int node, Vector3& xi);
 /** \brief Get a unique string for this shape function scheme */
     virtual const char* getName() const = 0;
+/** \brief Return true iff the shape functions depend only on the
+           parent element coordinates
+  \details then their values at integration points are computed once
+           and shared by all elements */
+    virtual bool canTabulate();
     void registerSelf(const char* name);
 };
 
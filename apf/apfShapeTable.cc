@@ -0,0 +1,71 @@
+/*
+ * Copyright 2011 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "apfShapeTable.h"
+#include "apfShape.h"
+#include "apfIntegrate.h"
+#include <map>
+
+namespace apf {
+
+ShapeTable::ShapeTable(EntityShape* s, Integration const* in)
+{
+  nodes = s->countNodes();
+  int np = in->countPoints();
+  values.allocate(np * nodes);
+  grads.allocate(np * nodes);
+  NewArray<double> v;
+  NewArray<Vector3> g;
+  for (int p = 0; p < np; ++p) {
+    Vector3 const& xi = in->getPoint(p)->param;
+    s->getValues(0, 0, xi, v);
+    s->getLocalGradients(0, 0, xi, g);
+    for (int i = 0; i < nodes; ++i) {
+      values[p * nodes + i] = v[i];
+      grads[p * nodes + i] = g[i];
+    }
+  }
+}
+
+/* tables live as long as the shape and integration singletons */
+class ShapeTables
+{
+  public:
+    ~ShapeTables()
+    {
+      for (Map::iterator it = tables.begin(); it != tables.end(); ++it)
+        delete it->second;
+    }
+    ShapeTable const* get(EntityShape* s, Integration const* in)
+    {
+      Key key(s, in);
+      Map::iterator it = tables.find(key);
+      if (it != tables.end())
+        return it->second;
+      ShapeTable* table = new ShapeTable(s, in);
+      tables[key] = table;
+      return table;
+    }
+  private:
+    typedef std::pair<EntityShape*, Integration const*> Key;
+    typedef std::map<Key, ShapeTable*> Map;
+    Map tables;
+};
+
+ShapeTable const* getShapeTable(FieldShape* s, int type,
+    Integration const* in)
+{
+  static ShapeTables tables;
+  if (!s->canTabulate())
+    return 0;
+  EntityShape* es = s->getEntityShape(type);
+  if (!es)
+    return 0;
+  return tables.get(es, in);
+}
+
+}
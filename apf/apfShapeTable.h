@@ -0,0 +1,49 @@
+/*
+ * Copyright 2011 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APFSHAPETABLE_H
+#define APFSHAPETABLE_H
+
+#include "apfNew.h"
+#include "apfVector.h"
+
+namespace apf {
+
+class FieldShape;
+class EntityShape;
+class Integration;
+
+/* shape function values and local gradients of one element type
+   at every point of one integration rule, stored point by point */
+class ShapeTable
+{
+  public:
+    ShapeTable(EntityShape* s, Integration const* in);
+    int countNodes() const {return nodes;}
+    double const* getValues(int point) const
+    {
+      return &values[point * nodes];
+    }
+    Vector3 const* getLocalGradients(int point) const
+    {
+      return &grads[point * nodes];
+    }
+  private:
+    int nodes;
+    NewArray<double> values;
+    NewArray<Vector3> grads;
+};
+
+/* returns the table of shape (s) over elements of (type) for rule (in),
+   building it on first use. returns zero if the shape functions of (s)
+   can not be tabulated */
+ShapeTable const* getShapeTable(FieldShape* s, int type,
+    Integration const* in);
+
+}
+
+#endif
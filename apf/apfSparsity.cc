@@ -0,0 +1,218 @@
+/*
+ * Copyright 2011 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include <PCU.h>
+#include "apfNumbering.h"
+#include "apfNumberingClass.h"
+#include "apfFieldData.h"
+#include "apfShape.h"
+#include <pcu_util.h>
+#include <algorithm>
+
+namespace apf {
+
+typedef std::pair<int, long> Entry;
+typedef std::pair<long, MeshEntity*> RowCopy;
+
+static int findSorted(std::vector<long> const& sorted, long x)
+{
+  std::vector<long>::const_iterator it =
+    std::lower_bound(sorted.begin(), sorted.end(), x);
+  if (it == sorted.end() || *it != x)
+    return -1;
+  return static_cast<int>(it - sorted.begin());
+}
+
+static int findCopy(std::vector<RowCopy> const& sorted, long x)
+{
+  std::vector<RowCopy>::const_iterator it =
+    std::lower_bound(sorted.begin(), sorted.end(), RowCopy(x, 0));
+  if (it == sorted.end() || it->first != x)
+    return -1;
+  return static_cast<int>(it - sorted.begin());
+}
+
+int Sparsity::findRow(long row) const
+{
+  return findSorted(rows, row);
+}
+
+/* buckets the entries by row, then sorts each row and merges
+   the repeated columns */
+static void compress(int nrows, std::vector<Entry> const& entries,
+    std::vector<int>& offsets, std::vector<long>& columns)
+{
+  offsets.assign(nrows + 1, 0);
+  for (size_t i = 0; i < entries.size(); ++i)
+    ++offsets[entries[i].first + 1];
+  for (int i = 0; i < nrows; ++i)
+    offsets[i + 1] += offsets[i];
+  columns.resize(entries.size());
+  std::vector<int> next(offsets.begin(), offsets.end() - 1);
+  for (size_t i = 0; i < entries.size(); ++i)
+    columns[next[entries[i].first]++] = entries[i].second;
+  int n = 0;
+  for (int i = 0; i < nrows; ++i)
+  {
+    std::vector<long>::iterator begin = columns.begin() + offsets[i];
+    std::vector<long>::iterator end = columns.begin() + offsets[i + 1];
+    std::sort(begin, end);
+    end = std::unique(begin, end);
+    offsets[i] = n;
+    for (; begin != end; ++begin)
+      columns[n++] = *begin;
+  }
+  offsets[nrows] = n;
+  columns.resize(n);
+}
+
+/* collects the numbered rows of owned entities, and those of other
+   entities with the entities, so their couplings can be sent */
+template <class T>
+static void getRows(NumberingOf<T>* n, Sharing* shr,
+    std::vector<long>& rows, std::vector<RowCopy>& others)
+{
+  Mesh* m = n->getMesh();
+  FieldShape* s = n->getShape();
+  FieldDataOf<T>* data = n->getData();
+  std::vector<T> values;
+  for (int d = 0; d < 4; ++d)
+  {
+    if ( ! s->hasNodesIn(d))
+      continue;
+    MeshIterator* it = m->begin(d);
+    MeshEntity* e;
+    while ((e = m->iterate(it)))
+    {
+      if ( ! data->hasEntity(e))
+        continue;
+      values.resize(n->countValuesOn(e));
+      if (values.empty())
+        continue;
+      data->get(e, &values[0]);
+      bool owned = ( ! shr) || shr->isOwned(e);
+      for (size_t i = 0; i < values.size(); ++i)
+        if (values[i] >= 0)
+        {
+          if (owned)
+            rows.push_back(values[i]);
+          else
+            others.push_back(RowCopy(values[i], e));
+        }
+    }
+    m->end(it);
+  }
+  std::sort(rows.begin(), rows.end());
+  rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+  std::sort(others.begin(), others.end());
+}
+
+/* sends the couplings of rows this part does not own to all
+   copies of their entities, the owners keep them */
+static void sendCouplings(Sharing* shr, std::vector<RowCopy> const& others,
+    std::vector<Entry> const& remote, std::vector<long> const& rows,
+    std::vector<Entry>& entries)
+{
+  std::vector<int> offsets;
+  std::vector<long> columns;
+  compress(static_cast<int>(others.size()), remote, offsets, columns);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < others.size(); ++i)
+  {
+    int n = offsets[i + 1] - offsets[i];
+    if (!n)
+      continue;
+    CopyArray copies;
+    shr->getCopies(others[i].second, copies);
+    for (size_t j = 0; j < copies.getSize(); ++j)
+    {
+      int to = copies[j].peer;
+      PCU_COMM_PACK(to, others[i].first);
+      PCU_COMM_PACK(to, n);
+      PCU_Comm_Pack(to, &columns[offsets[i]], n * sizeof(long));
+    }
+  }
+  PCU_Comm_Send();
+  std::vector<long> received;
+  while (PCU_Comm_Receive())
+  {
+    long row;
+    int n;
+    PCU_COMM_UNPACK(row);
+    PCU_COMM_UNPACK(n);
+    received.resize(n);
+    PCU_Comm_Unpack(&received[0], n * sizeof(long));
+    int r = findSorted(rows, row);
+    if (r == -1)
+      continue;
+    for (int j = 0; j < n; ++j)
+      entries.push_back(Entry(r, received[j]));
+  }
+}
+
+template <class T>
+static void getSparsityOf(NumberingOf<T>* n, int dim, Sharing* shr,
+    Sparsity& out)
+{
+  Mesh* m = n->getMesh();
+  std::vector<RowCopy> others;
+  out.rows.clear();
+  getRows(n, shr, out.rows, others);
+  std::vector<Entry> entries;
+  std::vector<Entry> remote;
+  NewArray<T> numbers;
+  MeshIterator* it = m->begin(dim);
+  MeshEntity* e;
+  while ((e = m->iterate(it)))
+  {
+    int nv = n->getData()->getElementData(e, numbers);
+    for (int i = 0; i < nv; ++i)
+    {
+      if (numbers[i] < 0)
+        continue;
+      int r = findSorted(out.rows, numbers[i]);
+      std::vector<Entry>* to = &entries;
+      if (r == -1)
+      {
+        r = findCopy(others, numbers[i]);
+        to = &remote;
+      }
+      PCU_ALWAYS_ASSERT(r != -1);
+      for (int j = 0; j < nv; ++j)
+        if (numbers[j] >= 0)
+          to->push_back(Entry(r, numbers[j]));
+    }
+  }
+  m->end(it);
+  if (shr)
+    sendCouplings(shr, others, remote, out.rows, entries);
+  int nrows = static_cast<int>(out.rows.size());
+  compress(nrows, entries, out.offsets, out.columns);
+  out.diagonalCounts.assign(nrows, 0);
+  out.offDiagonalCounts.assign(nrows, 0);
+  for (int i = 0; i < nrows; ++i)
+    for (int j = out.offsets[i]; j < out.offsets[i + 1]; ++j)
+      if (findSorted(out.rows, out.columns[j]) != -1)
+        ++out.diagonalCounts[i];
+      else
+        ++out.offDiagonalCounts[i];
+}
+
+void getSparsity(Numbering* n, int dim, Sparsity& out)
+{
+  getSparsityOf(n, dim, 0, out);
+}
+
+void getSparsity(GlobalNumbering* n, int dim, Sparsity& out, Sharing* shr)
+{
+  if (!shr)
+    shr = getSharing(n->getMesh());
+  getSparsityOf(n, dim, shr, out);
+  delete shr;
+}
+
+}
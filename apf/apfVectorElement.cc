@@ -42,7 +42,7 @@ void VectorElement::curl(Vector3 const& xi, Vector3& c)
 }
 
 void VectorElement::gradHelper(
-    NewArray<Vector3>& nodalGradients,
+    Vector3 const* nodalGradients,
     Matrix3x3& g)
 {
   Vector3* nodeValues = getNodeValues();
@@ -55,14 +55,19 @@ void VectorElement::grad(Vector3 const& xi, Matrix3x3& g)
 {
   NewArray<Vector3> globalGradients;
   getGlobalGradients(xi,globalGradients);
-  gradHelper(globalGradients,g);
+  gradHelper(&globalGradients[0],g);
 }
 
 void VectorElement::getJacobian(Vector3 const& xi, Matrix3x3& J)
 {
+  Vector3 const* tabulatedGradients = getTabulatedGradients(xi);
+  if (tabulatedGradients) {
+    gradHelper(tabulatedGradients,J);
+    return;
+  }
   NewArray<Vector3> localGradients;
   this->shape->getLocalGradients(mesh, entity, xi, localGradients);
-  gradHelper(localGradients,J);
+  gradHelper(&localGradients[0],J);
 }
 
 double getJacobianDeterminant(Matrix3x3 const& J, int dimension)
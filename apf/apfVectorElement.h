@@ -26,7 +26,7 @@ class VectorElement : public ElementOf<Vector3>
     void curl(Vector3 const& xi, Vector3& c);
     void getJacobian(Vector3 const& xi, Matrix3x3& J);
     double getDV(Vector3 const& xi);
-    void gradHelper(NewArray<Vector3>& nodalGradients, Matrix3x3& g);
+    void gradHelper(Vector3 const* nodalGradients, Matrix3x3& g);
 };
 
 double getJacobianDeterminant(Matrix3x3 const& J, int dimension);
@@ -15,6 +15,7 @@ set(APF_SOURCES
   apfFieldOf.cc
   apfGradientByVolume.cc
   apfIntegrate.cc
+  apfBlockIntegrator.cc
   apfMatrix.cc
   apfDynamicMatrix.cc
   apfDynamicVector.cc
@@ -25,6 +26,7 @@ set(APF_SOURCES
   apfScalarElement.cc
   apfScalarField.cc
   apfShape.cc
+  apfShapeTable.cc
   apfIPShape.cc
   apfHierarchic.cc
   apfVector.cc
@@ -34,6 +36,7 @@ set(APF_SOURCES
   apfNumbering.cc
   apfMixedNumbering.cc
   apfAdjReorder.cc
+  apfSparsity.cc
   apfVtk.cc
   apfFieldData.cc
   apfTagData.cc
@@ -61,6 +64,7 @@ set(APF_HEADERS
   apfDynamicArray.h
   apfNew.h
   apfCavityOp.h
+  apfBlockIntegrator.h
   apfShape.h
   apfNumbering.h
   apfMixedNumbering.h
@@ -11,87 +11,191 @@
 #include "crvMath.h"
 #include "crvTables.h"
 #include <pcu_util.h>
+#include <type_traits>
 
 namespace crv {
 
-static void bezierCurve(int P, apf::Vector3 const& xi,
+/* Every Bezier basis function is a multinomial coefficient times
+   a product of powers of the barycentric coordinates.
+   The coefficients come from Pascal's triangle, built once, and
+   the powers are tabulated once per point, so each function costs
+   a few multiplications instead of repeated intpow and binomial
+   calls. */
+class Multinomials
+{
+  public:
+    Multinomials()
+    {
+      for (unsigned n = 0; n <= MAX_ORDER; ++n) {
+        c[n][0] = c[n][n] = 1;
+        for (unsigned i = 1; i < n; ++i)
+          c[n][i] = c[n-1][i-1] + c[n-1][i];
+      }
+    }
+    double operator()(int n, int i) const
+    {
+      return c[n][i];
+    }
+    double operator()(int n, int i, int j) const
+    {
+      return c[n][i]*c[n-i][j];
+    }
+    double operator()(int n, int i, int j, int k) const
+    {
+      return c[n][i]*c[n-i][j]*c[n-i-j][k];
+    }
+  private:
+    double c[MAX_ORDER+1][MAX_ORDER+1];
+};
+
+static Multinomials const multinomial;
+
+/* powers 0 to P of up to four barycentric coordinates */
+struct Powers
+{
+  Powers(int P, int n, double const* x)
+  {
+    for (int c = 0; c < n; ++c) {
+      p[c][0] = 1.;
+      for (int e = 1; e <= P; ++e)
+        p[c][e] = p[c][e-1]*x[c];
+    }
+  }
+  double operator()(int c, int e) const
+  {
+    return p[c][e];
+  }
+  double p[4][MAX_ORDER+1];
+};
+
+/* the evaluators below take the order as a template parameter,
+   either a plain int or an std::integral_constant, so that
+   orders 1 to 6 get their own copies with constant loop bounds */
+#define CRV_FIXED_ORDER(f, P, xi, out) \
+  switch (P) { \
+    case 1: return f(std::integral_constant<int,1>(), xi, out); \
+    case 2: return f(std::integral_constant<int,2>(), xi, out); \
+    case 3: return f(std::integral_constant<int,3>(), xi, out); \
+    case 4: return f(std::integral_constant<int,4>(), xi, out); \
+    case 5: return f(std::integral_constant<int,5>(), xi, out); \
+    case 6: return f(std::integral_constant<int,6>(), xi, out); \
+    default: return f(P, xi, out); \
+  }
+
+template <class Order>
+static void bezierCurveOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<double>& values)
 {
   double t = 0.5*(xi[0]+1.);
+  double x[2] = {1.-t, t};
+  Powers pw(P, 2, x);
   for(int i = 1; i < P; ++i)
-    values[i+1] = binomial(P,i)*Bij(P-i,i,1.-t,t);
-  values[0] = intpow(1-t, P);
-  values[1] = intpow(t, P);
+    values[i+1] = multinomial(P,i)*pw(0,P-i)*pw(1,i);
+  values[0] = pw(0,P);
+  values[1] = pw(1,P);
 }
 
-static void bezierCurveGrads(int P, apf::Vector3 const& xi,
+template <class Order>
+static void bezierCurveGradsOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<apf::Vector3>& grads)
 {
   double t = 0.5*(xi[0]+1.);
+  double x[2] = {1.-t, t};
+  Powers pw(P, 2, x);
   for(int i = 1; i < P; ++i)
-    grads[i+1] = apf::Vector3(binomial(P,i)*(i-P*t)
-        *Bij(P-1-i,i-1,1.-t,t)/2.,0,0);
-  grads[0] = apf::Vector3(-P*intpow(1-t, P-1)/2.,0,0);
-  grads[1] = apf::Vector3(P*intpow(t, P-1)/2.,0,0);
+    grads[i+1] = apf::Vector3(multinomial(P,i)*(i-P*t)
+        *pw(0,P-1-i)*pw(1,i-1)/2.,0,0);
+  grads[0] = apf::Vector3(-P*pw(0,P-1)/2.,0,0);
+  grads[1] = apf::Vector3(P*pw(1,P-1)/2.,0,0);
 }
 
-static void bezierTriangle(int P, apf::Vector3 const& xi,
+static void bezierCurve(int P, apf::Vector3 const& xi,
+    apf::NewArray<double>& values)
+{
+  CRV_FIXED_ORDER(bezierCurveOf, P, xi, values)
+}
+
+static void bezierCurveGrads(int P, apf::Vector3 const& xi,
+    apf::NewArray<apf::Vector3>& grads)
+{
+  CRV_FIXED_ORDER(bezierCurveGradsOf, P, xi, grads)
+}
+
+template <class Order>
+static void bezierTriangleOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<double>& values)
 {
   double xii[3] = {1.-xi[0]-xi[1],xi[0],xi[1]};
+  Powers pw(P, 3, xii);
   for(int i = 0; i < P+1; ++i)
     for(int j = 0; j < P+1-i; ++j)
       values[getTriNodeIndex(P,i,j)] =
-          trinomial(P,i,j)*Bijk(i,j,P-i-j,xii[0],xii[1],xii[2]);
+          multinomial(P,i,j)*pw(0,i)*pw(1,j)*pw(2,P-i-j);
 }
 
-static void bezierTriangleGrads(int P, apf::Vector3 const& xi,
+template <class Order>
+static void bezierTriangleGradsOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<apf::Vector3>& grads)
 {
 
   double xii[3] = {1.-xi[0]-xi[1],xi[0],xi[1]};
+  Powers pw(P, 3, xii);
 
   apf::Vector3 gxii[3] =
   {apf::Vector3(-1,-1,0),apf::Vector3(1,0,0),apf::Vector3(0,1,0)};
 
   for(int i = 0; i < 3; ++i)
-    grads[i] = gxii[i]*P*intpow(xii[i],P-1);
+    grads[i] = gxii[i]*P*pw(i,P-1);
 
   for(int i = 1; i < P+1; ++i)
     for(int j = 1; j < P-i; ++j)
       grads[getTriNodeIndex(P,i,j)] =
-          gxii[0]*trinomial(P,i,j)*(i*(1.-xii[1])-(P-j)*xii[0])
-          *Bijk(i-1,j,P-i-j-1,xii[0],xii[1],xii[2]) +
-          gxii[1]*trinomial(P,i,j)*(j*(1.-xii[0])-(P-i)*xii[1])
-          *Bijk(i,j-1,P-i-j-1,xii[0],xii[1],xii[2]);
+          gxii[0]*multinomial(P,i,j)*(i*(1.-xii[1])-(P-j)*xii[0])
+          *pw(0,i-1)*pw(1,j)*pw(2,P-i-j-1) +
+          gxii[1]*multinomial(P,i,j)*(j*(1.-xii[0])-(P-i)*xii[1])
+          *pw(0,i)*pw(1,j-1)*pw(2,P-i-j-1);
 
   // i = 0
   for(int j = 1; j < P; ++j)
     grads[3+2*(P-1)-j] =
         (gxii[0]*(j-P)*xii[1] +
             gxii[1]*(j*(1.-xii[0])-P*xii[1]))
-            *binomial(P,j)*Bij(j-1,P-j-1,xii[1],xii[2]);
+            *multinomial(P,j)*pw(1,j-1)*pw(2,P-j-1);
 
   // j = 0
   for(int i = 1; i < P; ++i)
     grads[3+2*(P-1)-1+i] =
         (gxii[0]*(i*(1.-xii[1])-P*xii[0]) +
             gxii[1]*(i-P)*xii[0])
-            *binomial(P,i)*Bij(i-1,P-i-1,xii[0],xii[2]);
+            *multinomial(P,i)*pw(0,i-1)*pw(2,P-i-1);
 
   // k = 0
   for(int i = 1, j = P-1; i < P; ++i, --j)
     grads[3+(P-1)-i] =
         (gxii[0]*i*xii[1] + gxii[1]*j*xii[0])
-        *trinomial(P,i,j)*Bij(i-1,j-1,xii[0],xii[1]);
+        *multinomial(P,i,j)*pw(0,i-1)*pw(1,j-1);
 }
 
-static void bezierTet(int P, apf::Vector3 const& xi,
+static void bezierTriangle(int P, apf::Vector3 const& xi,
+    apf::NewArray<double>& values)
+{
+  CRV_FIXED_ORDER(bezierTriangleOf, P, xi, values)
+}
+
+static void bezierTriangleGrads(int P, apf::Vector3 const& xi,
+    apf::NewArray<apf::Vector3>& grads)
+{
+  CRV_FIXED_ORDER(bezierTriangleGradsOf, P, xi, grads)
+}
+
+template <class Order>
+static void bezierTetOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<double>& values)
 {
   double xii[4] = {1.-xi[0]-xi[1]-xi[2],xi[0],xi[1],xi[2]};
+  Powers pw(P, 4, xii);
   for(int i = 0; i < 4; ++i)
-    values[i] = intpow(xii[i],P);
+    values[i] = pw(i,P);
 
   int nE = P-1;
 
@@ -99,48 +203,65 @@ static void bezierTet(int P, apf::Vector3 const& xi,
 
   for(int a = 0; a < 6; ++a)
     for(int b = 0; b < nE; ++b) // edge nodes
-      values[4+a*nE+b] = binomial(P,b+1)
-      *Bij(P-b-1,b+1,xii[tev[a][0]],xii[tev[a][1]]);
+      values[4+a*nE+b] = multinomial(P,b+1)
+      *pw(tev[a][0],P-b-1)*pw(tev[a][1],b+1);
 
   // face 0, l = 0
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j)
-      values[computeTetNodeIndex(P,i,j,P-i-j)] = trinomial(P,i,j)
-      *Bijk(i,j,P-i-j,xii[0],xii[1],xii[2]);
+      values[getTetNodeIndex(P,i,j,P-i-j)] = multinomial(P,i,j)
+      *pw(0,i)*pw(1,j)*pw(2,P-i-j);
   // face 1, k = 0
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j)
-      values[computeTetNodeIndex(P,i,j,0)] = trinomial(P,i,j)
-      *Bijk(i,j,P-i-j,xii[0],xii[1],xii[3]);
+      values[getTetNodeIndex(P,i,j,0)] = multinomial(P,i,j)
+      *pw(0,i)*pw(1,j)*pw(3,P-i-j);
   // face 2, i = 0
   for(int j = 1; j <= P-1; ++j)
     for(int k = 1; k <= P-1-j; ++k)
-      values[computeTetNodeIndex(P,0,j,k)] = trinomial(P,j,k)
-      *Bijk(j,k,P-j-k,xii[1],xii[2],xii[3]);
+      values[getTetNodeIndex(P,0,j,k)] = multinomial(P,j,k)
+      *pw(1,j)*pw(2,k)*pw(3,P-j-k);
   // face 3, j = 0
   for(int i = 1; i <= P-1; ++i)
     for(int k = 1; k <= P-1-i; ++k)
-      values[computeTetNodeIndex(P,i,0,k)] = trinomial(P,i,k)
-      *Bijk(i,k,P-i-k,xii[0],xii[2],xii[3]);
+      values[getTetNodeIndex(P,i,0,k)] = multinomial(P,i,k)
+      *pw(0,i)*pw(2,k)*pw(3,P-i-k);
 
   // internal nodes
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j)
       for(int k = 1; k <= P-1-i-j; ++k)
-        values[computeTetNodeIndex(P,i,j,k)] = quadnomial(P,i,j,k)
-        *Bijkl(i,j,k,P-i-j-k,xii[0],xii[1],xii[2],xii[3]);
+        values[getTetNodeIndex(P,i,j,k)] = multinomial(P,i,j,k)
+        *pw(0,i)*pw(1,j)*pw(2,k)*pw(3,P-i-j-k);
 
 }
 
-static void bezierTetGrads(int P, apf::Vector3 const& xi,
+/* the gradient of the product of powers e[b] of the
+   coordinates v[b], without its coefficient */
+static apf::Vector3 getProductGrad(Powers const& pw,
+    apf::Vector3 const* gxii, int n, int const* v, int const* e)
+{
+  apf::Vector3 g(0,0,0);
+  for(int b = 0; b < n; ++b){
+    double f = e[b];
+    for(int c = 0; c < n; ++c)
+      f *= pw(v[c], e[c] - (c == b));
+    g += gxii[v[b]]*f;
+  }
+  return g;
+}
+
+template <class Order>
+static void bezierTetGradsOf(Order P, apf::Vector3 const& xi,
     apf::NewArray<apf::Vector3>& grads)
 {
   double xii[4] = {1.-xi[0]-xi[1]-xi[2],xi[0],xi[1],xi[2]};
+  Powers pw(P, 4, xii);
   apf::Vector3 gxii[4] = {apf::Vector3(-1,-1,-1),apf::Vector3(1,0,0),
       apf::Vector3(0,1,0),apf::Vector3(0,0,1)};
 
   for(int i = 0; i < 4; ++i)
-    grads[i] = gxii[i]*P*intpow(xii[i],P-1);
+    grads[i] = gxii[i]*P*pw(i,P-1);
 
   int nE = P-1;
 
@@ -149,88 +270,64 @@ static void bezierTetGrads(int P, apf::Vector3 const& xi,
 
   for(int a = 0; a < 6; ++a)
     for(int b = 0; b < nE; ++b) // edge nodes
-      grads[4+a*nE+b] = gxii[tev[a][0]]*binomial(P,b+1)*(P-b-1)
-                        *Bij(P-b-2,b+1,xii[tev[a][0]],xii[tev[a][1]])
-                      + gxii[tev[a][1]]*binomial(P,b+1)*(b+1)
-                        *Bij(P-b-1,b,xii[tev[a][0]],xii[tev[a][1]]);
+      grads[4+a*nE+b] = gxii[tev[a][0]]*multinomial(P,b+1)*(P-b-1)
+                        *pw(tev[a][0],P-b-2)*pw(tev[a][1],b+1)
+                      + gxii[tev[a][1]]*multinomial(P,b+1)*(b+1)
+                        *pw(tev[a][0],P-b-1)*pw(tev[a][1],b);
 
   // face 0, l = 0
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j){
-      int index = computeTetNodeIndex(P,i,j,P-i-j);
-      grads[index].zero();
       int ijk[3] = {i,j,P-i-j};
-      for(int b = 0; b < 3; ++b){
-        grads[index] += gxii[ttv[0][b]]*ijk[b]
-                       *Bijk(ijk[b % 3]-1,ijk[(b+1) % 3],ijk[(b+2) % 3],
-                        xii[ttv[0][b % 3]],xii[ttv[0][(b+1) % 3]],
-                        xii[ttv[0][(b+2) % 3]]);
-
-      }
-      grads[index] = grads[index]*trinomial(P,i,j);
+      grads[getTetNodeIndex(P,i,j,P-i-j)] =
+          getProductGrad(pw,gxii,3,ttv[0],ijk)*multinomial(P,i,j);
     }
   // face 1, k = 0
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j){
-      int index = computeTetNodeIndex(P,i,j,0);
-      grads[index].zero();
       int ijk[3] = {i,j,P-i-j};
-      for(int b = 0; b < 3; ++b){
-        grads[index] += gxii[ttv[1][b]]*ijk[b]
-                       *Bijk(ijk[b % 3]-1,ijk[(b+1) % 3],ijk[(b+2) % 3],
-                        xii[ttv[1][b % 3]],xii[ttv[1][(b+1) % 3]],
-                        xii[ttv[1][(b+2) % 3]]);
-
-      }
-      grads[index] = grads[index]*trinomial(P,i,j);
+      grads[getTetNodeIndex(P,i,j,0)] =
+          getProductGrad(pw,gxii,3,ttv[1],ijk)*multinomial(P,i,j);
     }
   // face 2, i = 0
   for(int j = 1; j <= P-1; ++j)
     for(int k = 1; k <= P-1-j; ++k){
-      int index = computeTetNodeIndex(P,0,j,k);
-      grads[index].zero();
       int jkl[3] = {j,k,P-j-k};
-      for(int b = 0; b < 3; ++b){
-        grads[index] += gxii[ttv[2][b]]*jkl[b]
-                       *Bijk(jkl[b % 3]-1,jkl[(b+1) % 3],jkl[(b+2) % 3],
-                        xii[ttv[2][b % 3]],xii[ttv[2][(b+1) % 3]],
-                        xii[ttv[2][(b+2) % 3]]);
-
-      }
-      grads[index] = grads[index]*trinomial(P,j,k);
+      grads[getTetNodeIndex(P,0,j,k)] =
+          getProductGrad(pw,gxii,3,ttv[2],jkl)*multinomial(P,j,k);
     }
   // face 3, j = 0
   for(int i = 1; i <= P-1; ++i)
-      for(int k = 1; k <= P-1-i; ++k){
-        int index = computeTetNodeIndex(P,i,0,k);
-        grads[index].zero();
-        int ikl[3] = {i,k,P-i-k};
-        for(int b = 0; b < 3; ++b){
-          grads[index] += gxii[ttv[3][b]]*ikl[b]
-                         *Bijk(ikl[b % 3]-1,ikl[(b+1) % 3],ikl[(b+2) % 3],
-                          xii[ttv[3][b % 3]],xii[ttv[3][(b+1) % 3]],
-                          xii[ttv[3][(b+2) % 3]]);
-
-        }
-        grads[index] = grads[index]*trinomial(P,i,k);
-      }
+    for(int k = 1; k <= P-1-i; ++k){
+      int ikl[3] = {i,k,P-i-k};
+      grads[getTetNodeIndex(P,i,0,k)] =
+          getProductGrad(pw,gxii,3,ttv[3],ikl)*multinomial(P,i,k);
+    }
   // internal nodes
+  static int const tv[4] = {0,1,2,3};
   for(int i = 1; i <= P-1; ++i)
     for(int j = 1; j <= P-1-i; ++j)
       for(int k = 1; k <= P-1-i-j; ++k){
-        int index = computeTetNodeIndex(P,i,j,k);
-        grads[index].zero();
         int ijkl[4] = {i,j,k,P-i-j-k};
-        for(int b = 0; b < 4; ++b){
-          grads[index] += gxii[b]*ijkl[b]
-             *Bijkl(ijkl[b % 4]-1,ijkl[(b+1) % 4],ijkl[(b+2) % 4],ijkl[(b+3) % 4],
-                 xii[b],xii[(b+1) % 4],xii[(b+2) % 4],xii[(b+3) % 4]);
-
-        }
-        grads[index] = grads[index]*quadnomial(P,i,j,k);
+        grads[getTetNodeIndex(P,i,j,k)] =
+            getProductGrad(pw,gxii,4,tv,ijkl)*multinomial(P,i,j,k);
       }
 }
 
+static void bezierTet(int P, apf::Vector3 const& xi,
+    apf::NewArray<double>& values)
+{
+  CRV_FIXED_ORDER(bezierTetOf, P, xi, values)
+}
+
+static void bezierTetGrads(int P, apf::Vector3 const& xi,
+    apf::NewArray<apf::Vector3>& grads)
+{
+  CRV_FIXED_ORDER(bezierTetGradsOf, P, xi, grads)
+}
+
+#undef CRV_FIXED_ORDER
+
 void collectNodeXi(int parentType, int childType, int P,
     const apf::Vector3* range, apf::NewArray<apf::Vector3>& xi)
 {
@@ -293,6 +293,26 @@ class BezierHandler : public ma::ShapeHandler
       }
       return -1;
     }
+    /* the straight-sided part of tet quality is measured in
+       batches, only valid tets need the curved measure */
+    virtual void getQualities(apf::MeshEntity** e, size_t n, double* q)
+    {
+      size_t i = 0;
+      while (i < n) {
+        if (mesh->getType(e[i]) != apf::Mesh::TET) {
+          q[i] = getQuality(e[i]);
+          ++i;
+          continue;
+        }
+        size_t end = i + 1;
+        while (end < n && mesh->getType(e[end]) == apf::Mesh::TET)
+          ++end;
+        ma::measureLinearTetQualities(mesh, e + i, end - i, q + i);
+        for (; i < end; ++i)
+          if (q[i] >= 0)
+            q[i] *= qual->getQuality(e[i]);
+      }
+    }
     virtual bool hasNodesOn(int dimension)
     {
       return bt->hasNodesOn(dimension);
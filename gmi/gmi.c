@@ -91,6 +91,18 @@ void gmi_eval(struct gmi_model* m, struct gmi_ent* e,
   m->ops->eval(m, e, p, x);
 }
 
+void gmi_eval_batch(struct gmi_model* m, struct gmi_ent* e, int n,
+    double const* p, double* x)
+{
+  int i;
+  if (m->ops->eval_batch) {
+    m->ops->eval_batch(m, e, n, p, x);
+    return;
+  }
+  for (i = 0; i < n; ++i)
+    m->ops->eval(m, e, p + 2 * i, x + 3 * i);
+}
+
 void gmi_reparam(struct gmi_model* m, struct gmi_ent* from,
     double const from_p[2], struct gmi_ent* to, double to_p[2])
 {
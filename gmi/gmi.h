@@ -102,6 +102,12 @@ struct gmi_model_ops {
 
   /** \brief implement gmi_destroy */
   void (*destroy)(struct gmi_model* m);
+  /* newer operations are appended here so that
+     the offsets of the ones above do not change */
+  /** \brief implement gmi_eval_batch
+   \details if omitted then gmi_eval_batch calls eval once per point */
+  void (*eval_batch)(struct gmi_model* m, struct gmi_ent* e, int n,
+      double const* p, double* x);
 };
 
 /** \brief the basic structure for all GMI models */
@@ -151,6 +157,15 @@ int gmi_can_eval(struct gmi_model* m);
   \param x the resulting point in space */
 void gmi_eval(struct gmi_model* m, struct gmi_ent* e,
     double const p[2], double x[3]);
+/** \brief evaluate many parametric points on one model boundary entity
+  \param n the number of points
+  \param p n pairs of parametric coordinates, in the format of gmi_eval
+  \param x the resulting n points in space, three values each
+  \details requires gmi_can_eval. models may implement this
+           to amortize per-call costs, otherwise it calls gmi_eval
+           once per point */
+void gmi_eval_batch(struct gmi_model* m, struct gmi_ent* e, int n,
+    double const* p, double* x);
 /** \brief re-parameterize from one model entity to another
   \param from the model entity to start from
   \param from_p the parametric coordinates on entity (from),
@@ -21,6 +21,7 @@ struct gmi_analytic
 {
   struct gmi_base base;
   struct agm_tag* f;
+  struct agm_tag* batch;
   struct agm_tag* periodic;
   struct agm_tag* ranges;
   struct agm_tag* data;
@@ -33,6 +34,12 @@ static gmi_analytic_fun* f_of(struct gmi_analytic* m, struct agm_ent e)
   return agm_tag_at(m->f, AGM_ENTITY, e.type, e.id);
 }
 
+static gmi_analytic_batch_fun* batch_of(struct gmi_analytic* m,
+    struct agm_ent e)
+{
+  return agm_tag_at(m->batch, AGM_ENTITY, e.type, e.id);
+}
+
 static periodic_t* periodic_of(struct gmi_analytic* m, struct agm_ent e)
 {
   return agm_tag_at(m->periodic, AGM_ENTITY, e.type, e.id);
@@ -74,6 +81,7 @@ struct gmi_ent* gmi_add_analytic(struct gmi_model* m, int dim, int tag,
   m2 = to_model(m);
   e = agm_from_gmi(gmi_null_find(m, dim, tag));
   *(f_of(m2, e)) = f;
+  *(batch_of(m2, e)) = NULL;
   pp = periodic_of(m2, e);
   rp = ranges_of(m2, e);
   for (i = 0; i < dim; ++i) {
@@ -104,6 +112,28 @@ static void eval(struct gmi_model* m, struct gmi_ent* e,
   (*f)(p, x, u);
 }
 
+static void eval_batch(struct gmi_model* m, struct gmi_ent* e, int n,
+      double const* p, double* x)
+{
+  struct gmi_analytic* m2;
+  struct agm_ent a;
+  void* u;
+  gmi_analytic_fun f;
+  gmi_analytic_batch_fun bf;
+  int i;
+  m2 = to_model(m);
+  a = agm_from_gmi(e);
+  u = *(data_of(m2, a));
+  bf = *(batch_of(m2, a));
+  if (bf) {
+    (*bf)(n, p, x, u);
+    return;
+  }
+  f = *(f_of(m2, a));
+  for (i = 0; i < n; ++i)
+    (*f)(p + 2 * i, x + 3 * i, u);
+}
+
 static void reparam_across(struct gmi_analytic* m, struct agm_use u,
     double const from_p[2], double to_p[2])
 {
@@ -171,7 +201,8 @@ static struct gmi_model_ops ops = {
   .reparam  = reparam,
   .periodic = periodic,
   .range    = range,
-  .destroy  = gmi_base_destroy
+  .destroy  = gmi_base_destroy,
+  .eval_batch = eval_batch
 };
 
 struct gmi_model* gmi_make_analytic(void)
@@ -181,6 +212,7 @@ struct gmi_model* gmi_make_analytic(void)
   m->base.model.ops = &ops;
   gmi_base_init(&m->base);
   m->f = agm_new_tag(m->base.topo, sizeof(gmi_analytic_fun));
+  m->batch = agm_new_tag(m->base.topo, sizeof(gmi_analytic_batch_fun));
   m->periodic = agm_new_tag(m->base.topo, sizeof(periodic_t));
   m->ranges = agm_new_tag(m->base.topo, sizeof(ranges_t));
   m->data = agm_new_tag(m->base.topo, sizeof(void*));
@@ -189,6 +221,13 @@ struct gmi_model* gmi_make_analytic(void)
   return &m->base.model;
 }
 
+void gmi_add_analytic_batch(struct gmi_model* m, struct gmi_ent* e,
+    gmi_analytic_batch_fun f)
+{
+  struct gmi_analytic* m2 = to_model(m);
+  *(batch_of(m2, agm_from_gmi(e))) = f;
+}
+
 void* gmi_analytic_data(struct gmi_model* m, struct gmi_ent* e)
 {
   struct gmi_analytic* m2 = to_model(m);
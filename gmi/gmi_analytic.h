@@ -26,6 +26,16 @@ extern "C" {
   \param u pointer to user data */
 typedef void (*gmi_analytic_fun)(double const p[2], double x[3], void* u);
 
+/** \brief the analytic parameterization of many points at once
+  \param n the number of points
+  \param p n pairs of parametric coordinates
+  \param x the resulting n points, three values each
+  \param u pointer to user data
+  \details a loop over the points without calls in its body
+           lets the compiler vectorize the evaluation */
+typedef void (*gmi_analytic_batch_fun)(int n, double const* p, double* x,
+    void* u);
+
 /** \brief a re-parametrization from one entity to another
   \param from the coordinates in the input parametric space
   \param to   the coordinates in the output parametric space
@@ -48,6 +58,13 @@ struct gmi_model* gmi_make_analytic(void);
                    function for this entity */
 struct gmi_ent* gmi_add_analytic(struct gmi_model* m, int dim, int tag,
     gmi_analytic_fun f, int* periodic, double (*ranges)[2], void* user_data);
+/** \brief give an analytic entity a batched parameterization
+  \details gmi_eval_batch on (e) will call (f) once with all points.
+  (f) must compute the same points as the function given to
+  gmi_add_analytic, which is still used by gmi_eval.
+  entities without one fall back to calling that function per point */
+void gmi_add_analytic_batch(struct gmi_model* m, struct gmi_ent* e,
+    gmi_analytic_batch_fun f);
 /** \brief get the analytic user data
   \details this function returns the pointer passed as (user_data)
   to gmi_add_analytic when creating entity (e) */
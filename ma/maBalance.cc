@@ -32,10 +32,24 @@ static double getSizeWeight(Adapt* a, Entity* e, int type)
   return a->sizeField->getWeight(e);
 }
 
-static double clampForIterations(Adapt* a, double weight)
+/* prisms and pyramids are only split along the layer unless all
+   their edges are being split, so they grow like their bases.
+   hexes and quads refine in every direction like simplices. */
+static bool growsLikeLayerBase(Adapt* a, int type)
+{
+  return (type == apf::Mesh::PRISM || type == apf::Mesh::PYRAMID) &&
+         ( ! a->input->splitAllLayerEdges);
+}
+
+static double clampForIterations(Adapt* a, int type, double weight,
+    bool predictive)
 {
   Mesh* m = a->mesh;
   int dimension = m->getDimension();
+/* only the predictive balancer accounts for layer growth,
+   the other balancers keep their established weights */
+  if (predictive && growsLikeLayerBase(a, type))
+    --dimension;
   double max = pow(2.0, dimension*(a->refinesLeft));
 /* coarsening performance is more empirical: 3x decrease in tet
    count when uniformly refining a 58k element cube, 4x decrease
@@ -66,16 +80,21 @@ static double accountForTets(Adapt* a, int type, double weight)
   return weight;
 }
 
-double getElementWeight(Adapt* a, Entity* e)
+static double getElementWeight(Adapt* a, Entity* e, bool predictive)
 {
   int type = a->mesh->getType(e);
   double weight = getSizeWeight(a, e, type);
-  weight = clampForIterations(a, weight);
+  weight = clampForIterations(a, type, weight, predictive);
   weight = clampForLayerPermissions(a, type, weight);
   return accountForTets(a, type, weight);
 }
 
-Tag* getElementWeights(Adapt* a)
+double getElementWeight(Adapt* a, Entity* e)
+{
+  return getElementWeight(a, e, false);
+}
+
+static Tag* getElementWeights(Adapt* a, bool predictive)
 {
   Mesh* m = a->mesh;
   Tag* weights = m->createDoubleTag("ma_weight",1);
@@ -83,13 +102,18 @@ Tag* getElementWeights(Adapt* a)
   Iterator* it = m->begin(m->getDimension());
   while ((e = m->iterate(it)))
   {
-    double weight = getElementWeight(a,e);
+    double weight = getElementWeight(a,e,predictive);
     m->setDoubleTag(e,weights,&weight);
   }
   m->end(it);
   return weights;
 }
 
+Tag* getElementWeights(Adapt* a)
+{
+  return getElementWeights(a, false);
+}
+
 static void runBalancer(Adapt* a, apf::Balancer* b)
 {
   Mesh* m = a->mesh;
@@ -113,6 +137,63 @@ void runParma(Adapt* a)
   runBalancer(a, Parma_MakeElmBalancer(a->mesh));
 }
 
+/* the weights estimate how many elements each element
+   will become after the remaining iterations, including
+   metric anisotropy and layer permissions, so their sum
+   over a part predicts its element count */
+static double getPredictedImbalance(Adapt* a, Tag* weights)
+{
+  Mesh* m = a->mesh;
+  double local = 0;
+  Entity* e;
+  Iterator* it = m->begin(m->getDimension());
+  while ((e = m->iterate(it))) {
+    double weight;
+    m->getDoubleTag(e, weights, &weight);
+    local += weight;
+  }
+  m->end(it);
+  double max = PCU_Max_Double(local);
+  double total = PCU_Add_Double(local);
+  return max / (total / PCU_Comm_Peers());
+}
+
+double getPredictedImbalance(Adapt* a)
+{
+  Mesh* m = a->mesh;
+  Tag* weights = getElementWeights(a, /* predictive = */ true);
+  double imbalance = getPredictedImbalance(a, weights);
+  removeTagFromDimension(m, weights, m->getDimension());
+  m->destroyTag(weights);
+  return imbalance;
+}
+
+/* repartitions once, and only when the predicted
+   imbalance is bad enough to matter. Zoltan's adaptive
+   repartitioning trades edge cut against migration volume,
+   ParMA's diffusion only moves elements across part boundaries */
+void runPredictive(Adapt* a)
+{
+  Mesh* m = a->mesh;
+  Input* in = a->input;
+  Tag* weights = getElementWeights(a, /* predictive = */ true);
+  double imbalance = getPredictedImbalance(a, weights);
+  print("predicted element imbalance %.0f%% of average",
+      (imbalance - 1) * 100);
+  if (imbalance > in->maximumImbalance) {
+    apf::Balancer* b;
+    if (apf::hasZoltan())
+      b = apf::makeZoltanBalancer(m, apf::GRAPH, apf::ADAPT_REPART,
+          /* debug = */ false);
+    else
+      b = Parma_MakeElmBalancer(m);
+    b->balance(weights, in->maximumImbalance);
+    delete b;
+  }
+  removeTagFromDimension(m, weights, m->getDimension());
+  m->destroyTag(weights);
+}
+
 void printEntityImbalance(Mesh* m)
 {
   double imbalance[4];
@@ -132,6 +213,8 @@ void preBalance(Adapt* a)
     runZoltan(a,apf::RIB);
   if (in->shouldRunPreParma)
     runParma(a);
+  if (in->shouldRunPrePredictive)
+    runPredictive(a);
 }
 
 void midBalance(Adapt* a)
@@ -145,6 +228,14 @@ void midBalance(Adapt* a)
     runParma(a);
 }
 
+void batchBalance(Adapt* a)
+{
+  if (PCU_Comm_Peers()==1)
+    return;
+  if (a->input->shouldBalanceRefineBatches)
+    runParma(a);
+}
+
 void postBalance(Adapt* a)
 {
   if (PCU_Comm_Peers()==1)
@@ -7,8 +7,14 @@ class Adapt;
 
 void preBalance(Adapt* a);
 void midBalance(Adapt* a);
+void batchBalance(Adapt* a);
 void postBalance(Adapt* a);
 
+/* the largest part's predicted element count after the remaining
+   iterations over the average, as seen by runPredictive */
+double getPredictedImbalance(Adapt* a);
+void runPredictive(Adapt* a);
+
 }
 
 #endif
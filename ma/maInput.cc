@@ -52,6 +52,9 @@ void setDefaultValues(Input* in)
   in->shouldRunPreZoltan = false;
   in->shouldRunPreZoltanRib = false;
   in->shouldRunPreParma = false;
+  in->shouldRunPrePredictive = false;
+  in->maximumSplitElements = 0;
+  in->shouldBalanceRefineBatches = false;
   in->shouldRunMidZoltan = false;
   in->shouldRunMidParma = false;
   in->shouldRunPostZoltan = false;
@@ -62,6 +65,7 @@ void setDefaultValues(Input* in)
   in->shouldRefineLayer = false;
   in->shouldCoarsenLayer = false;
   in->splitAllLayerEdges = false;
+  in->shouldApplyIncrementally = false;
   in->shapeHandler = 0;
 }
 
@@ -109,6 +113,8 @@ void validateInput(Input* in)
     rejectInput("maximum imbalance less than 1.0");
   if (in->maximumEdgeRatio < 1.0)
     rejectInput("maximum tet edge ratio less than one");
+  if (in->maximumSplitElements < 0)
+    rejectInput("negative maximum split element count");
 }
 
 void setSolutionTransfer(Input* in, SolutionTransfer* s)
@@ -74,6 +74,22 @@ class Input
     bool shouldRunPreZoltanRib;
 /** \brief whether to run parma predictive load balancing (default false) */
     bool shouldRunPreParma;
+/** \brief whether to predict the element count of each part after
+    adaptation and, if that prediction exceeds maximumImbalance,
+    repartition once before adapting (default false)
+    \details uses the Zoltan adaptive graph repartitioner when available,
+    which also limits migration volume, otherwise ParMA */
+    bool shouldRunPrePredictive;
+/** \brief maximum number of elements a part splits at once during
+    refinement (default 0, no limit)
+    \details when set, marked edges are split in batches ordered along a
+    space-filling curve, so each batch covers a compact region.
+    a batch only exceeds this when a single edge touches more
+    elements than it allows */
+    int maximumSplitElements;
+/** \brief whether to run parma between refinement batches (default false)
+    \details only used when maximumSplitElements is set */
+    bool shouldBalanceRefineBatches;
 /** \brief whether to run zoltan during adaptation (default false) */
     bool shouldRunMidZoltan;
 /** \brief whether to run parma during adaptation (default false)*/
@@ -97,6 +113,9 @@ class Input
     bool shouldCoarsenLayer;
 /** \brief set to true during UR to get splits in the normal direction */
     bool splitAllLayerEdges;
+/** \brief whether parallel operators revisit only entities near
+    migrated cavities after their first round (default false) */
+    bool shouldApplyIncrementally;
 };
 
 /** \brief generate a configuration based on an anisotropic function.
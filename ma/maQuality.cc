@@ -11,12 +11,14 @@
 #include <cfloat>
 #include <pcu_util.h>
 #include <cstdlib>
+#include <algorithm>
 #include "maMesh.h"
 #include "maSize.h"
 #include "maAdapt.h"
 #include "maShapeHandler.h"
 #include "maShape.h"
 #include <apfGeometry.h>
+#include <apfShape.h>
 
 namespace ma {
 
@@ -142,15 +144,184 @@ double measureElementQuality(Mesh* m, SizeField* f, Entity* e)
   return table[m->getType(e)](m,f,e);
 }
 
+/* structure-of-arrays buffers for one batch of simplices:
+   component c of vertex v of element i is x[v][c][i] and
+   entry (r,c) of its metric transform is Q[r*3+c][i],
+   so the kernels below run over contiguous memory and
+   have no calls in their loop bodies, which lets the
+   compiler vectorize them across the batch */
+struct QualityBatch
+{
+  double x[4][3][QUALITY_BATCH_SIZE];
+  double Q[9][QUALITY_BATCH_SIZE];
+};
+
+static void gatherSimplices(Mesh* m, SizeField* f, Entity** e, int n,
+    QualityBatch& b)
+{
+  for (int i = 0; i < n; ++i) {
+    Entity* v[4];
+    int nv = m->getDownward(e[i], 0, v);
+    for (int j = 0; j < nv; ++j) {
+      Vector p;
+      m->getPoint(v[j], 0, p);
+      for (int c = 0; c < 3; ++c)
+        b.x[j][c][i] = p[c];
+    }
+  }
+  if ( ! f) {
+    for (int k = 0; k < 9; ++k)
+      for (int i = 0; i < n; ++i)
+        b.Q[k][i] = (k % 4) ? 0 : 1;
+    return;
+  }
+  for (int i = 0; i < n; ++i) {
+    /* same as the single-element measures: Q at the center */
+    apf::MeshElement* me = apf::createMeshElement(m, e[i]);
+    Vector xi = (m->getType(e[i]) == apf::Mesh::TET) ?
+      Vector(0.25, 0.25, 0.25) : Vector(1./3., 1./3., 1./3.);
+    Matrix Q;
+    f->getTransform(me, xi, Q);
+    apf::destroyMeshElement(me);
+    for (int r = 0; r < 3; ++r)
+      for (int c = 0; c < 3; ++c)
+        b.Q[r * 3 + c][i] = Q[r][c];
+  }
+}
+
+/* a row vector a is mapped into metric space as aQ,
+   so its squared metric length is a M a^T with M = Q Q^T */
+static inline void formMetric(QualityBatch const& b, int i, double M[6])
+{
+  double const* Q[9];
+  for (int k = 0; k < 9; ++k)
+    Q[k] = b.Q[k];
+  M[0] = Q[0][i]*Q[0][i] + Q[1][i]*Q[1][i] + Q[2][i]*Q[2][i];
+  M[1] = Q[0][i]*Q[3][i] + Q[1][i]*Q[4][i] + Q[2][i]*Q[5][i];
+  M[2] = Q[0][i]*Q[6][i] + Q[1][i]*Q[7][i] + Q[2][i]*Q[8][i];
+  M[3] = Q[3][i]*Q[3][i] + Q[4][i]*Q[4][i] + Q[5][i]*Q[5][i];
+  M[4] = Q[3][i]*Q[6][i] + Q[4][i]*Q[7][i] + Q[5][i]*Q[8][i];
+  M[5] = Q[6][i]*Q[6][i] + Q[7][i]*Q[7][i] + Q[8][i]*Q[8][i];
+}
+
+static inline double metricDot(double const M[6],
+    double const a[3], double const c[3])
+{
+  return a[0]*(M[0]*c[0] + M[1]*c[1] + M[2]*c[2])
+       + a[1]*(M[1]*c[0] + M[3]*c[1] + M[4]*c[2])
+       + a[2]*(M[2]*c[0] + M[4]*c[1] + M[5]*c[2]);
+}
+
+static inline void getEdgeVector(QualityBatch const& b, int i,
+    int v0, int v1, double a[3])
+{
+  for (int c = 0; c < 3; ++c)
+    a[c] = b.x[v1][c][i] - b.x[v0][c][i];
+}
+
+/* the metric volume is det(JQ)/6 = det(J)det(Q)/6 */
+static void measureTetBatch(QualityBatch const& b, int n, double* q)
+{
+  for (int i = 0; i < n; ++i) {
+    double M[6];
+    formMetric(b, i, M);
+    double s = 0;
+    for (int k = 0; k < 6; ++k) {
+      double a[3];
+      getEdgeVector(b, i, apf::tet_edge_verts[k][0],
+          apf::tet_edge_verts[k][1], a);
+      s += metricDot(M, a, a);
+    }
+    double J[3][3];
+    for (int r = 0; r < 3; ++r)
+      getEdgeVector(b, i, 0, r + 1, J[r]);
+    double detJ = J[0][0]*(J[1][1]*J[2][2] - J[1][2]*J[2][1])
+                - J[0][1]*(J[1][0]*J[2][2] - J[1][2]*J[2][0])
+                + J[0][2]*(J[1][0]*J[2][1] - J[1][1]*J[2][0]);
+    double detQ =
+        b.Q[0][i]*(b.Q[4][i]*b.Q[8][i] - b.Q[5][i]*b.Q[7][i])
+      - b.Q[1][i]*(b.Q[3][i]*b.Q[8][i] - b.Q[5][i]*b.Q[6][i])
+      + b.Q[2][i]*(b.Q[3][i]*b.Q[7][i] - b.Q[4][i]*b.Q[6][i]);
+    double V = detJ * detQ / 6;
+    double r = 15552*(V*V)/(s*s*s);
+    q[i] = (V < 0) ? -r : r;
+  }
+}
+
+/* the squared metric area is the Gram determinant of the
+   two edge vectors over 4, which gives 48A^2/s^2 = 12G/s^2 */
+static void measureTriBatch(QualityBatch const& b, int n, double* q)
+{
+  for (int i = 0; i < n; ++i) {
+    double M[6];
+    formMetric(b, i, M);
+    double a[3], c[3], d[3];
+    getEdgeVector(b, i, 0, 1, a);
+    double aa = metricDot(M, a, a);
+    getEdgeVector(b, i, 0, 2, c);
+    double cc = metricDot(M, c, c);
+    getEdgeVector(b, i, 1, 2, d);
+    double s = aa + cc + metricDot(M, d, d);
+    double ac = metricDot(M, a, c);
+    double G = aa*cc - ac*ac;
+    q[i] = 12*G/(s*s);
+  }
+}
+
+static void measureLinearSimplices(Mesh* m, SizeField* f, int type,
+    Entity** e, size_t n, double* q)
+{
+  QualityBatch b;
+  for (size_t start = 0; start < n; start += QUALITY_BATCH_SIZE) {
+    int bn = std::min<size_t>(n - start, QUALITY_BATCH_SIZE);
+    gatherSimplices(m, f, e + start, bn, b);
+    if (type == apf::Mesh::TET)
+      measureTetBatch(b, bn, q + start);
+    else
+      measureTriBatch(b, bn, q + start);
+  }
+}
+
+void measureElementQualities(Mesh* m, SizeField* f,
+    Entity** e, size_t n, double* q)
+{
+  if (m->getShape()->getOrder() != 1) {
+    for (size_t i = 0; i < n; ++i)
+      q[i] = measureElementQuality(m, f, e[i]);
+    return;
+  }
+  /* measure runs of elements of the same type together */
+  size_t start = 0;
+  while (start < n) {
+    int type = m->getType(e[start]);
+    size_t end = start + 1;
+    while (end < n && m->getType(e[end]) == type)
+      ++end;
+    if (type == apf::Mesh::TET || type == apf::Mesh::TRIANGLE)
+      measureLinearSimplices(m, f, type, e + start, end - start, q + start);
+    else
+      for (size_t i = start; i < end; ++i)
+        q[i] = measureElementQuality(m, f, e[i]);
+    start = end;
+  }
+}
+
+void measureLinearTetQualities(Mesh* m, Entity** tets, size_t n, double* q)
+{
+  measureLinearSimplices(m, 0, apf::Mesh::TET, tets, n, q);
+}
+
 double getWorstQuality(Adapt* a, Entity** e, size_t n)
 {
   PCU_ALWAYS_ASSERT(n);
   ShapeHandler* sh = a->shape;
-  double worst = sh->getQuality(e[0]);
-  for (size_t i = 1; i < n; ++i) {
-    double quality = sh->getQuality(e[i]);
-    if (quality < worst)
-      worst = quality;
+  double q[QUALITY_BATCH_SIZE];
+  double worst = DBL_MAX;
+  for (size_t start = 0; start < n; start += QUALITY_BATCH_SIZE) {
+    size_t bn = std::min<size_t>(n - start, QUALITY_BATCH_SIZE);
+    sh->getQualities(e + start, bn, q);
+    for (size_t i = 0; i < bn; ++i)
+      worst = std::min(worst, q[i]);
   }
   return worst;
 }
@@ -164,10 +335,13 @@ bool hasWorseQuality(Adapt* a, EntityArray& e, double qualityToBeat)
 {
   size_t n = e.getSize();
   ShapeHandler* sh = a->shape;
-  for (size_t i = 0; i < n; ++i) {
-    double quality = sh->getQuality(e[i]);
-    if (quality < qualityToBeat)
-      return true;
+  double q[QUALITY_BATCH_SIZE];
+  for (size_t start = 0; start < n; start += QUALITY_BATCH_SIZE) {
+    size_t bn = std::min<size_t>(n - start, QUALITY_BATCH_SIZE);
+    sh->getQualities(&(e[start]), bn, q);
+    for (size_t i = 0; i < bn; ++i)
+      if (q[i] < qualityToBeat)
+        return true;
   }
   return false;
 }
@@ -370,6 +544,31 @@ double measureQuadraticTetQuality(Mesh* m, Entity* tet)
   return measureQuadraticTetQuality(xyz);
 }
 
+/* the linear part of the quadratic measure runs batched,
+   only the tets that pass it go through the Bezier check */
+void measureQuadraticTetQualities(Mesh* m, Entity** tets, size_t n,
+    double* q)
+{
+  measureLinearTetQualities(m, tets, n, q);
+  for (size_t i = 0; i < n; ++i) {
+    if (q[i] <= 0)
+      continue;
+    Vector xyz[10];
+    Entity* v[4];
+    m->getDownward(tets[i],0,v);
+    for (int j = 0; j < 4; ++j)
+      m->getPoint(v[j],0,xyz[j]);
+    Entity* e[6];
+    m->getDownward(tets[i],1,e);
+    for (int j = 0; j < 6; ++j)
+      m->getPoint(e[j],0,xyz[4 + j]);
+    convertQuadraticTetToBezier(xyz);
+    double qq = measureBezierTetQuality(xyz);
+    if (qq <= 0)
+      q[i] = qq;
+  }
+}
+
 static int unrotate_prism_diagonal_code(int code, int rot)
 {
   static int const shift_table[6] = {0,1,2,2,0,1};
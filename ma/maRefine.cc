@@ -18,8 +18,12 @@
 #include "maShapeHandler.h"
 #include "maSnap.h"
 #include "maLayer.h"
+#include "maBalance.h"
 #include <apf.h>
 #include <pcu_util.h>
+#include <algorithm>
+#include <cfloat>
+#include <vector>
 
 namespace ma {
 
@@ -402,6 +406,204 @@ void cleanupAfter(Refine* r)
   forgetNewEntities(r);
 }
 
+static void splitMarkedEdges(Refine* r)
+{
+  resetCollection(r);
+  collectForTransfer(r);
+  collectForMatching(r);
+  setupRefineForLayer(r);
+  addAllMarkedEdges(r);
+  splitElements(r);
+  processNewElements(r);
+  destroySplitElements(r);
+  forgetNewEntities(r);
+}
+
+/* batches are contiguous ranges of a Morton curve over the
+   global bounding box, which keeps each batch spatially compact.
+   ties on the curve are broken by the edge centroids, so the
+   order is total and all copies of a shared edge compare equal
+   on every part and fall in the same batch */
+struct BatchKey
+{
+  size_t morton;
+  double x[3];
+  bool operator<(BatchKey const& other) const
+  {
+    if (morton != other.morton)
+      return morton < other.morton;
+    for (int i = 0; i < 3; ++i)
+      if (x[i] != other.x[i])
+        return x[i] < other.x[i];
+    return false;
+  }
+};
+
+static BatchKey makeBatchKey(size_t morton, double x)
+{
+  BatchKey k;
+  k.morton = morton;
+  for (int i = 0; i < 3; ++i)
+    k.x[i] = x;
+  return k;
+}
+
+/* the smallest key over all parts, one coordinate at a time */
+static BatchKey getGlobalMin(BatchKey k)
+{
+  BatchKey m;
+  m.morton = PCU_Min_SizeT(k.morton);
+  bool tied = (k.morton == m.morton);
+  for (int i = 0; i < 3; ++i) {
+    m.x[i] = PCU_Min_Double(tied ? k.x[i] : DBL_MAX);
+    tied = tied && (k.x[i] == m.x[i]);
+  }
+  return m;
+}
+
+struct BatchEdge
+{
+  BatchKey key;
+  long elements;
+  Entity* edge;
+  bool operator<(BatchEdge const& other) const
+  {
+    return key < other.key;
+  }
+};
+
+static size_t spreadBits(size_t x)
+{
+  size_t r = 0;
+  for (int i = 0; i < 21; ++i)
+    r |= ((x >> i) & 1) << (3 * i);
+  return r;
+}
+
+static size_t getMortonKey(Vector const& p, double lo[3], double hi[3])
+{
+  size_t key = 0;
+  for (int i = 0; i < 3; ++i) {
+    double w = hi[i] - lo[i];
+    double t = (w > 0) ? ((p[i] - lo[i]) / w) : 0;
+    size_t c = static_cast<size_t>(t * ((1 << 21) - 1));
+    key |= spreadBits(c) << i;
+  }
+  return key;
+}
+
+static void getBoundingBox(Mesh* m, double lo[3], double hi[3])
+{
+  for (int i = 0; i < 3; ++i) {
+    lo[i] = DBL_MAX;
+    hi[i] = -DBL_MAX;
+  }
+  Iterator* it = m->begin(0);
+  Entity* v;
+  while ((v = m->iterate(it))) {
+    Vector p = getPosition(m, v);
+    for (int i = 0; i < 3; ++i) {
+      lo[i] = std::min(lo[i], p[i]);
+      hi[i] = std::max(hi[i], p[i]);
+    }
+  }
+  m->end(it);
+  PCU_Min_Doubles(lo, 3);
+  PCU_Max_Doubles(hi, 3);
+}
+
+static void getMarkedEdges(Adapt* a, double lo[3], double hi[3],
+    std::vector<BatchEdge>& edges)
+{
+  Mesh* m = a->mesh;
+  edges.clear();
+  Iterator* it = m->begin(1);
+  Entity* e;
+  while ((e = m->iterate(it))) {
+    if ( ! getFlag(a, e, SPLIT))
+      continue;
+    BatchEdge be;
+    Vector c = getLinearCentroid(m, e);
+    be.key.morton = getMortonKey(c, lo, hi);
+    for (int i = 0; i < 3; ++i)
+      be.key.x[i] = c[i];
+    apf::Adjacent elements;
+    m->getAdjacent(e, m->getDimension(), elements);
+    be.elements = elements.getSize();
+    be.edge = e;
+    edges.push_back(be);
+  }
+  m->end(it);
+  std::sort(edges.begin(), edges.end());
+}
+
+/* the largest key this part can take without splitting more than
+   the budget of elements, counting elements once per split edge */
+static BatchKey getBatchLimit(Adapt* a, std::vector<BatchEdge>& edges)
+{
+  long budget = a->input->maximumSplitElements;
+  long total = 0;
+  for (size_t i = 0; i < edges.size(); ++i) {
+    total += edges[i].elements;
+    if (total > budget)
+      return i ? edges[i - 1].key : makeBatchKey(0, -DBL_MAX);
+  }
+  return makeBatchKey(static_cast<size_t>(-1), DBL_MAX);
+}
+
+static BatchKey getFirstKey(std::vector<BatchEdge>& edges)
+{
+  if (edges.empty())
+    return makeBatchKey(static_cast<size_t>(-1), DBL_MAX);
+  return edges[0].key;
+}
+
+static int refineInBatches(Adapt* a)
+{
+  Refine* r = a->refine;
+  double lo[3], hi[3];
+  getBoundingBox(a->mesh, lo, hi);
+  std::vector<BatchEdge> edges;
+  std::vector<Entity*> deferred;
+  int batches = 0;
+  while (true) {
+    getMarkedEdges(a, lo, hi, edges);
+    if ( ! PCU_Add_Long(edges.size()))
+      break;
+    BatchKey limit = getGlobalMin(getBatchLimit(a, edges));
+    /* an edge touching more elements than the budget can not be
+       split in pieces, so when no part can take its first edge
+       the batch is the first edge on the curve by itself */
+    BatchKey first = getGlobalMin(getFirstKey(edges));
+    if (limit < first)
+      limit = first;
+    deferred.clear();
+    for (size_t i = 0; i < edges.size(); ++i)
+      if (limit < edges[i].key) {
+        clearFlag(a, edges[i].edge, SPLIT);
+        deferred.push_back(edges[i].edge);
+      }
+    splitMarkedEdges(r);
+    ++batches;
+    /* unsplit edges survive as edges of the new elements */
+    for (size_t i = 0; i < deferred.size(); ++i)
+      setFlag(a, deferred[i], SPLIT);
+    if ( ! PCU_Add_Long(deferred.size()))
+      break;
+    batchBalance(a);
+  }
+  return batches;
+}
+
+static bool shouldRefineInBatches(Adapt* a)
+{
+  /* layer templates and matched edges need all their
+     marked edges to be split at once */
+  return a->input->maximumSplitElements > 0
+      && ( ! a->hasLayer)
+      && ( ! a->input->shouldHandleMatching);
+}
+
 bool refine(Adapt* a)
 {
   double t0 = PCU_Time();
@@ -413,16 +615,10 @@ bool refine(Adapt* a)
     return false;
   }
   PCU_ALWAYS_ASSERT(checkFlagConsistency(a,1,SPLIT));
-  Refine* r = a->refine;
-  resetCollection(r);
-  collectForTransfer(r);
-  collectForMatching(r);
-  setupRefineForLayer(r);
-  addAllMarkedEdges(r);
-  splitElements(r);
-  processNewElements(r);
-  destroySplitElements(r);
-  forgetNewEntities(r);
+  if (shouldRefineInBatches(a))
+    print("split edges in %d batches", refineInBatches(a));
+  else
+    splitMarkedEdges(a->refine);
   double t1 = PCU_Time();
   print("refined %li edges in %f seconds",count,t1-t0);
   resetLayer(a);
@@ -17,6 +17,7 @@
 #include "maShortEdgeRemover.h"
 #include "maShapeHandler.h"
 #include <pcu_util.h>
+#include <algorithm>
 
 namespace ma {
 
@@ -99,13 +100,20 @@ double getMinQuality(Adapt* a)
   Iterator* it = m->begin(m->getDimension());
   Entity* e;
   double minqual = 1;
-  while ((e = m->iterate(it))) {
-    if (!apf::isSimplex(m->getType(e)))
-      continue;
-    double qual = a->shape->getQuality(e);
-    if (qual < minqual)
-      minqual = qual;
-  }
+  Entity* batch[QUALITY_BATCH_SIZE];
+  double q[QUALITY_BATCH_SIZE];
+  size_t n = 0;
+  do {
+    e = m->iterate(it);
+    if (e && apf::isSimplex(m->getType(e)))
+      batch[n++] = e;
+    if (n == QUALITY_BATCH_SIZE || (n && ! e)) {
+      a->shape->getQualities(batch, n, q);
+      for (size_t i = 0; i < n; ++i)
+        minqual = std::min(minqual, q[i]);
+      n = 0;
+    }
+  } while (e);
   m->end(it);
   return PCU_Min_Double(minqual);
 }
@@ -32,6 +32,20 @@ double measureElementQuality(Mesh* m, SizeField* f, Entity* e);
 double measureLinearTetQuality(Vector xyz[4]);
 double measureQuadraticTetQuality(Mesh* m, Entity* tet);
 
+/* batched versions of the measures above.
+ * vertex coordinates and metric transforms of up to
+ * QUALITY_BATCH_SIZE elements are gathered into contiguous
+ * buffers and measured together, the results go in q[0..n-1].
+ * the linear measures assume straight-sided elements
+ * and fall back to the per-element ones otherwise.
+ */
+enum { QUALITY_BATCH_SIZE = 64 };
+void measureElementQualities(Mesh* m, SizeField* f,
+    Entity** e, size_t n, double* q);
+void measureLinearTetQualities(Mesh* m, Entity** tets, size_t n, double* q);
+void measureQuadraticTetQualities(Mesh* m, Entity** tets, size_t n,
+    double* q);
+
 double getWorstQuality(Adapt* a, EntityArray& e);
 double getWorstQuality(Adapt* a, Entity** e, size_t n);
 
@@ -16,6 +16,12 @@
 
 namespace ma {
 
+void ShapeHandler::getQualities(Entity** e, size_t n, double* q)
+{
+  for (size_t i = 0; i < n; ++i)
+    q[i] = getQuality(e[i]);
+}
+
 class LinearHandler : public ShapeHandler
 {
   public:
@@ -28,6 +34,10 @@ class LinearHandler : public ShapeHandler
     {
       return measureElementQuality(mesh, sizeField, e);
     }
+    virtual void getQualities(Entity** e, size_t n, double* q)
+    {
+      measureElementQualities(mesh, sizeField, e, n, q);
+    }
     virtual bool hasNodesOn(int dimension)
     {
       return dimension == 0;
@@ -63,6 +73,12 @@ class QuadraticHandler : public ShapeHandler
       PCU_ALWAYS_ASSERT( mesh->getType(e) == apf::Mesh::TET );
       return measureQuadraticTetQuality(mesh,e);
     }
+    virtual void getQualities(Entity** e, size_t n, double* q)
+    {
+      for (size_t i = 0; i < n; ++i)
+        PCU_ALWAYS_ASSERT( mesh->getType(e[i]) == apf::Mesh::TET );
+      measureQuadraticTetQualities(mesh,e,n,q);
+    }
     virtual bool hasNodesOn(int dimension)
     {
       return st->hasNodesOn(dimension);
@@ -11,6 +11,8 @@ class ShapeHandler : public SolutionTransfer
 {
   public:
     virtual double getQuality(Entity* e) = 0;
+    /* fills q[0..n-1], by default one getQuality call per entity */
+    virtual void getQualities(Entity** e, size_t n, double* q);
 };
 
 ShapeHandler* getShapeHandler(Adapt* a);
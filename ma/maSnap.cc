@@ -17,6 +17,8 @@
 #include <apfGeometry.h>
 #include <pcu_util.h>
 #include <iostream>
+#include <map>
+#include <vector>
 
 namespace ma {
 
@@ -79,11 +81,14 @@ void interpolateParametricCoordinates(
     Vector const& b,
     Vector& p)
 {
-  double range[2];
+  /* the periodic ranges are looked up once and reused by the retry */
+  double range[2][2];
+  bool isPeriodic[2];
   int dim = m->getModelType(g);
   for (int d=0; d < dim; ++d) {
-    bool isPeriodic = m->getPeriodicRange(g,d,range);
-    p[d] = interpolateParametricCoordinate(t,a[d],b[d],range,isPeriodic, 0);
+    isPeriodic[d] = m->getPeriodicRange(g,d,range[d]);
+    p[d] = interpolateParametricCoordinate(
+        t,a[d],b[d],range[d],isPeriodic[d], 0);
   }
 
   /* check if the new point is inside the model.
@@ -104,10 +109,9 @@ void interpolateParametricCoordinates(
   if (ok)
     return;
 
-  for (int d=0; d < dim; ++d) {
-    bool isPeriodic = m->getPeriodicRange(g,d,range);
-    p[d] = interpolateParametricCoordinate(t,a[d],b[d],range,isPeriodic, 1);
-  }
+  for (int d=0; d < dim; ++d)
+    p[d] = interpolateParametricCoordinate(
+        t,a[d],b[d],range[d],isPeriodic[d], 1);
 }
 
 static void transferParametricBetween(
@@ -153,13 +157,38 @@ void transferParametricOnQuadSplit(
   ma::transferParametricBetween(m, g, v, y, p);
 }
 
-static void getSnapPoint(Mesh* m, Entity* v, Vector& x)
+/* snap targets are evaluated one model entity at a time so that
+   geometry kernels with a batched evaluator can amortize the queries.
+   every vertex classified on a model vertex snaps to the same point,
+   so that point is evaluated once and reused. */
+typedef std::map<Model*, std::vector<Entity*> > SnapGroups;
+
+static void groupVertsToSnap(Mesh* m, SnapGroups& groups)
 {
-  m->getPoint(v,0,x);
-  Vector p;
-  m->getParam(v,p);
-  Model* g = m->toModel(v);
-  m->snapToModel(g,p,x);
+  int dim = m->getDimension();
+  Entity* v;
+  Iterator* it = m->begin(0);
+  while ((v = m->iterate(it))) {
+    Model* g = m->toModel(v);
+    if (m->getModelType(g) == dim)
+      continue;
+    groups[g].push_back(v);
+  }
+  m->end(it);
+}
+
+static void getSnapPoints(Mesh* m, Model* g,
+    std::vector<Entity*> const& verts, std::vector<Vector>& x)
+{
+  size_t n = verts.size();
+  if (m->getModelType(g) == 0)
+    n = 1;
+  std::vector<Vector> p(n);
+  for (size_t i = 0; i < n; ++i)
+    m->getParam(verts[i], p[i]);
+  x.resize(n);
+  m->snapToModel(g, n, &p[0], &x[0]);
+  x.resize(verts.size(), x[0]);
 }
 
 class SnapAll : public Operator
@@ -206,25 +235,24 @@ class SnapAll : public Operator
 long tagVertsToSnap(Adapt* a, Tag*& t)
 {
   Mesh* m = a->mesh;
-  int dim = m->getDimension();
   t = m->createDoubleTag("ma_snap", 3);
-  Entity* v;
+  SnapGroups groups;
+  groupVertsToSnap(m, groups);
   long n = 0;
-  Iterator* it = m->begin(0);
-  while ((v = m->iterate(it))) {
-    int md = m->getModelType(m->toModel(v));
-    if (md == dim)
-      continue;
-    Vector s;
-    getSnapPoint(m, v, s);
-    Vector x = getPosition(m, v);
-    if (apf::areClose(s, x, 0.0))
-      continue;
-    m->setDoubleTag(v, t, &s[0]);
-    if (m->isOwned(v))
-      ++n;
+  std::vector<Vector> s;
+  APF_ITERATE(SnapGroups, groups, git) {
+    std::vector<Entity*>& verts = git->second;
+    getSnapPoints(m, git->first, verts, s);
+    for (size_t i = 0; i < verts.size(); ++i) {
+      Entity* v = verts[i];
+      Vector x = getPosition(m, v);
+      if (apf::areClose(s[i], x, 0.0))
+        continue;
+      m->setDoubleTag(v, t, &s[i][0]);
+      if (m->isOwned(v))
+        ++n;
+    }
   }
-  m->end(it);
   return PCU_Add_Long(n);
 }
 
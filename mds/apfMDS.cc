@@ -676,6 +676,14 @@ class MeshMDS : public Mesh2
       };
       return table[type];
     }
+    int getTypeIndex(MeshEntity* e)
+    {
+      return mds_index(fromEnt(e));
+    }
+    int countTypeIndices(int type)
+    {
+      return mesh->mds.end[apf2mds(type)];
+    }
     mds_apf* mesh;
     PM parts;
     bool isMatched;
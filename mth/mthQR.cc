@@ -183,6 +183,85 @@ bool solveQR(Matrix<T,M,N> const& a,
 template bool solveQR(Matrix<double,0,0> const& a, Vector<double,0> const& b,
     Vector<double,0>& x);
 
+/* the reflector for column k is H = I - tau v v^T with
+   v = (1, a(k+1,k), ..., a(m-1,k)), as in LAPACK's geqrf */
+template <unsigned N>
+unsigned decomposeHouseholder(unsigned m, double* a, double* tau)
+{
+  PCU_ALWAYS_ASSERT(m >= N);
+  unsigned rank = 0;
+  for (unsigned k = 0; k < N; ++k) {
+    double* ak = a + k * m;
+    double cnorm = 0;
+    for (unsigned i = k; i < m; ++i)
+      cnorm += square(ak[i]);
+    cnorm = sqrt(cnorm);
+    if (cnorm < 1e-10) {
+      tau[k] = 0;
+      continue;
+    }
+    ++rank;
+    double diagonal = -sign(ak[k]) * cnorm;
+    double v0 = ak[k] - diagonal;
+    double vnorm = 1;
+    for (unsigned i = k + 1; i < m; ++i) {
+      ak[i] /= v0;
+      vnorm += square(ak[i]);
+    }
+    tau[k] = 2 / vnorm;
+    ak[k] = diagonal;
+    for (unsigned j = k + 1; j < N; ++j) {
+      double* aj = a + j * m;
+      double dot = aj[k];
+      for (unsigned i = k + 1; i < m; ++i)
+        dot += ak[i] * aj[i];
+      dot *= tau[k];
+      aj[k] -= dot;
+      for (unsigned i = k + 1; i < m; ++i)
+        aj[i] -= dot * ak[i];
+    }
+  }
+  return rank;
+}
+
+template <unsigned N>
+void solveHouseholder(unsigned m, double const* a, double const* tau,
+    double* b, double* x)
+{
+  for (unsigned k = 0; k < N; ++k) {
+    if (!tau[k])
+      continue;
+    double const* ak = a + k * m;
+    double dot = b[k];
+    for (unsigned i = k + 1; i < m; ++i)
+      dot += ak[i] * b[i];
+    dot *= tau[k];
+    b[k] -= dot;
+    for (unsigned i = k + 1; i < m; ++i)
+      b[i] -= dot * ak[i];
+  }
+  for (unsigned ii = 0; ii < N; ++ii) {
+    unsigned i = N - ii - 1;
+    x[i] = b[i];
+    for (unsigned j = i + 1; j < N; ++j)
+      x[i] -= a[j * m + i] * x[j];
+    x[i] /= a[i * m + i];
+  }
+}
+
+#define MTH_HOUSEHOLDER(N) \
+template unsigned decomposeHouseholder<N>(unsigned m, double* a, \
+    double* tau); \
+template void solveHouseholder<N>(unsigned m, double const* a, \
+    double const* tau, double* b, double* x);
+MTH_HOUSEHOLDER(1)
+MTH_HOUSEHOLDER(2)
+MTH_HOUSEHOLDER(3)
+MTH_HOUSEHOLDER(4)
+MTH_HOUSEHOLDER(6)
+MTH_HOUSEHOLDER(10)
+#undef MTH_HOUSEHOLDER
+
 template <class T, unsigned M>
 void reduceToHessenberg(Matrix<T,M,M> const& a, Matrix<T,M,M>& q,
     Matrix<T,M,M>& h)
@@ -58,6 +58,39 @@ template <class T, unsigned M, unsigned N>
 bool solveQR(Matrix<T,M,N> const& a,
     Vector<T,M> const& b, Vector<T,N>& x);
 
+/** \brief finds the QR decomposition of A in place, without forming Q
+  * \details this is meant for least squares fits with many rows and
+  *          few columns, where forming the MxM Q of decomposeQR
+  *          dominates the cost.
+  *          A is stored by columns, column j starting at a + j*m.
+  *          On return its upper triangle holds R, and below the
+  *          diagonal of column k are the Householder vector entries
+  *          after its leading one, with their scale in tau[k].
+  *          Columns whose norm is below the decomposeQR threshold are
+  *          left unreflected, with tau[k] = 0.
+  *          N = 1, 2, 3, 4, 6 and 10 are explicitly instantiated,
+  *          the term counts of linear and quadratic polynomials
+  * \param m the number of rows (m >= N)
+  * \param a the column-major mxN matrix, overwritten
+  * \param tau the N reflector scales
+  * \returns the rank of A
+  */
+template <unsigned N>
+unsigned decomposeHouseholder(unsigned m, double* a, double* tau);
+
+/** \brief solves the least squares problem Ax = b
+  *        given the output of decomposeHouseholder
+  * \details b is overwritten by Q^T b
+  * \param m the number of rows
+  * \param a the factored column-major mxN matrix
+  * \param tau the N reflector scales
+  * \param b the m right hand side entries, overwritten
+  * \param x the N output solution entries
+  */
+template <unsigned N>
+void solveHouseholder(unsigned m, double const* a, double const* tau,
+    double* b, double* x);
+
 template <class T, unsigned M>
 void reduceToHessenberg(Matrix<T,M,M> const& a, Matrix<T,M,M>& q,
     Matrix<T,M,M>& h);
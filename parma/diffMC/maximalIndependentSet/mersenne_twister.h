@@ -1,7 +0,0 @@
-#ifndef MERSENNE_TWISTER_H
-#define MERSENNE_TWISTER_H
-
-void mersenne_twister_seed(unsigned seed);
-unsigned mersenne_twister(void);
-
-#endif
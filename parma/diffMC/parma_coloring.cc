@@ -0,0 +1,280 @@
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parma_coloring.h"
+#include <algorithm>
+
+namespace parma {
+  static bool operator<(GraphVertex const& a, GraphVertex const& b) {
+    if (a.part != b.part)
+      return a.part < b.part;
+    return a.index < b.index;
+  }
+
+  static bool operator==(GraphVertex const& a, GraphVertex const& b) {
+    return a.part == b.part && a.index == b.index;
+  }
+
+  void makeDistGraph(int n,
+      std::vector<std::pair<int, GraphVertex> >& edges, DistGraph& g) {
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    g.offsets.assign(n + 1, 0);
+    g.adjacency.resize(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+      PCU_ALWAYS_ASSERT(edges[i].first < n);
+      ++g.offsets[edges[i].first + 1];
+      g.adjacency[i] = edges[i].second;
+    }
+    for (int i = 0; i < n; ++i)
+      g.offsets[i + 1] += g.offsets[i];
+  }
+
+  void makeSymmetric(DistGraph& g) {
+    const int self = PCU_Comm_Self();
+    const int n = g.count();
+    std::vector<std::pair<int, GraphVertex> > edges;
+    PCU_Comm_Begin();
+    for (int i = 0; i < n; ++i)
+      for (int j = g.offsets[i]; j < g.offsets[i + 1]; ++j) {
+        GraphVertex u = g.adjacency[j];
+        edges.push_back(std::make_pair(i, u));
+        if (u.part == self) {
+          GraphVertex v = {self, i};
+          edges.push_back(std::make_pair(u.index, v));
+        } else {
+          PCU_COMM_PACK(u.part, u.index);
+          PCU_COMM_PACK(u.part, i);
+        }
+      }
+    PCU_Comm_Send();
+    while (PCU_Comm_Receive()) {
+      int i;
+      GraphVertex v;
+      v.part = PCU_Comm_Sender();
+      PCU_COMM_UNPACK(i);
+      PCU_COMM_UNPACK(v.index);
+      edges.push_back(std::make_pair(i, v));
+    }
+    makeDistGraph(n, edges, g);
+  }
+
+  namespace {
+    enum { UNDECIDED = -1 };
+
+    unsigned long getPriority(GraphVertex const& v, unsigned seed) {
+      unsigned long x = static_cast<unsigned long>(
+          static_cast<unsigned>(v.part)) << 32;
+      x |= static_cast<unsigned>(v.index);
+      x ^= seed * 0x9e3779b97f4a7c15UL;
+      x ^= x >> 30;
+      x *= 0xbf58476d1ce4e5b9UL;
+      x ^= x >> 27;
+      x *= 0x94d049bb133111ebUL;
+      x ^= x >> 31;
+      return x;
+    }
+
+    /* decides the state of every vertex, the state of a vertex depends
+     * only on its neighbors. The states of neighbors on other parts are
+     * kept in a table sorted by vertex, filled as the parts holding them
+     * announce decisions. */
+    class Sweep {
+      public:
+        Sweep(DistGraph const& graph, unsigned seed)
+          : g(graph), self(PCU_Comm_Self()) {
+          const int n = g.count();
+          priority.resize(n);
+          for (int i = 0; i < n; ++i) {
+            GraphVertex v = {self, i};
+            priority[i] = getPriority(v, seed);
+          }
+          neighborPriority.resize(g.adjacency.size());
+          for (size_t j = 0; j < g.adjacency.size(); ++j) {
+            neighborPriority[j] = getPriority(g.adjacency[j], seed);
+            if (g.adjacency[j].part != self)
+              remotes.push_back(g.adjacency[j]);
+          }
+          std::sort(remotes.begin(), remotes.end());
+          remotes.erase(std::unique(remotes.begin(), remotes.end()),
+              remotes.end());
+          remoteStates.assign(remotes.size(), UNDECIDED);
+          slots.assign(g.adjacency.size(), -1);
+          for (size_t j = 0; j < g.adjacency.size(); ++j)
+            if (g.adjacency[j].part != self)
+              slots[j] = findRemote(g.adjacency[j]);
+          states.assign(n, UNDECIDED);
+          order.resize(n);
+          for (int i = 0; i < n; ++i)
+            order[i] = i;
+          std::sort(order.begin(), order.end(), ByPriority(priority));
+        }
+        virtual ~Sweep() {}
+        std::vector<int> const& run() {
+          while (true) {
+            sweep();
+            exchange();
+            if (!PCU_Add_Int(static_cast<int>(order.size())))
+              break;
+          }
+          return states;
+        }
+      protected:
+        DistGraph const& g;
+        const int self;
+        virtual bool decide(int i) = 0;
+        int getState(int j) {
+          GraphVertex const& u = g.adjacency[j];
+          if (u.part == self)
+            return states[u.index];
+          return remoteStates[slots[j]];
+        }
+        /* true if the j'th adjacency entry of vertex i goes first */
+        bool isBefore(int i, int j) {
+          if (neighborPriority[j] != priority[i])
+            return neighborPriority[j] > priority[i];
+          GraphVertex v = {self, i};
+          return v < g.adjacency[j];
+        }
+        std::vector<int> states;
+      private:
+        struct ByPriority {
+          ByPriority(std::vector<unsigned long> const& p) : priority(p) {}
+          bool operator()(int a, int b) const {
+            if (priority[a] != priority[b])
+              return priority[a] > priority[b];
+            return a < b;
+          }
+          std::vector<unsigned long> const& priority;
+        };
+        std::vector<unsigned long> priority;
+        std::vector<unsigned long> neighborPriority;
+        std::vector<GraphVertex> remotes;
+        std::vector<int> remoteStates;
+        std::vector<int> slots;
+        std::vector<int> order;
+        std::vector<int> decided;
+        int findRemote(GraphVertex const& v) {
+          std::vector<GraphVertex>::iterator it =
+            std::lower_bound(remotes.begin(), remotes.end(), v);
+          PCU_ALWAYS_ASSERT(it != remotes.end() && *it == v);
+          return static_cast<int>(it - remotes.begin());
+        }
+        /* dependencies point from higher to lower priority, so one pass
+           in priority order decides every vertex whose dependencies on
+           other parts are already known */
+        void sweep() {
+          size_t kept = 0;
+          for (size_t k = 0; k < order.size(); ++k) {
+            int i = order[k];
+            if (!decide(i)) {
+              order[kept++] = i;
+              continue;
+            }
+            for (int j = g.offsets[i]; j < g.offsets[i + 1]; ++j)
+              if (g.adjacency[j].part != self) {
+                decided.push_back(i);
+                break;
+              }
+          }
+          order.resize(kept);
+        }
+        void exchange() {
+          std::vector<int> peers;
+          PCU_Comm_Begin();
+          for (size_t k = 0; k < decided.size(); ++k) {
+            int i = decided[k];
+            peers.clear();
+            for (int j = g.offsets[i]; j < g.offsets[i + 1]; ++j)
+              if (g.adjacency[j].part != self)
+                peers.push_back(g.adjacency[j].part);
+            std::sort(peers.begin(), peers.end());
+            peers.erase(std::unique(peers.begin(), peers.end()),
+                peers.end());
+            for (size_t p = 0; p < peers.size(); ++p) {
+              PCU_COMM_PACK(peers[p], i);
+              PCU_COMM_PACK(peers[p], states[i]);
+            }
+          }
+          decided.clear();
+          PCU_Comm_Send();
+          while (PCU_Comm_Receive()) {
+            GraphVertex v;
+            v.part = PCU_Comm_Sender();
+            int state;
+            PCU_COMM_UNPACK(v.index);
+            PCU_COMM_UNPACK(state);
+            remoteStates[findRemote(v)] = state;
+          }
+        }
+    };
+
+    class ColorSweep : public Sweep {
+      public:
+        ColorSweep(DistGraph const& graph, unsigned seed)
+          : Sweep(graph, seed) {}
+      private:
+        std::vector<int> used;
+        bool decide(int i) {
+          used.clear();
+          for (int j = g.offsets[i]; j < g.offsets[i + 1]; ++j) {
+            int s = getState(j);
+            if (s == UNDECIDED && isBefore(i, j))
+              return false;
+            if (s != UNDECIDED)
+              used.push_back(s);
+          }
+          std::sort(used.begin(), used.end());
+          int color = 0;
+          for (size_t k = 0; k < used.size() && used[k] <= color; ++k)
+            if (used[k] == color)
+              ++color;
+          states[i] = color;
+          return true;
+        }
+    };
+
+    enum { OUT, IN };
+
+    class IndependentSetSweep : public Sweep {
+      public:
+        IndependentSetSweep(DistGraph const& graph, unsigned seed)
+          : Sweep(graph, seed) {}
+      private:
+        bool decide(int i) {
+          bool waiting = false;
+          for (int j = g.offsets[i]; j < g.offsets[i + 1]; ++j) {
+            int s = getState(j);
+            if (s == IN) {
+              states[i] = OUT;
+              return true;
+            }
+            if (s == UNDECIDED && isBefore(i, j))
+              waiting = true;
+          }
+          if (waiting)
+            return false;
+          states[i] = IN;
+          return true;
+        }
+    };
+  }
+
+  int colorGraph(DistGraph const& g, std::vector<int>& colors,
+      unsigned seed) {
+    ColorSweep s(g, seed);
+    colors = s.run();
+    int count = 0;
+    for (size_t i = 0; i < colors.size(); ++i)
+      count = std::max(count, colors[i] + 1);
+    return PCU_Max_Int(count);
+  }
+
+  void getIndependentSet(DistGraph const& g, std::vector<bool>& inSet,
+      unsigned seed) {
+    IndependentSetSweep s(g, seed);
+    std::vector<int> const& states = s.run();
+    inSet.resize(states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      inSet[i] = (states[i] == IN);
+  }
+}
@@ -0,0 +1,51 @@
+#ifndef PARMA_COLORING_H_
+#define PARMA_COLORING_H_
+
+#include <vector>
+#include <utility>
+
+namespace parma {
+  /* a vertex of a distributed graph: the part holding it and its
+     index on that part */
+  struct GraphVertex {
+    int part;
+    int index;
+  };
+
+  /* the vertices held by one part in compressed sparse row form, the
+     neighbors of vertex i are adjacency[offsets[i]] up to
+     adjacency[offsets[i+1]] */
+  struct DistGraph {
+    std::vector<int> offsets;
+    std::vector<GraphVertex> adjacency;
+    int count() const {
+      return offsets.empty() ? 0 : static_cast<int>(offsets.size()) - 1;
+    }
+  };
+
+  /* builds the graph of n local vertices from (vertex, neighbor) pairs,
+     duplicate pairs are merged. edges is sorted */
+  void makeDistGraph(int n,
+      std::vector<std::pair<int, GraphVertex> >& edges, DistGraph& g);
+
+  /* adds the reverse of every edge that is missing it */
+  void makeSymmetric(DistGraph& g);
+
+  /* Jones-Plassmann coloring of a symmetric graph: a vertex takes the
+   * smallest color not used by its neighbors once all neighbors of
+   * higher priority are colored.  Each round sweeps the local vertices
+   * in priority order, so only dependencies between parts cost rounds.
+   * The vertices of color zero form a maximal independent set.
+   * Priorities are a hash of the vertex and the seed.
+   * Returns the number of colors over all parts. */
+  int colorGraph(DistGraph const& g, std::vector<int>& colors,
+      unsigned seed = 0);
+
+  /* maximal independent set of a symmetric graph, the same as the
+     color zero vertices of colorGraph with the same seed, but a vertex
+     drops out as soon as any neighbor joins */
+  void getIndependentSet(DistGraph const& g, std::vector<bool>& inSet,
+      unsigned seed = 0);
+}
+
+#endif
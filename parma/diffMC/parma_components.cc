@@ -1,4 +1,4 @@
-#include <list>
+#include <vector>
 #include <set>
 #include <algorithm>
 #include <pcu_util.h>
@@ -166,6 +166,7 @@ namespace parma {
     apf::MeshTag* lvlT = m->createIntTag("parmaWalkLevels",1);
     parma::Level cur;
     parma::Level next = *(getBdry(compId));
+    std::vector<apf::MeshEntity*> visited;
     int treeDepth = 0;
     while( ! next.empty() ) {
       cur = next;
@@ -175,6 +176,7 @@ namespace parma {
         apf::MeshEntity* v = *vtxItr;
         if( m->hasTag(v,lvlT) ) continue;
         m->setIntTag(v,lvlT,&treeDepth);
+        visited.push_back(v);
         apf::Adjacent adjVtx;
         getEdgeAdjVtx(m,v,adjVtx);
         APF_ITERATE(apf::Adjacent, adjVtx, vItr)
@@ -190,7 +192,8 @@ namespace parma {
       lvl->insert(*lItr); // (0)
     setDepth(compId, TO_UINT(treeDepth)); // (1)
 
-    apf::removeTagFromDimension(m,lvlT,0);
+    for(size_t i=0; i<visited.size(); i++)
+      m->removeTag(visited[i],lvlT);
     m->destroyTag(lvlT);
   }
 
@@ -219,13 +222,11 @@ namespace parma {
     int one = 1;
     apf::MeshTag* vtag = m->createIntTag("walkCompVisited",1);
 
-    std::list<apf::MeshEntity*> elms;
+    std::vector<apf::MeshEntity*> elms;
     elms.push_back(src);
-    while( ! elms.empty() ) {
-      apf::MeshEntity* elm = elms.front();
-      elms.pop_front();
-      if( m->hasTag(elm, vtag) ) continue;
-      m->setIntTag(elm, vtag, &one);
+    m->setIntTag(src, vtag, &one);
+    for(size_t i=0; i<elms.size(); i++) {
+      apf::MeshEntity* elm = elms[i];
       apf::Downward verts;
       const int nv = m->getDownward(elm, 0, verts);
       setElmVtxIds(verts, nv, comp);
@@ -235,11 +236,16 @@ namespace parma {
       APF_ITERATE(apf::Adjacent, adjElms, eit)
         if( ! isIsolated(*eit) &&
             (compId(*eit) == comp) &&
-            ! m->hasTag(*eit,vtag) )
+            ! m->hasTag(*eit,vtag) ) {
+          m->setIntTag(*eit, vtag, &one);
           elms.push_back(*eit);
+        }
     }
 
-    apf::removeTagFromDimension(m,vtag,m->getDimension());
+    // only the walked elements are tagged, clearing them keeps the
+    // walks of all components linear in the size of the part
+    for(size_t i=0; i<elms.size(); i++)
+      m->removeTag(elms[i],vtag);
     m->destroyTag(vtag);
   }
 
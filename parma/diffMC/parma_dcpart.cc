@@ -3,10 +3,8 @@
 #include "parma_commons.h"
 #include "parma_meshaux.h"
 #include "parma_convert.h"
-#include <maximalIndependentSet/mis.h>
 #include <stdio.h>
 #include <set>
-#include <list>
 #include <map>
 #include <pcu_util.h>
 
@@ -28,13 +26,8 @@ dcPart::~dcPart() {
 }
 
 apf::MeshEntity* dcPart::getSeedEnt(unsigned i) {
-  apf::MeshEntity* elm;
-  apf::MeshIterator* itr = m->begin(m->getDimension());
-  while( (elm = m->iterate(itr)) )
-    if( ! isIsolated(elm) && (compId(elm) == i ) )
-      break;
-  m->end(itr);
-  return elm;
+  PCU_ALWAYS_ASSERT( i < dcCompSeed.size());
+  return dcCompSeed[i];
 }
 
 unsigned dcPart::compId(apf::MeshEntity* e) {
@@ -47,21 +40,12 @@ bool dcPart::isIsolated(apf::MeshEntity* e) {
   return m->hasTag(e, isotag);
 }
 
-void dcPart::markIsolated(const unsigned dcComp) {
+void dcPart::markIsolated(Elements& elms) {
   int one = 1;
-  int tval = -1;
-  apf::MeshEntity* elm;
-  apf::MeshIterator* itr = m->begin(m->getDimension());
-  while( (elm = m->iterate(itr)) ) {
-    if( m->hasTag(elm, vtag) ) {
-      m->getIntTag(elm, vtag, &tval);
-      if( tval == TO_INT(dcComp) ) {
-        m->removeTag(elm, vtag); //clear the dc comp id
-        m->setIntTag(elm, isotag, &one);
-      }
-    }
+  for(size_t i=0; i<elms.size(); i++) {
+    m->removeTag(elms[i], vtag); //clear the dc comp id
+    m->setIntTag(elms[i], isotag, &one);
   }
-  m->end(itr);
 }
 
 unsigned dcPart::getNumComps() {
@@ -94,96 +78,84 @@ unsigned dcPart::getCompPeer(unsigned i) {
 void dcPart::reset() {
    dcCompSz.clear();
    dcCompNbor.clear();
+   dcCompSeed.clear();
    clearTag(m, vtag);
    clearTag(m, isotag);
    numIso = 0;
 }
 
+/* each component is labeled by a single breadth first walk that starts
+   from the first unlabeled element in iteration order, so the whole
+   part is labeled in one pass over the elements */
 unsigned dcPart::numDisconnectedComps() {
    double t1 = PCU_Time();
    reset();
    unsigned numDc = 0;
-   size_t count = 0;
    unsigned self = TO_UINT(m->getId());
-   const size_t numElms = m->count(m->getDimension());
-   while( count != numElms ) {
-      unsigned sz = walkPart(numDc);
-      unsigned nbor = maxContactNeighbor(numDc);
+   Elements elms;
+   apf::MeshEntity* elm;
+   apf::MeshIterator* itr = m->begin(m->getDimension());
+   while( (elm = m->iterate(itr)) ) {
+      if( m->hasTag(elm, vtag) || m->hasTag(elm, isotag) ) continue;
+      unsigned sz = walkPart(elm, numDc, elms);
+      unsigned nbor = maxContactNeighbor(elms);
       if( nbor != self || PCU_Comm_Peers() == 1 ) {
         dcCompSz.push_back(sz);
         dcCompNbor.push_back(nbor);
+        dcCompSeed.push_back(elm);
         numDc++;
       } else {
         numIso++;
-        markIsolated(numDc);
+        markIsolated(elms);
       }
-      count += sz;
    }
+   m->end(itr);
    if( verbose )
      parmaCommons::printElapsedTime(__func__, PCU_Time() - t1);
    PCU_ALWAYS_ASSERT(numDc+numIso >= 1);
    return (numDc+numIso)-1;
 }
 
-unsigned dcPart::walkPart(unsigned visited) {
-   unsigned count = 0;
-   const int dim = m->getDimension();
-
-   std::list<apf::MeshEntity*> elms;
-   apf::MeshEntity* elm;
-   // find an untagged element
-   apf::MeshIterator* itr = m->begin(dim);
-   while( (elm = m->iterate(itr)) &&
-          ( m->hasTag(elm, vtag) || m->hasTag(elm, isotag) ) );
-   m->end(itr);
-   // start the walk
-   PCU_ALWAYS_ASSERT(elm);
-   elms.push_back(elm);
-   while( ! elms.empty() ) {
-      elm = elms.front();
-      elms.pop_front();
-      PCU_ALWAYS_ASSERT( elm != NULL );
-      if ( m->hasTag(elm, vtag) || m->hasTag(elm, isotag) ) continue;
-      const int dcId = TO_INT(visited);
-      m->setIntTag(elm, vtag, &dcId);
-      count++;
+/* the element list doubles as the walk queue; elements are labeled when
+   they are queued so each one is visited exactly once */
+unsigned dcPart::walkPart(apf::MeshEntity* src, unsigned visited,
+    Elements& elms) {
+   const int dcId = TO_INT(visited);
+   elms.clear();
+   elms.push_back(src);
+   m->setIntTag(src, vtag, &dcId);
+   for(size_t i=0; i<elms.size(); i++) {
       apf::Adjacent adjElms;
-      getDwn2ndAdj(m, elm, adjElms);
+      getDwn2ndAdj(m, elms[i], adjElms);
       APF_ITERATE(apf::Adjacent, adjElms, eit)
-        if ( ! m->hasTag(*eit, vtag) )
+        if ( ! m->hasTag(*eit, vtag) && ! m->hasTag(*eit, isotag) ) {
+          m->setIntTag(*eit, vtag, &dcId);
           elms.push_back(*eit);
-      PCU_ALWAYS_ASSERT( count <= TO_UINT(m->count(dim)) );
+        }
    }
-   return count;
+   PCU_ALWAYS_ASSERT( elms.size() <= m->count(m->getDimension()) );
+   return TO_UINT(elms.size());
 }
 
 
-unsigned dcPart::maxContactNeighbor(const unsigned dcComp) {
+unsigned dcPart::maxContactNeighbor(Elements& elms) {
    // < dcComId, maxFace >
    muu bdryFaceCnt;
 
    const int dim = m->getDimension();
-   int tval;
    apf::Downward sides;
    apf::Parts resPid;
 
-   apf::MeshEntity* e;
-   apf::MeshIterator* itr = m->begin(dim);
-   while( (e = m->iterate(itr)) ) {
-      if( m->hasTag(e, vtag) ) {
-	 m->getIntTag(e, vtag, &tval);
-	 if( tval != TO_INT(dcComp) ) continue;
-         int ns = m->getDownward(e, dim-1, sides);
-         for(int sIdx=0; sIdx<ns; sIdx++) {
-           apf::MeshEntity* s = sides[sIdx];
-           if( ! m->isShared(s) ) continue;
-           m->getResidence(s, resPid);
-           APF_ITERATE(apf::Parts, resPid, rp)
-             (bdryFaceCnt[TO_UINT(*rp)])++;
-         }
+   for(size_t i=0; i<elms.size(); i++) {
+      int ns = m->getDownward(elms[i], dim-1, sides);
+      for(int sIdx=0; sIdx<ns; sIdx++) {
+        apf::MeshEntity* s = sides[sIdx];
+        if( ! m->isShared(s) ) continue;
+        m->getResidence(s, resPid);
+        APF_ITERATE(apf::Parts, resPid, rp)
+          (bdryFaceCnt[TO_UINT(*rp)])++;
       }
    }
-   m->end(itr);
    unsigned max = 0;
    unsigned maxId = TO_UINT(m->getId());
    unsigned self = maxId;
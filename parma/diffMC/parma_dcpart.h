@@ -23,13 +23,16 @@ class dcPart {
       void reset();
    private:
       dcPart() {}
-      unsigned walkPart(unsigned visited);
-      void markIsolated(const unsigned dcComp);
-      unsigned maxContactNeighbor(const unsigned dcComp);
+      typedef std::vector<apf::MeshEntity*> Elements;
+      unsigned walkPart(apf::MeshEntity* src, unsigned visited,
+          Elements& elms);
+      void markIsolated(Elements& elms);
+      unsigned maxContactNeighbor(Elements& elms);
 
       unsigned numIso;
       std::vector<unsigned> dcCompSz;
       std::vector<unsigned> dcCompNbor;
+      std::vector<apf::MeshEntity*> dcCompSeed;
       apf::MeshTag* vtag;
       apf::MeshTag* isotag;
       apf::Mesh* m;
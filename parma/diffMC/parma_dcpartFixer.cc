@@ -2,28 +2,26 @@
 #include "parma_dcpart.h"
 #include "parma_commons.h"
 #include "parma_convert.h"
-#include <maximalIndependentSet/mis.h>
+#include "parma_coloring.h"
 #include <pcu_util.h>
 
 typedef std::map<unsigned, unsigned> muu;
 
 namespace {
-  bool isInMis(muu& mt) {
-    unsigned seed = TO_UINT(PCU_Comm_Self()+1);
-    mis_init(seed);
-    misLuby::partInfo part;
-    part.id = PCU_Comm_Self();
-    std::set<int> targets;
+  /* parts that send components to each other are not both in the set,
+     so a part never receives elements while it is giving some away */
+  bool isInMis(muu& mt, unsigned seed) {
+    std::vector<std::pair<int,parma::GraphVertex> > edges;
     APF_ITERATE(muu, mt, mtItr) {
-      int peer = TO_INT(mtItr->second);
-      if( !targets.count(peer) ) {
-        part.adjPartIds.push_back(peer);
-        part.net.push_back(peer);
-        targets.insert(peer);
-      }
+      parma::GraphVertex v = {TO_INT(mtItr->second), 0};
+      edges.push_back(std::make_pair(0, v));
     }
-    part.net.push_back(part.id);
-    return mis(part,false,true);
+    parma::DistGraph g;
+    parma::makeDistGraph(1, edges, g);
+    parma::makeSymmetric(g);
+    std::vector<bool> inSet;
+    parma::getIndependentSet(g, inSet, seed);
+    return inSet[0];
   }
 }
 
@@ -81,7 +79,7 @@ class dcPartFixer::PartFixer : public dcPart {
             dcCompTgts[i] = getCompPeer(i);
         PCU_ALWAYS_ASSERT( dcCompTgts.size() == getNumComps()-1 );
         apf::Migration* plan = new apf::Migration(m);
-        if ( isInMis(dcCompTgts) )
+        if ( isInMis(dcCompTgts, TO_UINT(loop)) )
           setupPlan(dcCompTgts, plan);
 
         reset();
@@ -0,0 +1,108 @@
+#include <PCU.h>
+#include "parma_sides.h"
+#include "parma_weights.h"
+#include "parma_targets.h"
+#include <algorithm>
+#include <climits>
+
+namespace parma {
+  /* Targets from the diffusion solution over the part graph.
+   * A few damped Jacobi sweeps approximate the potential x of L x = b,
+   * where L is the Laplacian of the part graph and b is the weight above
+   * the average.  The flow x_self - x_peer across each side accounts for
+   * imbalance several hops away, so parts in the middle of a gradient
+   * forward weight in the same migration that they receive it.  If the
+   * sweeps converge the net flow leaving a part equals its surplus.
+   * They rarely converge, so the outflow is scaled down until the net
+   * flow is at most the surplus, and then by the step factor. */
+  class DiffusionTargets : public Targets {
+    public:
+      DiffusionTargets(Sides* s, Weights* w, int sideTol, double alpha,
+          int sweeps) {
+        init(s, w, sideTol, alpha, sweeps);
+      }
+      double total() {
+        return totW;
+      }
+    private:
+      DiffusionTargets();
+      double totW;
+      Associative<double> potential;
+      void exchange(Sides* s, double x) {
+        PCU_Comm_Begin();
+        const Sides::Item* side;
+        s->begin();
+        while( (side = s->iterate()) )
+          PCU_COMM_PACK(side->first, x);
+        s->end();
+        PCU_Comm_Send();
+        while (PCU_Comm_Listen()) {
+          double peerX;
+          PCU_COMM_UNPACK(peerX);
+          potential.set(PCU_Comm_Sender(), peerX);
+        }
+      }
+      double solve(Sides* s, double b, int sweeps) {
+        const double degree = s->size();
+        /* damping avoids the oscillation of plain Jacobi on
+           bipartite part graphs */
+        const double omega = 2.0/3.0;
+        double x = 0;
+        for (int i = 0; i < sweeps; ++i) {
+          exchange(s, x);
+          if (!degree)
+            continue;
+          double sum = 0;
+          const Sides::Item* side;
+          s->begin();
+          while( (side = s->iterate()) )
+            sum += potential.get(side->first);
+          s->end();
+          x = (1 - omega) * x + omega * (b + sum) / degree;
+        }
+        exchange(s, x);
+        return x;
+      }
+      void init(Sides* s, Weights* w, int sideTol, double alpha,
+          int sweeps) {
+        totW = 0;
+        const double avg = PCU_Add_Double(w->self()) / PCU_Comm_Peers();
+        const double surplus = w->self() - avg;
+        const double x = solve(s, surplus, sweeps);
+        double out = 0;
+        double in = 0;
+        const Sides::Item* side;
+        s->begin();
+        while( (side = s->iterate()) ) {
+          const double flow = x - potential.get(side->first);
+          if ( flow > 0 )
+            out += flow;
+          else
+            in -= flow;
+        }
+        s->end();
+        if ( out <= 0 )
+          return;
+        const double net = std::max(0.0, surplus + in);
+        const double scale = alpha * std::min(1.0, net / out);
+        s->begin();
+        while( (side = s->iterate()) ) {
+          const int peer = side->first;
+          const double flow = x - potential.get(peer);
+          if ( flow > 0 && side->second < sideTol ) {
+            set(peer, flow * scale);
+            totW += flow * scale;
+          }
+        }
+        s->end();
+      }
+  };
+  Targets* makeDiffusionTargets(Sides* s, Weights* w, double alpha,
+      int sweeps) {
+    return new DiffusionTargets(s, w, INT_MAX, alpha, sweeps);
+  }
+  Targets* makeDiffusionSideTargets(Sides* s, Weights* w, int sideTol,
+      double alpha, int sweeps) {
+    return new DiffusionTargets(s, w, sideTol, alpha, sweeps);
+  }
+} //end namespace
@@ -2,7 +2,8 @@
 #define PARMA_DISTQ_H_
 
 #include <apfMesh.h>
-#include <map>
+#include <limits.h>
+#include <vector>
 #include <pcu_util.h>
 
 namespace parma {
@@ -17,14 +18,24 @@ namespace parma {
     }
   };
 
+  /* entities are kept in a bucket per distance, indexed by the distance,
+   * and entities at INT_MAX in one more bucket that sorts after all of
+   * them. pop scans the buckets from the best distance queued so far.
+   * the tag holds the distance an entity is currently queued with; a
+   * push that changes the distance leaves the old entry behind and pop
+   * discards entries whose distance no longer matches the tag. the tag
+   * rather than an array indexed by entity is used since parma runs on
+   * any apf::Mesh. entities at equal distance are popped last in first
+   * out */
   template <class Compare> class DistanceQueue {
-    typedef typename std::multimap<int, apf::MeshEntity*, Compare> DistanceQ;
-    typedef typename DistanceQ::iterator DistanceQIter;
+    typedef std::vector<apf::MeshEntity*> Bucket;
 
     public:
-    DistanceQueue(apf::Mesh* mesh) : m(mesh)
+    DistanceQueue(apf::Mesh* mesh) : m(mesh), n(0)
     {
       t = m->createIntTag("parmaDistanceQueue",1);
+      ascending = Compare()(0, 1);
+      best = ascending ? INT_MAX : 0;
     }
 
     ~DistanceQueue()
@@ -35,53 +46,80 @@ namespace parma {
 
     void push(apf::MeshEntity* e, int dist)
     {
-      DistanceQIter it = q.begin();
+      PCU_ALWAYS_ASSERT( dist >= 0 );
       if ( m->hasTag(e, t) ) {
-        it = erase(dist, e);
+        int queued; m->getIntTag(e, t, &queued);
+        if ( queued == dist )
+          return;
+      } else {
+        n++;
       }
-      int one = 1;
-      m->setIntTag(e, t, &one);
-      q.insert(it, std::make_pair(dist, e));
+      m->setIntTag(e, t, &dist);
+      getBucket(dist).push_back(e);
+      if ( Compare()(dist, best) )
+        best = dist;
     }
 
     apf::MeshEntity* pop()
     {
-      DistanceQIter it;
-      it = q.begin();
-      apf::MeshEntity* e = it->second;
-      q.erase(it);
-      return e;
+      PCU_ALWAYS_ASSERT( n );
+      while( true ) {
+        Bucket& b = getBucket(best);
+        while( !b.empty() ) {
+          apf::MeshEntity* e = b.back();
+          b.pop_back();
+          int queued;
+          if( !m->hasTag(e, t) ) continue;
+          m->getIntTag(e, t, &queued);
+          if( queued != best ) continue;
+          m->removeTag(e, t);
+          n--;
+          return e;
+        }
+        best = getNext(best);
+      }
     }
 
     bool empty()
     {
-      return q.empty();
+      return !n;
     }
 
     size_t size()
     {
-      return q.size();
+      return n;
     }
 
     private:
     apf::Mesh* m;
     apf::MeshTag* t;
-    DistanceQ q;
+    size_t n;
+    bool ascending;
+    int best;
+    std::vector<Bucket> q;
+    Bucket far;
 
-    DistanceQIter erase(int dist, apf::MeshEntity* e)
+    Bucket& getBucket(int dist)
     {
-      PCU_ALWAYS_ASSERT( m->hasTag(e, t) );
-      DistanceQIter it = q.find(dist);
-      DistanceQIter rit = ( it != q.begin() ) ? it-- : q.end();
-      while( it != q.end() ) {
-        if( it->second == e ) {
-          q.erase(it);
-          break;
-        }
-        rit = it;
-        it++;
+      if ( dist == INT_MAX )
+        return far;
+      if ( static_cast<size_t>(dist) >= q.size() )
+        q.resize(dist + 1);
+      return q[dist];
+    }
+
+    /* the distance after (dist) in the order of Compare */
+    int getNext(int dist)
+    {
+      const int last = static_cast<int>(q.size()) - 1;
+      if ( ascending ) {
+        PCU_ALWAYS_ASSERT( dist != INT_MAX );
+        return dist < last ? dist + 1 : INT_MAX;
       }
-      return rit;
+      if ( dist == INT_MAX )
+        return last;
+      PCU_ALWAYS_ASSERT( dist > 0 );
+      return dist - 1;
     }
   };
 }
@@ -7,6 +7,7 @@
 #include "parma_targets.h"
 #include "parma_selector.h"
 #include "parma_commons.h"
+#include "parma_tracker.h"
 
 namespace {
   using parmaCommons::status;
@@ -14,21 +15,28 @@ namespace {
   class ElmBalancer : public parma::Balancer {
     private:
       double sideTol;
+      bool flow;
+      parma::Tracker* tracker;
     public:
-      ElmBalancer(apf::Mesh* m, double f, int v)
-        : Balancer(m, f, v, "elements") {
+      ElmBalancer(apf::Mesh* m, double f, int v, bool fl)
+        : Balancer(m, f, v, "elements"), flow(fl), tracker(0) {
           parma::Sides* s = parma::makeVtxSides(mesh);
           sideTol = parma::avgSharedSides(s);
           delete s;
       }
+      void balance(apf::MeshTag* wtag, double tolerance) {
+        tracker = new parma::Tracker(mesh, wtag, mesh->getDimension());
+        parma::Balancer::balance(wtag, tolerance);
+        delete tracker;
+      }
       bool runStep(apf::MeshTag* wtag, double tolerance) {
-        const double maxElmImb =
-          Parma_GetWeightedEntImbalance(mesh, wtag, mesh->getDimension());
-        parma::Sides* s = parma::makeVtxSides(mesh);
+        const double maxElmImb = tracker->getImbalance();
+        parma::Sides* s = tracker->makeVtxSides();
         double avgSides = parma::avgSharedSides(s);
-        parma::Weights* w =
-          parma::makeEntWeights(mesh, wtag, s, mesh->getDimension());
-        parma::Targets* t = parma::makeTargets(s, w, factor);
+        parma::Weights* w = tracker->makeEntWeights(s);
+        parma::Targets* t = flow ?
+          parma::makeDiffusionTargets(s, w, factor) :
+          parma::makeTargets(s, w, factor);
         parma::Selector* sel = parma::makeElmSelector(mesh, wtag);
 
         monitorUpdate(maxElmImb, iS, iA);
@@ -48,5 +56,12 @@ apf::Balancer* Parma_MakeElmBalancer(apf::Mesh* m,
     double stepFactor, int verbosity) {
   if( !PCU_Comm_Self() && verbosity )
     status("stepFactor %.3f\n", stepFactor);
-  return new ElmBalancer(m, stepFactor, verbosity);
+  return new ElmBalancer(m, stepFactor, verbosity, false);
+}
+
+apf::Balancer* Parma_MakeElmFlowBalancer(apf::Mesh* m,
+    double stepFactor, int verbosity) {
+  if( !PCU_Comm_Self() && verbosity )
+    status("stepFactor %.3f\n", stepFactor);
+  return new ElmBalancer(m, stepFactor, verbosity, true);
 }
@@ -52,6 +52,13 @@ namespace parma {
     weight = getWeight(m, w, entDim);
     init(m, w, s);
   }
+  EntWeights::EntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int d,
+      double selfW)
+    : Weights(m, w, s), entDim(d), weight(selfW)
+  {
+    PCU_ALWAYS_ASSERT(entDim >= 0 && entDim <= 3);
+    init(m, w, s);
+  }
   double EntWeights::self() {
     return weight;
   }
@@ -80,6 +87,10 @@ namespace parma {
   Weights* makeEntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int dim) {
     return new EntWeights(m, w, s, dim);
   }
+  Weights* makeEntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int dim,
+      double selfW) {
+    return new EntWeights(m, w, s, dim, selfW);
+  }
 
 
 } //end namespace
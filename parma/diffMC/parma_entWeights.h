@@ -5,6 +5,7 @@ namespace parma {
   class EntWeights : public Weights {
     public:
       EntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int d);
+      EntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int d, double selfW);
       double self();
     private:
       EntWeights();
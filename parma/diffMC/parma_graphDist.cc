@@ -7,8 +7,9 @@
 #include "parma_meshaux.h"
 #include "parma_convert.h"
 #include "parma_commons.h"
-#include <list>
+#include <map>
 #include <set>
+#include <vector>
 #include <limits.h>
 #include <stdlib.h>
 
@@ -226,23 +227,16 @@ namespace {
 } //end namespace
 
 namespace parma_ordering {
-  typedef std::list<apf::MeshEntity*> queue;
-
-  inline apf::MeshEntity* pop(queue& q) {
-    apf::MeshEntity* e = q.front();
-    PCU_ALWAYS_ASSERT(e);
-    q.pop_front();
-    return e;
-  }
+  typedef std::vector<apf::MeshEntity*> Verts;
 
   int bfs(apf::Mesh* m, parma::DijkstraContains* c,
        apf::MeshEntity* src, apf::MeshTag* order, int num) {
     if( !src )
       return num;
-    queue q;
+    Verts q;
     q.push_back(src);
-    while( !q.empty() ) {
-      apf::MeshEntity* v = pop(q);
+    for(size_t i=0; i<q.size(); i++) {
+      apf::MeshEntity* v = q[i];
       if( m->hasTag(v,order) ) continue;
       m->setIntTag(v,order,&num); num++;
       apf::Adjacent adjVtx;
@@ -256,34 +250,67 @@ namespace parma_ordering {
     return num;
   }
 
-  apf::MeshEntity* getMaxDistSeed(apf::Mesh* m, CompContains* c,
-      apf::MeshTag* dt, apf::MeshTag* order) {
-    int rmax = -1;
-    apf::MeshEntity* emax = NULL;
-    int cnt=0;
+  /**
+   * @brief collect the vertices of each component in iteration order
+   * @remark a vertex is in a component if it is assigned to it or is on
+   *   its boundary, see CompContains. Gathering them in one pass avoids
+   *   iterating over the whole part once per component.
+   */
+  void getCompVerts(apf::Mesh* m, parma::dcComponents& c,
+      std::vector<Verts>& verts) {
+    typedef std::map<apf::MeshEntity*, std::vector<unsigned> > BdryComps;
+    BdryComps bdry;
+    for(unsigned i=0; i<c.size(); i++) {
+      apf::MeshEntity* v;
+      c.beginBdry(i);
+      while( (v = c.iterateBdry()) )
+        bdry[v].push_back(i);
+      c.endBdry();
+    }
+    verts.assign(c.size(), Verts());
     apf::MeshIterator* it = m->begin(0);
     apf::MeshEntity* e;
     while( (e = m->iterate(it)) ) {
-      if( ! c->has(e) ) continue;
-      cnt++;
+      int id = -1;
+      if( c.has(e) ) {
+        id = TO_INT(c.getId(e));
+        verts[id].push_back(e);
+      }
+      BdryComps::iterator b = bdry.find(e);
+      if( b == bdry.end() ) continue;
+      APF_ITERATE(std::vector<unsigned>, b->second, i)
+        if( TO_INT(*i) != id )
+          verts[*i].push_back(e);
+    }
+    m->end(it);
+  }
+
+  apf::MeshEntity* getMaxDistSeed(apf::Mesh* m, Verts& verts,
+      apf::MeshTag* dt, apf::MeshTag* order) {
+    int rmax = -1;
+    apf::MeshEntity* emax = NULL;
+    for(size_t i=0; i<verts.size(); i++) {
+      apf::MeshEntity* e = verts[i];
       int d; m->getIntTag(e,dt,&d);
-      PCU_Debug_Print("cnt %d d %d hasTag %d\n", cnt, d, m->hasTag(e,order));
+      PCU_Debug_Print("cnt %lu d %d hasTag %d\n",
+          (unsigned long)(i+1), d, m->hasTag(e,order));
       if( !m->hasTag(e,order) && d > rmax ) {
         rmax = d;
         emax = e;
       }
     }
-    m->end(it);
     return emax;
   }
 
   apf::MeshTag* reorder(apf::Mesh* m, parma::dcComponents& c, apf::MeshTag* dist) {
     const unsigned check = c.getIdChecksum();
     apf::MeshTag* order = m->createIntTag("parma_ordering",1);
+    std::vector<Verts> verts;
+    getCompVerts(m,c,verts);
     int start = 0;
     for(int i=TO_INT(c.size())-1; i>=0; i--) {
       CompContains* contains = new CompContains(c,i);
-      apf::MeshEntity* src = getMaxDistSeed(m,contains,dist,order);
+      apf::MeshEntity* src = getMaxDistSeed(m,verts[i],dist,order);
       PCU_Debug_Print("comp %d starting vertex found? %d\n", i, (src != NULL));
       start = bfs(m, contains, src, order, start);
       PCU_ALWAYS_ASSERT(check == c.getIdChecksum());
@@ -22,6 +22,10 @@ namespace parma {
       double vtxTol, double alpha);
   Targets* makeElmLtVtxEdgeTargets(Sides* s, Weights* w[3], int sideTol,
       double vtxTol, double edgeTol, double alpha);
+  Targets* makeDiffusionTargets(Sides* s, Weights* w, double alpha,
+      int sweeps = 16);
+  Targets* makeDiffusionSideTargets(Sides* s, Weights* w, int sideTol,
+      double alpha, int sweeps = 16);
   Targets* makeShapeTargets(Sides* s);
   Targets* makeGhostTargets(Sides* s, Weights* w, Ghosts* g, double alpha);
 }
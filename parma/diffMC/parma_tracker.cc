@@ -0,0 +1,84 @@
+#include <PCU.h>
+#include "parma_tracker.h"
+#include "parma_sides.h"
+#include "parma_weights.h"
+#include <apf.h>
+#include <pcu_util.h>
+
+namespace parma {
+  class TrackedSides : public Sides {
+    public:
+      TrackedSides(apf::Mesh* m, std::map<int, int> const& s, int total)
+        : Sides(m) {
+        std::map<int, int>::const_iterator it;
+        for (it = s.begin(); it != s.end(); ++it)
+          if (it->second)
+            set(it->first, it->second);
+        totalSides = total;
+      }
+  };
+
+  Tracker::Tracker(apf::Mesh* m, apf::MeshTag* w, int d)
+    : mesh(m), wtag(w), dim(d), totalSides(0), weight(0) {
+    int dims[2] = {0, dim};
+    for (int i = 0; i < (dim ? 2 : 1); ++i) {
+      apf::MeshEntity* e;
+      apf::MeshIterator* it = mesh->begin(dims[i]);
+      while ((e = mesh->iterate(it)))
+        count(e, 1);
+      mesh->end(it);
+    }
+    previous = apf::setMigrationObserver(this);
+  }
+
+  Tracker::~Tracker() {
+    apf::MigrationObserver* current = apf::setMigrationObserver(previous);
+    PCU_ALWAYS_ASSERT(current == this);
+  }
+
+  void Tracker::count(apf::MeshEntity* e, int sign) {
+    const int d = apf::getDimension(mesh, e);
+    if (d == dim) {
+      PCU_ALWAYS_ASSERT(mesh->hasTag(e, wtag));
+      double w;
+      mesh->getDoubleTag(e, wtag, &w);
+      weight += sign * w;
+    }
+    if (d || !mesh->isShared(e))
+      return;
+    apf::Copies rmts;
+    mesh->getRemotes(e, rmts);
+    APF_ITERATE(apf::Copies, rmts, r)
+      sides[r->first] += sign;
+    totalSides += sign;
+  }
+
+  /* migrations of other meshes only pass through */
+  void Tracker::before(apf::Mesh2* m, apf::MeshEntity* e) {
+    if (m == mesh)
+      count(e, -1);
+    if (previous)
+      previous->before(m, e);
+  }
+
+  void Tracker::after(apf::Mesh2* m, apf::MeshEntity* e) {
+    if (m == mesh)
+      count(e, 1);
+    if (previous)
+      previous->after(m, e);
+  }
+
+  Sides* Tracker::makeVtxSides() {
+    return new TrackedSides(mesh, sides, totalSides);
+  }
+
+  Weights* Tracker::makeEntWeights(Sides* s) {
+    return parma::makeEntWeights(mesh, wtag, s, dim, weight);
+  }
+
+  double Tracker::getImbalance() {
+    const double tot = PCU_Add_Double(weight);
+    const double max = PCU_Max_Double(weight);
+    return max / (tot / PCU_Comm_Peers());
+  }
+}
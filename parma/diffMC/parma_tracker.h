@@ -0,0 +1,36 @@
+#ifndef PARMA_TRACKER_H
+#define PARMA_TRACKER_H
+#include <apfMesh2.h>
+#include <map>
+
+namespace parma {
+  class Sides;
+  class Weights;
+  /* Keeps the vertex sides and the weight of the entities of dimension
+   * (dim) of the local part current across balancing steps.  The part
+   * is counted once, after that apf::migrate reports the entities it
+   * changes and only their contributions are removed and re-added.
+   * Trackers of nested balancers chain to the observer they replaced
+   * and must be destroyed in reverse order of construction. */
+  class Tracker : public apf::MigrationObserver {
+    public:
+      Tracker(apf::Mesh* m, apf::MeshTag* w, int dim);
+      ~Tracker();
+      Sides* makeVtxSides();
+      Weights* makeEntWeights(Sides* s);
+      double getImbalance();
+      void before(apf::Mesh2* m, apf::MeshEntity* e);
+      void after(apf::Mesh2* m, apf::MeshEntity* e);
+    private:
+      Tracker();
+      void count(apf::MeshEntity* e, int sign);
+      apf::Mesh* mesh;
+      apf::MeshTag* wtag;
+      int dim;
+      apf::MigrationObserver* previous;
+      std::map<int, int> sides;
+      int totalSides;
+      double weight;
+  };
+}
+#endif
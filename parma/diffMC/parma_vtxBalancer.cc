@@ -11,6 +11,7 @@
 #include "parma_graphDist.h"
 #include "parma_commons.h"
 #include "parma_convert.h"
+#include "parma_tracker.h"
 
 namespace {
   using parmaCommons::status;
@@ -18,9 +19,11 @@ namespace {
   class VtxBalancer : public parma::Balancer {
     private:
       int sideTol;
+      bool flow;
+      parma::Tracker* tracker;
     public:
-      VtxBalancer(apf::Mesh* m, double f, int v)
-        : Balancer(m, f, v, "vertices") {
+      VtxBalancer(apf::Mesh* m, double f, int v, bool fl)
+        : Balancer(m, f, v, "vertices"), flow(fl), tracker(0) {
           parma::Sides* s = parma::makeVtxSides(mesh);
           sideTol = TO_INT(parma::avgSharedSides(s));
           delete s;
@@ -28,12 +31,18 @@ namespace {
             status("sideTol %d\n", sideTol);
       }
 
+      void balance(apf::MeshTag* wtag, double tolerance) {
+        tracker = new parma::Tracker(mesh, wtag, 0);
+        parma::Balancer::balance(wtag, tolerance);
+        delete tracker;
+      }
+
       bool runStep(apf::MeshTag* wtag, double tolerance) {
-        const double maxVtxImb =
-          Parma_GetWeightedEntImbalance(mesh, wtag, 0);
-        parma::Sides* s = parma::makeVtxSides(mesh);
-        parma::Weights* w = parma::makeEntWeights(mesh, wtag, s, 0);
-        parma::Targets* t =
+        const double maxVtxImb = tracker->getImbalance();
+        parma::Sides* s = tracker->makeVtxSides();
+        parma::Weights* w = tracker->makeEntWeights(s);
+        parma::Targets* t = flow ?
+          parma::makeDiffusionSideTargets(s, w, sideTol, factor) :
           parma::makeWeightSideTargets(s, w, sideTol, factor);
         parma::Selector* sel = parma::makeVtxSelector(mesh, wtag);
         double avgSides = parma::avgSharedSides(s);
@@ -53,5 +62,12 @@ apf::Balancer* Parma_MakeVtxBalancer(apf::Mesh* m,
     double stepFactor, int verbosity) {
   if( !PCU_Comm_Self() && verbosity )
     status("stepFactor %.3f\n", stepFactor);
-  return new VtxBalancer(m, stepFactor, verbosity);
+  return new VtxBalancer(m, stepFactor, verbosity, false);
+}
+
+apf::Balancer* Parma_MakeVtxFlowBalancer(apf::Mesh* m,
+    double stepFactor, int verbosity) {
+  if( !PCU_Comm_Self() && verbosity )
+    status("stepFactor %.3f\n", stepFactor);
+  return new VtxBalancer(m, stepFactor, verbosity, true);
 }
@@ -15,6 +15,8 @@ namespace parma {
   };
   class GhostWeights;
   Weights* makeEntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int dim);
+  Weights* makeEntWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s, int dim,
+      double selfW);
   Weights* makeGhostMPASWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s,
       int layers, int bridge);
   GhostWeights* makeVtxGhostWeights(apf::Mesh* m, apf::MeshTag* w, Sides* s,
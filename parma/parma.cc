@@ -1,10 +1,11 @@
 #include <PCU.h>
 #include <pcu_util.h>
 #include "parma.h"
-#include "diffMC/maximalIndependentSet/mis.h"
+#include "diffMC/parma_coloring.h"
 #include "diffMC/parma_commons.h"
 #include "diffMC/parma_convert.h"
 #include <parma_dcpart.h>
+#include <climits>
 #include <limits>
 #include <sstream>
 #include <string>
@@ -397,29 +398,126 @@ apf::MeshTag* Parma_WeighByMemory(apf::Mesh* m) {
 int Parma_MisNumbering(apf::Mesh* m, int d) {
   apf::Parts neighbors;
   apf::getPeers(m,d,neighbors);
-
-  misLuby::partInfo part;
-  part.id = m->getId();
-  part.net.push_back(m->getId());
+  std::vector<std::pair<int,parma::GraphVertex> > edges;
   APF_ITERATE(apf::Parts, neighbors, nItr) {
-    part.adjPartIds.push_back(*nItr);
-    part.net.push_back(*nItr);
+    parma::GraphVertex v = {*nItr, 0};
+    edges.push_back(std::make_pair(0, v));
   }
+  parma::DistGraph g;
+  parma::makeDistGraph(1, edges, g);
+  std::vector<int> colors;
+  parma::colorGraph(g, colors);
+  return colors[0];
+}
 
-  unsigned seed = TO_UINT(part.id+1);
-  mis_init(seed);
-  int misNumber=-1;
-  int iter=0;
-  int misSize=0;
-  while( misSize != PCU_Comm_Peers() ) {
-    if( mis(part, false, true) || 1 == part.net.size() ) {
-      misNumber = iter;
-      part.net.clear();
-      part.adjPartIds.clear();
+namespace {
+  /* copies the value of an integer tag from owners to remote copies */
+  void syncIntTag(apf::Mesh* m, apf::MeshTag* tag, int d) {
+    PCU_Comm_Begin();
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      if (!m->isShared(e) || !m->isOwned(e))
+        continue;
+      int value;
+      m->getIntTag(e, tag, &value);
+      apf::Copies remotes;
+      m->getRemotes(e, remotes);
+      APF_ITERATE(apf::Copies, remotes, rit) {
+        PCU_COMM_PACK(rit->first, rit->second);
+        PCU_COMM_PACK(rit->first, value);
+      }
+    }
+    m->end(it);
+    PCU_Comm_Send();
+    while (PCU_Comm_Receive()) {
+      apf::MeshEntity* r;
+      int value;
+      PCU_COMM_UNPACK(r);
+      PCU_COMM_UNPACK(value);
+      m->setIntTag(r, tag, &value);
     }
-    iter++;
-    misSize = (misNumber != -1);
-    misSize = PCU_Add_Int(misSize);
   }
-  return misNumber;
+
+  /* numbers the owned entities of dimension d and gives every copy the
+     number of its owner */
+  apf::MeshTag* numberOwned(apf::Mesh* m, int d, int& count) {
+    apf::MeshTag* tag = m->createIntTag("parma_color_id", 1);
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    count = 0;
+    while ((e = m->iterate(it)))
+      if (m->isOwned(e)) {
+        m->setIntTag(e, tag, &count);
+        ++count;
+      }
+    m->end(it);
+    syncIntTag(m, tag, d);
+    return tag;
+  }
+
+  /* the owner of each entity collects the entities sharing a bridge
+     entity with any of its copies */
+  void getBridgeGraph(apf::Mesh* m, int d, int b, apf::MeshTag* ids,
+      int count, parma::DistGraph& g) {
+    std::vector<std::pair<int,parma::GraphVertex> > edges;
+    const int self = m->getId();
+    PCU_Comm_Begin();
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    apf::Adjacent adj;
+    while ((e = m->iterate(it))) {
+      int owner = m->getOwner(e);
+      int id;
+      m->getIntTag(e, ids, &id);
+      apf::getBridgeAdjacent(m, e, b, d, adj);
+      for (size_t i = 0; i < adj.size(); ++i) {
+        parma::GraphVertex v = {m->getOwner(adj[i]), 0};
+        m->getIntTag(adj[i], ids, &v.index);
+        if (owner == self) {
+          edges.push_back(std::make_pair(id, v));
+        } else {
+          PCU_COMM_PACK(owner, id);
+          PCU_COMM_PACK(owner, v);
+        }
+      }
+    }
+    m->end(it);
+    PCU_Comm_Send();
+    while (PCU_Comm_Receive()) {
+      int id;
+      parma::GraphVertex v;
+      PCU_COMM_UNPACK(id);
+      PCU_COMM_UNPACK(v);
+      edges.push_back(std::make_pair(id, v));
+    }
+    parma::makeDistGraph(count, edges, g);
+  }
+}
+
+apf::MeshTag* Parma_ColorEntities(apf::Mesh* m, int d, int b,
+    int* numColors) {
+  PCU_ALWAYS_ASSERT(b != d);
+  int count;
+  apf::MeshTag* ids = numberOwned(m, d, count);
+  parma::DistGraph g;
+  getBridgeGraph(m, d, b, ids, count, g);
+  std::vector<int> colors;
+  int n = parma::colorGraph(g, colors);
+  if (numColors)
+    *numColors = n;
+  apf::MeshTag* tag = m->createIntTag("parma_color", 1);
+  apf::MeshIterator* it = m->begin(d);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it)))
+    if (m->isOwned(e)) {
+      int id;
+      m->getIntTag(e, ids, &id);
+      m->setIntTag(e, tag, &colors[id]);
+    }
+  m->end(it);
+  syncIntTag(m, tag, d);
+  apf::removeTagFromDimension(m, ids, d);
+  m->destroyTag(ids);
+  return tag;
 }
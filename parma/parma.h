@@ -141,6 +141,29 @@ void Parma_PrintPtnStats(apf::Mesh* m, std::string key, bool fine=false);
  */
 void Parma_PrintWeightedPtnStats(apf::Mesh* m, apf::MeshTag* w, std::string key, bool fine=false);
 
+/**
+ * @brief write a machine readable partition quality report
+ * @remark The report holds the entity and weighted entity imbalance, the
+ * edge cut (shared sides), part and model boundary vertices, neighbor
+ * histograms, face-disconnected components and the estimated communication
+ * volume. It is gathered with one pass over each entity order and three
+ * reductions so that it can be written every adapt cycle.
+ * Rank 0 appends one record to the file: a CSV row, preceded by a header
+ * when the file is new, if the name ends in ".csv", and a single line JSON
+ * object otherwise. The CSV columns depend on the mesh dimension and on
+ * whether a field shape is given, so records appended to one CSV file
+ * should agree on both.
+ * @param m (In) partitioned mesh
+ * @param w (In) tag with entity weights, if NULL or if an entity order does
+ *          not have weights on all its entities unit weights are used
+ * @param s (In) field shape used to estimate the node values sent by one
+ *          accumulate and synchronize, if NULL the estimate is skipped
+ * @param key (In) identifying string to write with the report
+ * @param fileName (In) report file
+ */
+void Parma_WritePtnReport(apf::Mesh* m, apf::MeshTag* w, apf::FieldShape* s,
+    const char* key, const char* fileName);
+
 /**
  * @brief re-connect disconnected parts
  * @param m (In) partitioned mesh
@@ -241,6 +264,36 @@ apf::Balancer* Parma_MakeVtxBalancer(apf::Mesh* m, double stepFactor=0.1,
 apf::Balancer* Parma_MakeElmBalancer(apf::Mesh* m, double stepFactor=0.1,
     int verbosity=0);
 
+/**
+ * @brief create an APF Balancer targeting vertex imbalance that plans
+ *        its migrations from the part graph
+ * @details the weight sent to each neighbor comes from an approximate
+ *          diffusion solution over the part graph, so one migration
+ *          moves weight across several parts and far fewer steps are
+ *          needed than with Parma_MakeVtxBalancer.
+ *          the net weight a part sends is at most its surplus
+ * @param m (In) partitioned mesh
+ * @param stepFactor (In) fraction of the planned weight to migrate
+ *                        per step
+ * @param verbosity (In) output control, higher values output more
+ * @return apf balancer instance
+ */
+apf::Balancer* Parma_MakeVtxFlowBalancer(apf::Mesh* m,
+    double stepFactor=1.0, int verbosity=0);
+
+/**
+ * @brief create an APF Balancer targeting element imbalance that plans
+ *        its migrations from the part graph
+ * @details see Parma_MakeVtxFlowBalancer
+ * @param m (In) partitioned mesh
+ * @param stepFactor (In) fraction of the planned weight to migrate
+ *                        per step
+ * @param verbosity (In) output control, higher values output more
+ * @return apf balancer instance
+ */
+apf::Balancer* Parma_MakeElmFlowBalancer(apf::Mesh* m,
+    double stepFactor=1.0, int verbosity=0);
+
 /**
  * @brief create an APF Balancer targeting vertex, edge, and elm imbalance
  * @param m (In) partitioned mesh
@@ -267,6 +320,43 @@ apf::Balancer* Parma_MakeVtxElmBalancer(apf::Mesh* m,
  */
 apf::Splitter* Parma_MakeRibSplitter(apf::Mesh* m, bool sync = true);
 
+/**
+ * @brief create an APF Balancer using global recursive inertial bisection
+ * @details the inertia tensors and weighted medians are reduced over all
+ *          parts, so elements held by a few parts, such as a mesh loaded
+ *          from one serial file, are cut into one piece per part.
+ *          The part count does not need to be a power of two.
+ *          It is skipped when the element imbalance is already within
+ *          the tolerance.
+ * @param m (In) partitioned mesh
+ * @param verbosity (In) output control, higher values output more
+ * @return apf balancer instance
+ */
+apf::Balancer* Parma_MakeRibBalancer(apf::Mesh* m, int verbosity=0);
+
+/**
+ * @brief create an APF Splitter using a Hilbert space-filling curve
+ * @details elements are ordered along the curve through their centroids
+ *          and the curve is cut into segments of equal weight, so the
+ *          split factor does not need to be a power of two
+ * @param m (In) partitioned mesh
+ * @param sync (In) true if all parts will be split, false o.w.
+ * @return apf splitter instance
+ */
+apf::Splitter* Parma_MakeSfcSplitter(apf::Mesh* m, bool sync = true);
+
+/**
+ * @brief create an APF Balancer using a Hilbert space-filling curve
+ * @details the curve keys of all element centroids are sorted in parallel
+ *          and the curve is cut into one segment of equal weight per part.
+ *          This is a full repartition, it is skipped when the element
+ *          imbalance is already within the tolerance.
+ * @param m (In) partitioned mesh
+ * @param verbosity (In) output control, higher values output more
+ * @return apf balancer instance
+ */
+apf::Balancer* Parma_MakeSfcBalancer(apf::Mesh* m, int verbosity=0);
+
 /**
  * @brief create a mesh tag that weighs elements by their memory consumption
  * @param m (In) partitioned mesh
@@ -330,6 +420,24 @@ void Parma_SplitPartition(apf::Mesh2* m, int factor, Parma_GroupCode& toRun);
  */
 int Parma_MisNumbering(apf::Mesh* m, int d);
 
+/**
+ * @brief color mesh entities
+ * @remark Entities of dimension d that share an entity of dimension b
+ *         get different colors, entities of color zero form a maximal
+ *         independent set. All copies of an entity get the same color.
+ *         Entities of one color can be processed concurrently, for
+ *         example cavities around the vertices of one color when d=0
+ *         and b=3.
+ * @param m (In) partitioned mesh
+ * @param d (In) dimension of the colored entities
+ * @param b (In) bridge dimension, not equal to d
+ * @param numColors (Out) number of colors over all parts, may be NULL
+ * @return an integer tag named "parma_color" holding the colors,
+ *         the caller destroys it
+ */
+apf::MeshTag* Parma_ColorEntities(apf::Mesh* m, int d, int b,
+    int* numColors);
+
 /**
  * @brief reorder the mesh via a breadth first search
  * @remark the returned tag has the reordered vertex order
@@ -0,0 +1,287 @@
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parma.h"
+#include "diffMC/parma_convert.h"
+#include <parma_dcpart.h>
+#include <apfShape.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+  typedef std::map<int,int> mii;
+
+  /* the last bin of a histogram also counts everything above it */
+  enum { NEIGHBOR_BINS = 16, SMALL_SIDES = 10 };
+
+  const char* entNames[4] = {"vtx", "edge", "face", "rgn"};
+
+  struct Field {
+    std::string name;
+    double value;
+  };
+  typedef std::vector<Field> Fields;
+
+  /* all values are reduced together so a report costs the same three
+     reductions no matter how many values it holds */
+  class Report {
+    public:
+      /* report the tot, max, min and avg over parts of a part value */
+      int add(std::string const& name, double loc) {
+        return push(name, loc, false);
+      }
+      /* report only the sum over parts of a part value */
+      int addSum(std::string const& name, double loc) {
+        return push(name, loc, true);
+      }
+      void reduce() {
+        if (loc.empty())
+          return;
+        tot = max = min = loc;
+        PCU_Add_Doubles(&tot[0], tot.size());
+        PCU_Max_Doubles(&max[0], max.size());
+        PCU_Min_Doubles(&min[0], min.size());
+      }
+      double getTot(int i) { return tot[i]; }
+      double getMax(int i) { return max[i]; }
+      double getAvg(int i) { return tot[i] / PCU_Comm_Peers(); }
+      void getFields(Fields& f) {
+        for (size_t i = 0; i < loc.size(); ++i) {
+          append(f, names[i] + (sumOnly[i] ? "" : "_tot"), tot[i]);
+          if (sumOnly[i])
+            continue;
+          append(f, names[i] + "_max", max[i]);
+          append(f, names[i] + "_min", min[i]);
+          append(f, names[i] + "_avg", getAvg(i));
+        }
+      }
+    private:
+      std::vector<std::string> names;
+      std::vector<bool> sumOnly;
+      std::vector<double> loc;
+      std::vector<double> tot;
+      std::vector<double> max;
+      std::vector<double> min;
+      int push(std::string const& name, double v, bool s) {
+        names.push_back(name);
+        sumOnly.push_back(s);
+        loc.push_back(v);
+        return TO_INT(loc.size()) - 1;
+      }
+      static void append(Fields& f, std::string const& name, double v) {
+        Field field;
+        field.name = name;
+        field.value = v;
+        f.push_back(field);
+      }
+  };
+
+  struct PartCounts {
+    double ents[4];
+    double weights[4];
+    double ownedBdryVtx;
+    double sharedBdryVtx;
+    double mdlBdryVtx;
+    double sharedSides;
+    double ownedSharedSides;
+    double commVolume;
+    mii nborToShared;
+  };
+
+  /* node values sent for a shared entity by one accumulate followed by
+     one synchronize: a copy sends to the owner and the owner sends
+     back to every copy */
+  double getCommVolume(apf::Mesh* m, apf::FieldShape* s, apf::MeshEntity* e) {
+    int nodes = s->countNodesOn(m->getType(e));
+    if (!nodes)
+      return 0;
+    if (!m->isOwned(e))
+      return nodes;
+    apf::Copies remotes;
+    m->getRemotes(e, remotes);
+    return TO_DOUBLE(nodes) * TO_DOUBLE(remotes.size());
+  }
+
+  /* one pass over each dimension gathers every part value */
+  void getPartCounts(apf::Mesh* m, apf::MeshTag* w, apf::FieldShape* s,
+      PartCounts& c) {
+    const int dim = m->getDimension();
+    const int self = m->getId();
+    c.ownedBdryVtx = c.sharedBdryVtx = c.mdlBdryVtx = 0;
+    c.sharedSides = c.ownedSharedSides = 0;
+    c.commVolume = 0;
+    for (int d = 0; d < 4; ++d)
+      c.ents[d] = c.weights[d] = 0;
+    for (int d = 0; d <= dim; ++d) {
+      bool hasNodes = s && s->hasNodesIn(d);
+      bool hasWeight = (w != 0);
+      apf::MeshEntity* e;
+      apf::MeshIterator* it = m->begin(d);
+      while ((e = m->iterate(it))) {
+        if (hasWeight && m->hasTag(e, w)) {
+          double x;
+          m->getDoubleTag(e, w, &x);
+          c.weights[d] += x;
+        } else {
+          hasWeight = false;
+        }
+        if (!d && m->getModelType(m->toModel(e)) < dim)
+          c.mdlBdryVtx++;
+        if (!m->isShared(e))
+          continue;
+        bool owned = m->isOwned(e);
+        if (hasNodes)
+          c.commVolume += getCommVolume(m, s, e);
+        if (d == dim - 1) {
+          c.sharedSides++;
+          if (owned)
+            c.ownedSharedSides++;
+        }
+        if (d)
+          continue;
+        c.sharedBdryVtx++;
+        if (owned)
+          c.ownedBdryVtx++;
+        apf::Parts sharers;
+        m->getResidence(e, sharers);
+        APF_ITERATE(apf::Parts, sharers, nbor)
+          if (*nbor != self)
+            c.nborToShared[*nbor]++;
+      }
+      m->end(it);
+      c.ents[d] = TO_DOUBLE(m->count(d));
+      /* entity orders without a weight on every entity get unit weights,
+         as in Parma_GetWeightedEntImbalance */
+      if (!hasWeight)
+        c.weights[d] = c.ents[d];
+    }
+  }
+
+  double getImbalance(Report& r, int i) {
+    double avg = r.getAvg(i);
+    if (avg == 0)
+      return 1;
+    return r.getMax(i) / avg;
+  }
+
+  void getReport(apf::Mesh* m, apf::MeshTag* w, apf::FieldShape* s,
+      Fields& f) {
+    const int dim = m->getDimension();
+    PartCounts c;
+    getPartCounts(m, w, s, c);
+    double elms = c.ents[dim];
+    unsigned numDc = 0;
+    if (elms) {
+      dcPart dc(m);
+      numDc = dc.getNumDcComps();
+    }
+    Report r;
+    int ents[4];
+    int weights[4];
+    for (int d = 0; d <= dim; ++d)
+      ents[d] = r.add(entNames[d], c.ents[d]);
+    for (int d = 0; d <= dim; ++d)
+      weights[d] = r.add(std::string("weighted_") + entNames[d],
+          c.weights[d]);
+    r.addSum("edge_cut", c.ownedSharedSides);
+    r.add("shared_sides", c.sharedSides);
+    r.add("owned_bdry_vtx", c.ownedBdryVtx);
+    r.add("shared_bdry_vtx", c.sharedBdryVtx);
+    r.add("model_bdry_vtx", c.mdlBdryVtx);
+    r.add("shared_sides_to_elements", elms ? c.sharedSides / elms : 0);
+    r.add("disconnected", TO_DOUBLE(numDc));
+    r.addSum("empty_parts", (elms == 0));
+    if (s)
+      r.add("comm_volume", c.commVolume);
+    int nbors = TO_INT(c.nborToShared.size());
+    r.add("neighbors", nbors);
+    for (int i = 0; i < NEIGHBOR_BINS; ++i) {
+      bool inBin = (nbors == i) ||
+        (i == NEIGHBOR_BINS - 1 && nbors > i);
+      char name[32];
+      sprintf(name, "neighbors_hist_%d", i);
+      r.addSum(name, inBin);
+    }
+    int small[SMALL_SIDES] = {0};
+    APF_ITERATE(mii, c.nborToShared, nbor)
+      if (nbor->second <= SMALL_SIDES)
+        small[nbor->second - 1]++;
+    for (int i = 0; i < SMALL_SIDES; ++i) {
+      char name[32];
+      sprintf(name, "small_sides_%d", i + 1);
+      r.addSum(name, small[i]);
+    }
+    r.reduce();
+    r.getFields(f);
+    for (int d = 0; d <= dim; ++d) {
+      Field imb;
+      imb.name = std::string(entNames[d]) + "_imb";
+      imb.value = getImbalance(r, ents[d]);
+      f.push_back(imb);
+      imb.name = std::string("weighted_") + entNames[d] + "_imb";
+      imb.value = getImbalance(r, weights[d]);
+      f.push_back(imb);
+    }
+  }
+
+  bool isCsv(const char* fileName) {
+    size_t n = strlen(fileName);
+    return n >= 4 && !strcmp(fileName + n - 4, ".csv");
+  }
+
+  void writeJsonString(FILE* file, const char* s) {
+    fputc('"', file);
+    for (; *s; ++s) {
+      if (*s == '"' || *s == '\\')
+        fputc('\\', file);
+      fputc(*s, file);
+    }
+    fputc('"', file);
+  }
+
+  void writeJson(FILE* file, const char* key, Fields const& f) {
+    fprintf(file, "{\"key\": ");
+    writeJsonString(file, key);
+    fprintf(file, ", \"parts\": %d", PCU_Comm_Peers());
+    for (size_t i = 0; i < f.size(); ++i)
+      fprintf(file, ", \"%s\": %.10g", f[i].name.c_str(), f[i].value);
+    fprintf(file, "}\n");
+  }
+
+  /* the header is written once, when the file is first created */
+  void writeCsv(FILE* file, const char* key, Fields const& f) {
+    fseek(file, 0, SEEK_END);
+    if (!ftell(file)) {
+      fprintf(file, "key,parts");
+      for (size_t i = 0; i < f.size(); ++i)
+        fprintf(file, ",%s", f[i].name.c_str());
+      fprintf(file, "\n");
+    }
+    fprintf(file, "%s,%d", key, PCU_Comm_Peers());
+    for (size_t i = 0; i < f.size(); ++i)
+      fprintf(file, ",%.10g", f[i].value);
+    fprintf(file, "\n");
+  }
+}
+
+void Parma_WritePtnReport(apf::Mesh* m, apf::MeshTag* w, apf::FieldShape* s,
+    const char* key, const char* fileName) {
+  double t0 = PCU_Time();
+  Fields f;
+  getReport(m, w, s, f);
+  if (PCU_Comm_Self())
+    return;
+  FILE* file = fopen(fileName, "a");
+  if (!file) {
+    fprintf(stderr, "Parma_WritePtnReport could not open %s\n", fileName);
+    return;
+  }
+  if (isCsv(fileName))
+    writeCsv(file, key, f);
+  else
+    writeJson(file, key, f);
+  fclose(file);
+  PCU_Debug_Print("%s report written in %f seconds\n", key, PCU_Time() - t0);
+}
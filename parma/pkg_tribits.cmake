@@ -2,7 +2,7 @@ TRIBITS_PACKAGE(SCORECparma)
 
 SET(PARMA_EXTERNAL_HEADERS parma.h)
 
-SET(API_SOURCE parma.cc)
+SET(API_SOURCE parma.cc parma_report.cc)
 
 SET(DIFFMC_SOURCES
   diffMC/parma_balancer.cc
@@ -14,6 +14,8 @@ SET(DIFFMC_SOURCES
   diffMC/parma_components.cc
   diffMC/parma_dcpart.cc
   diffMC/parma_dcpartFixer.cc
+  diffMC/parma_coloring.cc
+  diffMC/parma_diffusionTargets.cc
   diffMC/parma_dijkstra.cc
   diffMC/parma_elmBalancer.cc
   diffMC/parma_elmBdrySides.cc
@@ -36,6 +38,7 @@ SET(DIFFMC_SOURCES
   diffMC/parma_sides.cc
   diffMC/parma_step.cc
   diffMC/parma_stop.cc
+  diffMC/parma_tracker.cc
   diffMC/parma_shapeOptimizer.cc
   diffMC/parma_shapeTargets.cc
   diffMC/parma_shapeSelector.cc
@@ -50,8 +53,6 @@ SET(DIFFMC_SOURCES
   diffMC/parma_vtxElmBalancer.cc
   diffMC/parma_elmLtVtxEdgeBalancer.cc
   diffMC/zeroOneKnapsack.c
-  diffMC/maximalIndependentSet/misLuby.cc
-  diffMC/maximalIndependentSet/mersenne_twister.cc
   )
 
 SET(RIB_SOURCES
@@ -59,6 +60,11 @@ SET(RIB_SOURCES
   rib/parma_mesh_rib.cc
   )
 
+SET(SFC_SOURCES
+  sfc/parma_sfc.cc
+  sfc/parma_mesh_sfc.cc
+  )
+
 SET(GROUP_SOURCES
   group/parma_group.cc
   )
@@ -71,7 +77,8 @@ SET(parmaDepLibs ${APF_LIBS})
 
 TRIBITS_ADD_LIBRARY(
   parma
-  SOURCES ${DIFFMC_SOURCES} ${RIB_SOURCES} ${GROUP_SOURCES} ${API_SOURCE}
+  SOURCES ${DIFFMC_SOURCES} ${RIB_SOURCES} ${SFC_SOURCES} ${GROUP_SOURCES}
+    ${API_SOURCE}
   HEADERS ${PARMA_EXTERNAL_HEADERS})
 
 TRIBITS_PACKAGE_POSTPROCESS()
@@ -3,6 +3,7 @@
 #include <apfPartition.h>
 #include <pcu_util.h>
 #include <apf2mth.h>
+#include <vector>
 
 namespace parma {
 
@@ -14,11 +15,12 @@ Body** makeBodies(apf::DynamicArray<Body>& arr) {
   return body;
 }
 
-static apf::Migration* splitMesh(apf::Mesh* m, apf::MeshTag* weights, int depth)
+static void getBodies(apf::Mesh* m, apf::MeshTag* weights,
+    apf::DynamicArray<Body>& arr, apf::DynamicArray<apf::MeshEntity*>& elems)
 {
   int dim = m->getDimension();
-  apf::DynamicArray<Body> arr(m->count(dim));
-  apf::DynamicArray<apf::MeshEntity*> elems(m->count(dim));
+  arr.setSize(m->count(dim));
+  elems.setSize(m->count(dim));
   apf::MeshEntity* e;
   size_t i = 0;
   apf::MeshIterator* it = m->begin(dim);
@@ -33,6 +35,13 @@ static apf::Migration* splitMesh(apf::Mesh* m, apf::MeshTag* weights, int depth)
   }
   PCU_ALWAYS_ASSERT(i == m->count(dim));
   m->end(it);
+}
+
+static apf::Migration* splitMesh(apf::Mesh* m, apf::MeshTag* weights, int depth)
+{
+  apf::DynamicArray<Body> arr;
+  apf::DynamicArray<apf::MeshEntity*> elems;
+  getBodies(m, weights, arr, elems);
   Bodies all;
   all.body = makeBodies(arr);
   all.n = arr.getSize();
@@ -86,6 +95,60 @@ class RibSplitter : public apf::Splitter
     bool sync;
 };
 
+class RibBalancer : public apf::Balancer
+{
+  public:
+    RibBalancer(apf::Mesh* m, int v)
+    {
+      mesh = m;
+      verbose = v;
+    }
+    virtual ~RibBalancer() {}
+    virtual void balance(apf::MeshTag* weights, double tolerance)
+    {
+      double t0 = PCU_Time();
+      apf::DynamicArray<Body> arr;
+      apf::DynamicArray<apf::MeshEntity*> elems;
+      getBodies(mesh, weights, arr, elems);
+      double local = 0;
+      for (size_t i = 0; i < arr.getSize(); ++i)
+        local += arr[i].mass;
+      double total = PCU_Add_Double(local);
+      double max = PCU_Max_Double(local);
+      double imbalance = 1;
+      if (total > 0)
+        imbalance = max / (total / PCU_Comm_Peers());
+      if (imbalance <= tolerance) {
+        if (verbose && !PCU_Comm_Self())
+          printf("RIB skipped, imbalance %f is within %f\n",
+              imbalance, tolerance);
+        return;
+      }
+      Bodies all;
+      all.body = makeBodies(arr);
+      all.n = arr.getSize();
+      std::vector<int> parts(all.n);
+      bisectGlobally(&all, PCU_Comm_Peers(), parts.data());
+      delete [] all.body;
+      int self = PCU_Comm_Self();
+      apf::Migration* plan = new apf::Migration(mesh);
+      for (size_t i = 0; i < elems.getSize(); ++i)
+        if (parts[i] != self)
+          plan->send(elems[i], parts[i]);
+      plan = apf::remapMigration(plan, weights);
+      if (verbose && !PCU_Comm_Self())
+        printf("planned RIB balance from imbalance %f in %f seconds\n",
+            imbalance, PCU_Time() - t0);
+      mesh->migrate(plan);
+      double t1 = PCU_Time();
+      if (!PCU_Comm_Self())
+        printf("RIB balanced to %f in %f seconds\n", tolerance, t1 - t0);
+    }
+  private:
+    apf::Mesh* mesh;
+    int verbose;
+};
+
 }
 
 apf::Splitter* Parma_MakeRibSplitter(apf::Mesh* m, bool sync)
@@ -93,3 +156,7 @@ apf::Splitter* Parma_MakeRibSplitter(apf::Mesh* m, bool sync)
   return new parma::RibSplitter(m, sync);
 }
 
+apf::Balancer* Parma_MakeRibBalancer(apf::Mesh* m, int verbosity)
+{
+  return new parma::RibBalancer(m, verbosity);
+}
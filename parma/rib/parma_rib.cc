@@ -1,6 +1,9 @@
+#include <PCU.h>
 #include "parma_rib.h"
 #include <apfNew.h>
 #include <algorithm>
+#include <vector>
+#include <cfloat>
 #include <mthQR.h>
 #include <mth_def.h>
 #include <pcu_util.h>
@@ -119,16 +122,33 @@ static void centerBodies(Bodies* b, mth::Vector3<double> const& c)
   }
 }
 
-int findSortedMedian(Bodies const* b)
+/* weighted median by repeated selection. on return the bodies before
+   the median all project below the ones after it, which is all the
+   bisection needs, at expected linear cost instead of a full sort */
+static int selectMedian(Bodies* b, Compare const& comp)
 {
-  double total = getTotalMass(b);
-  double half = 0;
-  for (int i = 0; i < b->n; ++i) {
-    if (half >= total / 2)
-      return i;
-    half += b->body[i]->mass;
+  double half = getTotalMass(b) / 2;
+  if (half <= 0)
+    return 0;
+  /* the median index i satisfies lo < i <= hi and
+     (before) is the mass of the bodies ahead of lo */
+  int lo = 0;
+  int hi = b->n;
+  double before = 0;
+  while (hi - lo > 1) {
+    int mid = lo + (hi - lo) / 2;
+    std::nth_element(b->body + lo, b->body + mid, b->body + hi, comp);
+    double m = 0;
+    for (int i = lo; i < mid; ++i)
+      m += b->body[i]->mass;
+    if (before + m >= half) {
+      hi = mid;
+    } else {
+      before += m;
+      lo = mid;
+    }
   }
-  return b->n;
+  return hi;
 }
 
 void bisect(Bodies* all, Bodies* left, Bodies* right)
@@ -137,8 +157,7 @@ void bisect(Bodies* all, Bodies* left, Bodies* right)
   centerBodies(all, c);
   Compare comp;
   comp.normal = getBisectionNormal(all);
-  std::sort(all->body, all->body + all->n, comp);
-  int mid = findSortedMedian(all);
+  int mid = selectMedian(all, comp);
   left->n = mid;
   right->n = all->n - mid;
 /* in-place bisection, left and right point to the same array as all */
@@ -160,4 +179,165 @@ void recursivelyBisect(Bodies* all, int depth, Bodies out[])
   recursivelyBisect(&right, depth, out + (1 << depth));
 }
 
+/* a range of output parts whose bodies are still being bisected */
+struct Group
+{
+  int first;
+  int count;
+};
+
+enum { RIB_CUT_ITERATIONS = 64 };
+
+static bool hasWork(std::vector<Group> const& groups)
+{
+  for (size_t i = 0; i < groups.size(); ++i)
+    if (groups[i].count > 1)
+      return true;
+  return false;
+}
+
+static void getCenters(Bodies const* all, std::vector<int> const& group,
+    std::vector<double>& mass, std::vector<mth::Vector3<double> >& centers)
+{
+  size_t ng = mass.size();
+  std::vector<double> sums(ng * 4, 0.0);
+  for (int i = 0; i < all->n; ++i) {
+    Body* b = all->body[i];
+    double* g = &sums[group[i] * 4];
+    g[0] += b->mass;
+    for (unsigned j = 0; j < 3; ++j)
+      g[j + 1] += b->point(j) * b->mass;
+  }
+  PCU_Add_Doubles(&sums[0], sums.size());
+  for (size_t g = 0; g < ng; ++g) {
+    mass[g] = sums[g * 4];
+    centers[g] = mth::Vector3<double>(0,0,0);
+    if (mass[g] > 0)
+      for (unsigned j = 0; j < 3; ++j)
+        centers[g](j) = sums[g * 4 + j + 1] / mass[g];
+  }
+}
+
+static void getNormals(Bodies const* all, std::vector<int> const& group,
+    std::vector<Group> const& groups,
+    std::vector<mth::Vector3<double> > const& centers,
+    std::vector<mth::Vector3<double> >& normals)
+{
+  size_t ng = groups.size();
+  std::vector<double> sums(ng * 9, 0.0);
+  for (int i = 0; i < all->n; ++i) {
+    Body b = *(all->body[i]);
+    b.point = b.point - centers[group[i]];
+    mth::Matrix3x3<double> c = getInertiaContribution(&b);
+    double* g = &sums[group[i] * 9];
+    for (unsigned j = 0; j < 3; ++j)
+    for (unsigned k = 0; k < 3; ++k)
+      g[j * 3 + k] += c(j,k);
+  }
+  PCU_Add_Doubles(&sums[0], sums.size());
+  for (size_t g = 0; g < ng; ++g) {
+    normals[g] = mth::Vector3<double>(1,0,0);
+    if (groups[g].count < 2)
+      continue;
+    mth::Matrix3x3<double> im;
+    for (unsigned j = 0; j < 3; ++j)
+    for (unsigned k = 0; k < 3; ++k)
+      im(j,k) = sums[g * 9 + j * 3 + k];
+    getWeakestEigenvector(im, normals[g]);
+  }
+}
+
+/* bisection search for the projection value of every group that puts
+   the target mass on its left. all ranks see the same sums and take
+   the same decisions, so the cuts are deterministic */
+static void findCuts(Bodies const* all, std::vector<int> const& group,
+    std::vector<double> const& s, std::vector<double> const& targets,
+    std::vector<double>& cuts)
+{
+  size_t ng = targets.size();
+  std::vector<double> lo(ng, DBL_MAX);
+  std::vector<double> hi(ng, -DBL_MAX);
+  for (int i = 0; i < all->n; ++i) {
+    lo[group[i]] = std::min(lo[group[i]], s[i]);
+    hi[group[i]] = std::max(hi[group[i]], s[i]);
+  }
+  PCU_Min_Doubles(&lo[0], ng);
+  PCU_Max_Doubles(&hi[0], ng);
+  std::vector<double> left(ng);
+  for (int iter = 0; iter < RIB_CUT_ITERATIONS; ++iter) {
+    bool done = true;
+    for (size_t g = 0; g < ng; ++g)
+      if (hi[g] - lo[g] > DBL_EPSILON * (fabs(lo[g]) + fabs(hi[g])))
+        done = false;
+    if (done)
+      break;
+    std::fill(left.begin(), left.end(), 0.0);
+    for (int i = 0; i < all->n; ++i) {
+      int g = group[i];
+      if (s[i] <= (lo[g] + hi[g]) / 2)
+        left[g] += all->body[i]->mass;
+    }
+    PCU_Add_Doubles(&left[0], ng);
+    for (size_t g = 0; g < ng; ++g) {
+      double mid = (lo[g] + hi[g]) / 2;
+      if (left[g] < targets[g])
+        lo[g] = mid;
+      else
+        hi[g] = mid;
+    }
+  }
+  cuts = hi;
+}
+
+void bisectGlobally(Bodies const* all, int parts, int out[])
+{
+  std::vector<Group> groups(1);
+  groups[0].first = 0;
+  groups[0].count = parts;
+  std::vector<int> group(all->n, 0);
+  std::vector<double> s(all->n);
+  while (hasWork(groups)) {
+    size_t ng = groups.size();
+    std::vector<double> mass(ng);
+    std::vector<mth::Vector3<double> > centers(ng);
+    getCenters(all, group, mass, centers);
+    std::vector<mth::Vector3<double> > normals(ng);
+    getNormals(all, group, groups, centers, normals);
+    for (int i = 0; i < all->n; ++i) {
+      int g = group[i];
+      s[i] = (all->body[i]->point - centers[g]) * normals[g];
+    }
+    /* groups with an odd part count are cut in proportion */
+    std::vector<double> targets(ng);
+    for (size_t g = 0; g < ng; ++g)
+      targets[g] = mass[g] * (groups[g].count / 2) / groups[g].count;
+    std::vector<double> cuts;
+    findCuts(all, group, s, targets, cuts);
+    std::vector<Group> next;
+    std::vector<int> first(ng);
+    for (size_t g = 0; g < ng; ++g) {
+      first[g] = next.size();
+      Group l = groups[g];
+      if (l.count == 1) {
+        next.push_back(l);
+        continue;
+      }
+      l.count = groups[g].count / 2;
+      Group r;
+      r.first = l.first + l.count;
+      r.count = groups[g].count - l.count;
+      next.push_back(l);
+      next.push_back(r);
+    }
+    for (int i = 0; i < all->n; ++i) {
+      int g = group[i];
+      bool isRight = groups[g].count > 1 && s[i] > cuts[g];
+      group[i] = first[g] + (isRight ? 1 : 0);
+    }
+    groups.swap(next);
+  }
+  for (int i = 0; i < all->n; ++i)
+    out[i] = groups[group[i]].first;
+}
+
 }
@@ -24,6 +24,10 @@ void bisect(Bodies* all, Bodies* left, Bodies* right);
 
 void recursivelyBisect(Bodies* all, int depth, Bodies out[]);
 
+/* collective over all ranks: cuts the bodies of every rank into (parts)
+   pieces of nearly equal mass. out[i] is the part of all->body[i] */
+void bisectGlobally(Bodies const* all, int parts, int out[]);
+
 }
 
 #endif
@@ -0,0 +1,247 @@
+#include <PCU.h>
+#include "parma.h"
+#include "parma_sfc.h"
+#include <apfPartition.h>
+#include <apfMesh.h>
+#include <pcu_util.h>
+#include <algorithm>
+#include <cfloat>
+
+namespace parma {
+
+/* the number of curve keys each part contributes to the choice of
+   sample sort splitters. the splitters only bound the sorting work per
+   part, the weight balance of the cut comes from the global prefix sums */
+enum { SFC_SAMPLES = 8 };
+
+struct Curve
+{
+  std::vector<apf::MeshEntity*> elems;
+  std::vector<SfcItem> items;
+};
+
+static void buildCurve(apf::Mesh* m, apf::MeshTag* weights, bool global,
+    Curve& c)
+{
+  int dim = m->getDimension();
+  std::vector<apf::Vector3> points;
+  SfcBox box;
+  for (int i = 0; i < 3; ++i) {
+    box.lo[i] = DBL_MAX;
+    box.hi[i] = -DBL_MAX;
+  }
+  apf::MeshEntity* e;
+  apf::MeshIterator* it = m->begin(dim);
+  while ((e = m->iterate(it))) {
+    apf::Vector3 x = apf::getLinearCentroid(m, e);
+    for (int i = 0; i < 3; ++i) {
+      box.lo[i] = std::min(box.lo[i], x[i]);
+      box.hi[i] = std::max(box.hi[i], x[i]);
+    }
+    c.elems.push_back(e);
+    points.push_back(x);
+  }
+  m->end(it);
+  if (global) {
+    PCU_Min_Doubles(box.lo, 3);
+    PCU_Max_Doubles(box.hi, 3);
+  }
+  c.items.resize(c.elems.size());
+  for (size_t i = 0; i < c.elems.size(); ++i) {
+    SfcItem& item = c.items[i];
+    item.key = getHilbertKey(box, &points[i][0]);
+    item.weight = 1;
+    if (weights)
+      m->getDoubleTag(c.elems[i], weights, &item.weight);
+    item.index = static_cast<int>(i);
+    item.from = PCU_Comm_Self();
+  }
+}
+
+static double getWeight(std::vector<SfcItem> const& items)
+{
+  double sum = 0;
+  for (size_t i = 0; i < items.size(); ++i)
+    sum += items[i].weight;
+  return sum;
+}
+
+/* every part contributes evenly spaced keys of its sorted curve and
+   every part picks the same splitters from the combined samples */
+static void getSplitters(std::vector<SfcItem> const& sorted,
+    std::vector<long>& splitters)
+{
+  int self = PCU_Comm_Self();
+  int peers = PCU_Comm_Peers();
+  std::vector<long> samples(peers * SFC_SAMPLES, 0);
+  size_t n = sorted.size();
+  for (size_t i = 0; i < SFC_SAMPLES; ++i) {
+    long key = -1;
+    if (n)
+      key = sorted[(2 * i + 1) * n / (2 * SFC_SAMPLES)].key;
+    samples[self * SFC_SAMPLES + i] = key;
+  }
+  PCU_Add_Longs(&samples[0], samples.size());
+  samples.erase(std::remove(samples.begin(), samples.end(), -1L),
+      samples.end());
+  std::sort(samples.begin(), samples.end());
+  splitters.resize(peers - 1);
+  for (int i = 0; i < peers - 1; ++i) {
+    size_t k = (i + 1) * samples.size() / peers;
+    splitters[i] = samples.empty() ? 0 : samples[k];
+  }
+}
+
+static int getBucket(std::vector<long> const& splitters, long key)
+{
+  return std::upper_bound(splitters.begin(), splitters.end(), key)
+    - splitters.begin();
+}
+
+/* parallel sample sort of the curve followed by a weighted cut
+   into one segment per part. returns the destination part of
+   every local item in the order of c.items */
+static void cutGlobalCurve(Curve& c, std::vector<int>& parts)
+{
+  int self = PCU_Comm_Self();
+  int peers = PCU_Comm_Peers();
+  std::vector<SfcItem> sorted(c.items);
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<long> splitters;
+  getSplitters(sorted, splitters);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < sorted.size(); ++i)
+    PCU_COMM_PACK(getBucket(splitters, sorted[i].key), sorted[i]);
+  PCU_Comm_Send();
+  std::vector<SfcItem> bucket;
+  while (PCU_Comm_Receive()) {
+    SfcItem item;
+    PCU_COMM_UNPACK(item);
+    item.from = PCU_Comm_Sender();
+    bucket.push_back(item);
+  }
+  std::sort(bucket.begin(), bucket.end());
+  std::vector<double> sums(peers, 0.0);
+  sums[self] = getWeight(bucket);
+  PCU_Add_Doubles(&sums[0], sums.size());
+  double before = 0;
+  double total = 0;
+  for (int i = 0; i < peers; ++i) {
+    if (i < self)
+      before += sums[i];
+    total += sums[i];
+  }
+  std::vector<int> cut;
+  cutCurve(bucket, before, total, peers, cut);
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < bucket.size(); ++i) {
+    PCU_COMM_PACK(bucket[i].from, bucket[i].index);
+    PCU_COMM_PACK(bucket[i].from, cut[i]);
+  }
+  PCU_Comm_Send();
+  parts.assign(c.items.size(), self);
+  while (PCU_Comm_Receive()) {
+    int index;
+    int part;
+    PCU_COMM_UNPACK(index);
+    PCU_COMM_UNPACK(part);
+    parts[index] = part;
+  }
+}
+
+class SfcSplitter : public apf::Splitter
+{
+  public:
+    SfcSplitter(apf::Mesh* m, bool s)
+    {
+      mesh = m;
+      sync = s;
+    }
+    virtual ~SfcSplitter() {}
+    virtual apf::Migration* split(apf::MeshTag* weights, double,
+        int multiple)
+    {
+      double t0 = PCU_Time();
+      Curve c;
+      buildCurve(mesh, weights, false, c);
+      std::sort(c.items.begin(), c.items.end());
+      std::vector<int> parts;
+      cutCurve(c.items, 0, getWeight(c.items), multiple, parts);
+      int offset = 0;
+      if (sync)
+        offset = mesh->getId() * multiple;
+      apf::Migration* plan = new apf::Migration(mesh);
+      for (size_t i = 0; i < c.items.size(); ++i)
+        if (parts[i])
+          plan->send(c.elems[c.items[i].index], parts[i] + offset);
+      if (sync) {
+        double t1 = PCU_Time();
+        if (!PCU_Comm_Self())
+          printf("planned SFC factor %d in %f seconds\n",
+              multiple, t1 - t0);
+      }
+      return plan;
+    }
+  private:
+    apf::Mesh* mesh;
+    bool sync;
+};
+
+class SfcBalancer : public apf::Balancer
+{
+  public:
+    SfcBalancer(apf::Mesh* m, int v)
+    {
+      mesh = m;
+      verbose = v;
+    }
+    virtual ~SfcBalancer() {}
+    virtual void balance(apf::MeshTag* weights, double tolerance)
+    {
+      double t0 = PCU_Time();
+      Curve c;
+      buildCurve(mesh, weights, true, c);
+      double local = getWeight(c.items);
+      double total = PCU_Add_Double(local);
+      double max = PCU_Max_Double(local);
+      double imbalance = 1;
+      if (total > 0)
+        imbalance = max / (total / PCU_Comm_Peers());
+      if (imbalance <= tolerance) {
+        if (verbose && !PCU_Comm_Self())
+          printf("SFC skipped, imbalance %f is within %f\n",
+              imbalance, tolerance);
+        return;
+      }
+      std::vector<int> parts;
+      cutGlobalCurve(c, parts);
+      int self = PCU_Comm_Self();
+      apf::Migration* plan = new apf::Migration(mesh);
+      for (size_t i = 0; i < c.elems.size(); ++i)
+        if (parts[i] != self)
+          plan->send(c.elems[i], parts[i]);
+      plan = apf::remapMigration(plan, weights);
+      if (verbose && !PCU_Comm_Self())
+        printf("planned SFC balance from imbalance %f in %f seconds\n",
+            imbalance, PCU_Time() - t0);
+      mesh->migrate(plan);
+      double t1 = PCU_Time();
+      if (!PCU_Comm_Self())
+        printf("SFC balanced to %f in %f seconds\n", tolerance, t1 - t0);
+    }
+  private:
+    apf::Mesh* mesh;
+    int verbose;
+};
+
+}
+
+apf::Splitter* Parma_MakeSfcSplitter(apf::Mesh* m, bool sync)
+{
+  return new parma::SfcSplitter(m, sync);
+}
+
+apf::Balancer* Parma_MakeSfcBalancer(apf::Mesh* m, int verbosity)
+{
+  return new parma::SfcBalancer(m, verbosity);
+}
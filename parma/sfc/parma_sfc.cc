@@ -0,0 +1,95 @@
+#include "parma_sfc.h"
+#include <cmath>
+
+namespace parma {
+
+static void quantize(SfcBox const& box, double const x[3], unsigned q[3])
+{
+  unsigned const top = (1u << SFC_BITS) - 1;
+  for (int i = 0; i < 3; ++i) {
+    double w = box.hi[i] - box.lo[i];
+    double t = 0;
+    if (w > 0)
+      t = (x[i] - box.lo[i]) / w;
+    if (t < 0)
+      t = 0;
+    if (t > 1)
+      t = 1;
+    q[i] = static_cast<unsigned>(t * top);
+  }
+}
+
+static long interleave(unsigned const q[3])
+{
+  long key = 0;
+  for (int b = SFC_BITS - 1; b >= 0; --b)
+    for (int i = 0; i < 3; ++i)
+      key = (key << 1) | ((q[i] >> b) & 1);
+  return key;
+}
+
+/* J. Skilling, "Programming the Hilbert curve",
+   AIP Conference Proceedings 707, 2004.
+   converts axis coordinates in place into the transposed Hilbert index */
+static void axesToTranspose(unsigned x[3])
+{
+  unsigned const m = 1u << (SFC_BITS - 1);
+  for (unsigned q = m; q > 1; q >>= 1) {
+    unsigned p = q - 1;
+    for (int i = 0; i < 3; ++i) {
+      if (x[i] & q) {
+        x[0] ^= p;
+      } else {
+        unsigned t = (x[0] ^ x[i]) & p;
+        x[0] ^= t;
+        x[i] ^= t;
+      }
+    }
+  }
+  for (int i = 1; i < 3; ++i)
+    x[i] ^= x[i - 1];
+  unsigned t = 0;
+  for (unsigned q = m; q > 1; q >>= 1)
+    if (x[2] & q)
+      t ^= q - 1;
+  for (int i = 0; i < 3; ++i)
+    x[i] ^= t;
+}
+
+long getHilbertKey(SfcBox const& box, double const x[3])
+{
+  unsigned q[3];
+  quantize(box, x, q);
+  axesToTranspose(q);
+  return interleave(q);
+}
+
+bool operator<(SfcItem const& a, SfcItem const& b)
+{
+  if (a.key != b.key)
+    return a.key < b.key;
+  if (a.from != b.from)
+    return a.from < b.from;
+  return a.index < b.index;
+}
+
+void cutCurve(std::vector<SfcItem> const& items, double before,
+    double total, int parts, std::vector<int>& out)
+{
+  out.resize(items.size());
+  double prefix = before;
+  for (size_t i = 0; i < items.size(); ++i) {
+    double mid = prefix + items[i].weight / 2;
+    int part = 0;
+    if (total > 0)
+      part = static_cast<int>(std::floor(mid * parts / total));
+    if (part < 0)
+      part = 0;
+    if (part >= parts)
+      part = parts - 1;
+    out[i] = part;
+    prefix += items[i].weight;
+  }
+}
+
+}
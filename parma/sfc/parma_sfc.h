@@ -0,0 +1,39 @@
+#ifndef PARMA_SFC_H
+#define PARMA_SFC_H
+
+#include <vector>
+
+namespace parma {
+
+/* keys use 21 bits per axis so that they fit a non-negative long
+   and can be reduced with the PCU long collectives */
+enum { SFC_BITS = 21 };
+
+struct SfcBox
+{
+  double lo[3];
+  double hi[3];
+};
+
+/* position of a point along the Hilbert curve through the box */
+long getHilbertKey(SfcBox const& box, double const x[3]);
+
+struct SfcItem
+{
+  long key;
+  double weight;
+  int index;
+  int from;
+};
+
+bool operator<(SfcItem const& a, SfcItem const& b);
+
+/* assigns items, already sorted by key, to (parts) curve segments of
+   equal weight. (before) is the weight that precedes these items
+   along the curve and (total) is the weight of the whole curve */
+void cutCurve(std::vector<SfcItem> const& items, double before,
+    double total, int parts, std::vector<int>& out);
+
+}
+
+#endif
@@ -92,6 +92,7 @@ public:
   pMeshTag ghost_tag;
   std::vector<pMeshEnt> ghost_vec[4];
   std::vector<pMeshEnt> ghosted_vec[4];
+  apf::Exchange* ghost_exchange[4];
 private:
   static pumi* _instance;
 };
@@ -325,6 +326,21 @@ void pumi_ghost_create(pMesh m, Ghosting* plan);
 
 void pumi_ghost_delete (pMesh m);
 
+/*
+refresh tag and field values on existing ghost copies from their owners
+without recreating the ghost copies.
+The first update after ghosting lists the ghost copies of each dimension
+in an apf::Exchange and later updates reuse it,
+so repeated updates move only values. The exchanges are dropped when the
+ghosting changes by pumi_ghost_create, pumi_ghost_createLayer or
+pumi_ghost_delete.
+A tag is removed from a ghost copy whose owner does not have it.
+*/
+void pumi_ghost_update(pMesh m, std::vector<pMeshTag>& tags,
+                       std::vector<pField>& fields);
+void pumi_ghost_updateTag(pMesh m, pMeshTag tag);
+void pumi_ghost_updateField(pField f);
+
 //************************************
 // MISCELLANEOUS
 //************************************
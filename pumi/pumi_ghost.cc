@@ -389,11 +389,23 @@ void ghost_sendEntities(Ghosting* plan, int entDim,
 
 #include "apfNumbering.h"
 #include "apfShape.h"
+
+// the exchanges of pumi_ghost_update list the ghost copies
+static void clearGhostExchange()
+{
+  for (int d=0; d<4; ++d)
+  {
+    apf::destroyExchange(pumi::instance()->ghost_exchange[d]);
+    pumi::instance()->ghost_exchange[d] = NULL;
+  }
+}
+
 // *********************************************************
 void pumi_ghost_create(pMesh m, Ghosting* plan)
 // *********************************************************
 {
   if (PCU_Comm_Peers()==1) return;
+  clearGhostExchange();
  
   std::vector<apf::Field*> fields;
   std::vector<apf::Field*> frozen_fields;
@@ -848,6 +860,7 @@ void pumi_ghost_delete (pMesh m)
 {
   pMeshTag tag = pumi::instance()->ghosted_tag;
   if (!tag) return;
+  clearGhostExchange();
 
   std::vector<apf::Field*> frozen_fields;
   for (int i=0; i<m->countFields(); ++i)
@@ -0,0 +1,209 @@
+/****************************************************************************** 
+
+  (c) 2004-2016 Scientific Computation Research Center, 
+      Rensselaer Polytechnic Institute. All rights reserved.
+  
+  This work is open source software, licensed under the terms of the
+  BSD license as described in the LICENSE file in the top-level directory.
+ 
+*******************************************************************************/
+#include "pumi.h"
+#include <vector>
+#include <PCU.h>
+#include "apf.h"
+#include "apfShape.h"
+#include "apfField.h"
+#include "apfFieldData.h"
+
+template <class T>
+static void packValues(int to, std::vector<T>& values)
+{
+  if (values.size())
+    PCU_Comm_Pack(to, &values[0], values.size()*sizeof(T));
+}
+
+template <class T>
+static void unpackValues(std::vector<T>& values)
+{
+  if (values.size())
+    PCU_Comm_Unpack(&values[0], values.size()*sizeof(T));
+}
+
+// *********************************************************
+static void packTagValue(pMesh m, int to, pMeshEnt e, pMeshTag tag)
+// *********************************************************
+{
+  char has = m->hasTag(e, tag);
+  PCU_COMM_PACK(to, has);
+  if (!has) return;
+  int size = m->getTagSize(tag);
+  switch (m->getTagType(tag))
+  {
+    case apf::Mesh::DOUBLE:
+    {
+      std::vector<double> values(size);
+      m->getDoubleTag(e, tag, &values[0]);
+      packValues(to, values);
+      break;
+    }
+    case apf::Mesh::INT:
+    {
+      std::vector<int> values(size);
+      m->getIntTag(e, tag, &values[0]);
+      packValues(to, values);
+      break;
+    }
+    case apf::Mesh::LONG:
+    {
+      std::vector<long> values(size);
+      m->getLongTag(e, tag, &values[0]);
+      packValues(to, values);
+      break;
+    }
+  }
+}
+
+// *********************************************************
+static void unpackTagValue(pMesh m, pMeshEnt e, pMeshTag tag)
+// *********************************************************
+{
+  char has;
+  PCU_COMM_UNPACK(has);
+  if (!has)
+  {
+    if (m->hasTag(e, tag))
+      m->removeTag(e, tag);
+    return;
+  }
+  int size = m->getTagSize(tag);
+  switch (m->getTagType(tag))
+  {
+    case apf::Mesh::DOUBLE:
+    {
+      std::vector<double> values(size);
+      unpackValues(values);
+      m->setDoubleTag(e, tag, &values[0]);
+      break;
+    }
+    case apf::Mesh::INT:
+    {
+      std::vector<int> values(size);
+      unpackValues(values);
+      m->setIntTag(e, tag, &values[0]);
+      break;
+    }
+    case apf::Mesh::LONG:
+    {
+      std::vector<long> values(size);
+      unpackValues(values);
+      m->setLongTag(e, tag, &values[0]);
+      break;
+    }
+  }
+}
+
+// *********************************************************
+static void packFieldValue(int to, pMeshEnt e, pField f)
+// *********************************************************
+{
+  apf::FieldDataOf<double>* data = f->getData();
+  char has = data->hasEntity(e);
+  PCU_COMM_PACK(to, has);
+  if (!has) return;
+  std::vector<double> values(f->countValuesOn(e));
+  data->get(e, &values[0]);
+  packValues(to, values);
+}
+
+// *********************************************************
+static void unpackFieldValue(pMeshEnt e, pField f)
+// *********************************************************
+{
+  char has;
+  PCU_COMM_UNPACK(has);
+  if (!has) return;
+  std::vector<double> values(f->countValuesOn(e));
+  unpackValues(values);
+  f->getData()->set(e, &values[0]);
+}
+
+// *********************************************************
+static apf::Exchange* getGhostExchange(pMesh m, int d)
+// *********************************************************
+{
+  // the owners list the ghost copies of their entities once
+  // per ghosting, later updates send only values
+  apf::Exchange*& x = pumi::instance()->ghost_exchange[d];
+  if (!x)
+    x = apf::makeExchange(m, d);
+  return x;
+}
+
+// *********************************************************
+void pumi_ghost_update(pMesh m, std::vector<pMeshTag>& tags,
+                       std::vector<pField>& fields)
+// *********************************************************
+{
+  if (PCU_Comm_Peers()==1 || !pumi::instance()->ghosted_tag) return;
+
+  apf::Exchange* exchange[4];
+  for (int d=0; d<4; ++d)
+    exchange[d] = getGhostExchange(m, d);
+
+  std::vector<pField> fields_on[4];
+  for (size_t i=0; i<fields.size(); ++i)
+    for (int d=0; d<4; ++d)
+      if (getShape(fields[i])->hasNodesIn(d))
+        fields_on[d].push_back(fields[i]);
+
+  PCU_Comm_Begin();
+  for (int d=0; d<4; ++d)
+  {
+    APF_ITERATE(std::vector<apf::ExchangePeer>, exchange[d]->peers, pit)
+    {
+      APF_ITERATE(EntityVector, pit->ghosted, it)
+      {
+        for (size_t i=0; i<tags.size(); ++i)
+          packTagValue(m, pit->peer, *it, tags[i]);
+        for (size_t i=0; i<fields_on[d].size(); ++i)
+          packFieldValue(pit->peer, *it, fields_on[d][i]);
+      }
+    }
+  }
+  PCU_Comm_Send();
+  // each message holds the values of all dimensions from one owner part
+  while (PCU_Comm_Receive())
+  {
+    int from = PCU_Comm_Sender();
+    for (int d=0; d<4; ++d)
+    {
+      apf::ExchangePeer* p = exchange[d]->findPeer(from);
+      if (!p) continue;
+      APF_ITERATE(EntityVector, p->ghosts, it)
+      {
+        for (size_t i=0; i<tags.size(); ++i)
+          unpackTagValue(m, *it, tags[i]);
+        for (size_t i=0; i<fields_on[d].size(); ++i)
+          unpackFieldValue(*it, fields_on[d][i]);
+      }
+    }
+  }
+}
+
+// *********************************************************
+void pumi_ghost_updateTag(pMesh m, pMeshTag tag)
+// *********************************************************
+{
+  std::vector<pMeshTag> tags(1, tag);
+  std::vector<pField> fields;
+  pumi_ghost_update(m, tags, fields);
+}
+
+// *********************************************************
+void pumi_ghost_updateField(pField f)
+// *********************************************************
+{
+  std::vector<pMeshTag> tags;
+  std::vector<pField> fields(1, f);
+  pumi_ghost_update(static_cast<pMesh>(getMesh(f)), tags, fields);
+}
@@ -152,6 +152,8 @@ pumi::pumi(): mesh(NULL), model(NULL)
 {
   ghost_tag=NULL;
   ghosted_tag=NULL;
+  for (int d=0; d<4; ++d)
+    ghost_exchange[d]=NULL;
 }
 
 pumi::~pumi()
@@ -15,7 +15,8 @@
 
 #include <mthQR.h>
 
-#include <set>
+#include <algorithm>
+#include <vector>
 #include <pcu_util.h>
 
 namespace spr {
@@ -64,6 +65,9 @@ static apf::Field* makeRecoveredField(Recovery* r)
         r->mesh, name.c_str(), apf::getValueType(r->f), r->order);
 }
 
+/* the most terms of the polynomials below, a quadratic in 3D */
+enum { MAX_POLYNOMIAL_TERMS = 10 };
+
 static int countPolynomialTerms(int dim, int order)
 {
   switch (dim) {
@@ -88,27 +92,42 @@ static void setupRecovery(Recovery* r, apf::Field* f)
   r->f_star = makeRecoveredField(r);
 }
 
+/* the vectors keep their storage from patch to patch,
+   so after the first few patches no memory is allocated */
 struct Samples {
-  Samples():num_points(0) {}
+  Samples():num_points(0),num_components(0) {}
   void allocate(int np, int nc)
   {
     num_points = np;
-    points.allocate(np);
-    values.allocate(np);
-    for (int i=0; i < np; ++i)
-      values[i].allocate(nc);
+    num_components = nc;
+    points.resize(np);
+    values.resize(np * nc);
   }
   int num_points;
-  apf::NewArray<apf::Vector3> points;
-  apf::NewArray<apf::NewArray<double> > values;
+  int num_components;
+  std::vector<apf::Vector3> points;
+  /* component c of point i is at i * num_components + c */
+  std::vector<double> values;
 };
 
+/* the fit matrix stored by columns and overwritten
+   by mth::decomposeHouseholder */
 struct QRDecomp {
-  mth::Matrix<double> Q;
-  mth::Matrix<double> R;
+  std::vector<double> a;
+  double tau[MAX_POLYNOMIAL_TERMS];
+  /* scratch right hand side */
+  std::vector<double> b;
 };
 
-typedef std::set<apf::MeshEntity*> EntitySet;
+/* sorted by pointer and free of duplicates,
+   the same order a std::set would keep */
+typedef std::vector<apf::MeshEntity*> EntitySet;
+
+static void makeUnique(EntitySet& s)
+{
+  std::sort(s.begin(), s.end());
+  s.erase(std::unique(s.begin(), s.end()), s.end());
+}
 
 struct Patch {
   apf::Mesh* mesh;
@@ -142,15 +161,10 @@ static int countPatchPoints(Patch* p)
   return p->recovery->points_per_element * p->elements.size();
 }
 
-static void addElementToPatch(Patch* p, apf::MeshEntity* e)
-{
-  p->elements.insert(e);
-}
-
 static void addElementsToPatch(Patch* p, apf::DynamicArray<apf::MeshEntity*>& es)
 {
   for (std::size_t i=0; i < es.getSize(); ++i)
-    addElementToPatch(p, es[i]);
+    p->elements.push_back(es[i]);
 }
 
 static bool getInitialPatch(Patch* p, apf::CavityOp* o)
@@ -160,6 +174,7 @@ static bool getInitialPatch(Patch* p, apf::CavityOp* o)
   apf::DynamicArray<apf::MeshEntity*> adjacent;
   p->mesh->getAdjacent(p->entity, p->recovery->dim, adjacent);
   addElementsToPatch(p, adjacent);
+  makeUnique(p->elements);
   return true;
 }
 
@@ -172,19 +187,18 @@ static bool addElementsThatShare(Patch* p, int dim,
     apf::Downward down;
     int nd = p->mesh->getDownward(*it, dim, down);
     for (int i=0; i < nd; ++i)
-      bridges.insert(down[i]);
+      bridges.push_back(down[i]);
   }
-  std::vector<apf::MeshEntity*> 
-    bridge_array(bridges.begin(),bridges.end());
-  bridges.clear();
-  if ( ! o->requestLocality(&(bridge_array[0]),bridge_array.size()))
+  makeUnique(bridges);
+  if ( ! o->requestLocality(&(bridges[0]),bridges.size()))
     return false;
-  for (size_t i=0; i < bridge_array.size(); ++i)
+  for (size_t i=0; i < bridges.size(); ++i)
   {
     apf::Adjacent candidates;
-    p->mesh->getAdjacent(bridge_array[i], p->recovery->dim, candidates);
+    p->mesh->getAdjacent(bridges[i], p->recovery->dim, candidates);
     addElementsToPatch(p, candidates);
   }
+  makeUnique(p->elements);
   return true;
 }
 
@@ -218,7 +232,7 @@ static void getSampleValues(Patch* p)
   std::size_t i = 0;
   APF_ITERATE(EntitySet, p->elements, it) {
     for (int l = 0; l < r->points_per_element; ++l) {
-      apf::getComponents(r->f, *it, l, &(s->values[i][0]));
+      apf::getComponents(r->f, *it, l, &(s->values[i * s->num_components]));
       ++i;
     }
   }
@@ -227,26 +241,24 @@ static void getSampleValues(Patch* p)
 static void evalPolynomialTerms(
     int dim, int order,
     apf::Vector3 const& point,
-    mth::Vector<double>& terms)
+    double* terms)
 {
   apf::Vector3 const& x = point;
   switch (dim) {
   case 2:
     switch (order) {
     case 1:
-      terms.resize(3);
-      terms(0) = 1.0;
-      terms(1) = x[0];
-      terms(2) = x[1];
+      terms[0] = 1.0;
+      terms[1] = x[0];
+      terms[2] = x[1];
       return;
     case 2:
-      terms.resize(6);
-      terms(0) = 1.0;
-      terms(1) = x[0];
-      terms(2) = x[1];
-      terms(3) = x[0]*x[1];
-      terms(4) = x[0]*x[0];
-      terms(5) = x[1]*x[1];
+      terms[0] = 1.0;
+      terms[1] = x[0];
+      terms[2] = x[1];
+      terms[3] = x[0]*x[1];
+      terms[4] = x[0]*x[0];
+      terms[5] = x[1]*x[1];
       return;
     default:
       apf::fail("SPR: invalid 2D polynomial order");
@@ -254,24 +266,22 @@ static void evalPolynomialTerms(
   case 3:
     switch (order) {
     case 1:
-      terms.resize(4);
-      terms(0) = 1.0;
-      terms(1) = x[0];
-      terms(2) = x[1];
-      terms(3) = x[2];
+      terms[0] = 1.0;
+      terms[1] = x[0];
+      terms[2] = x[1];
+      terms[3] = x[2];
       return;
     case 2:
-      terms.resize(10);
-      terms(0) = 1.0;
-      terms(1) = x[0];
-      terms(2) = x[1];
-      terms(3) = x[2];
-      terms(4) = x[0]*x[1];
-      terms(5) = x[1]*x[2];
-      terms(6) = x[2]*x[0];
-      terms(7) = x[0]*x[0];
-      terms(8) = x[1]*x[1];
-      terms(9) = x[2]*x[2];
+      terms[0] = 1.0;
+      terms[1] = x[0];
+      terms[2] = x[1];
+      terms[3] = x[2];
+      terms[4] = x[0]*x[1];
+      terms[5] = x[1]*x[2];
+      terms[6] = x[2]*x[0];
+      terms[7] = x[0]*x[0];
+      terms[8] = x[1]*x[1];
+      terms[9] = x[2]*x[2];
       return;
     default:
       apf::fail("SPR: invalid 3D polynomial order");
@@ -281,40 +291,65 @@ static void evalPolynomialTerms(
   }
 }
 
+/* the QR kernels have a fixed number of columns,
+   one for each polynomial of a given dimension and order */
+static unsigned decomposeFit(unsigned n, unsigned m, double* a, double* tau)
+{
+  switch (n) {
+    case 3: return mth::decomposeHouseholder<3>(m, a, tau);
+    case 4: return mth::decomposeHouseholder<4>(m, a, tau);
+    case 6: return mth::decomposeHouseholder<6>(m, a, tau);
+    case 10: return mth::decomposeHouseholder<10>(m, a, tau);
+    default:
+      apf::fail("SPR: invalid number of polynomial terms");
+      return 0;
+  }
+}
+
+static void solveFit(unsigned n, unsigned m, double const* a,
+    double const* tau, double* b, double* x)
+{
+  switch (n) {
+    case 3: mth::solveHouseholder<3>(m, a, tau, b, x); return;
+    case 4: mth::solveHouseholder<4>(m, a, tau, b, x); return;
+    case 6: mth::solveHouseholder<6>(m, a, tau, b, x); return;
+    case 10: mth::solveHouseholder<10>(m, a, tau, b, x); return;
+    default:
+      apf::fail("SPR: invalid number of polynomial terms");
+  }
+}
+
 static bool preparePolynomialFit(
     int dim,
     int order,
     int num_points,
-    apf::NewArray<apf::Vector3> const& points,
+    std::vector<apf::Vector3> const& points,
     QRDecomp& qr)
 {
   unsigned m = num_points;
   unsigned n = countPolynomialTerms(dim, order);
   PCU_ALWAYS_ASSERT(m >= n);
-  mth::Matrix<double> A(m,n);
-  mth::Vector<double> p;
+  qr.a.resize(m * n);
+  double p[MAX_POLYNOMIAL_TERMS];
   for (unsigned i = 0; i < m; ++i) {
     evalPolynomialTerms(dim, order, points[i], p);
-    for (unsigned j = 0; j < p.size(); ++j)
-      A(i,j) = p(j);
+    for (unsigned j = 0; j < n; ++j)
+      qr.a[j * m + i] = p[j];
   }
-  unsigned rank = mth::decomposeQR(A, qr.Q, qr.R);
-  return rank == A.cols();
-}
-
-static void runPolynomialFit(QRDecomp const& qr,
-                             mth::Vector<double> const& values,
-                             mth::Vector<double>& coeffs)
-{
-  mth::solveFromQR(qr.Q, qr.R, values, coeffs);
+  unsigned rank = decomposeFit(n, m, &qr.a[0], qr.tau);
+  return rank == n;
 }
 
 static double evalPolynomial(int dim, int order, apf::Vector3& point,
-    mth::Vector<double>& coeffs)
+    double const* coeffs)
 {
-  mth::Vector<double> terms;
+  double terms[MAX_POLYNOMIAL_TERMS];
   evalPolynomialTerms(dim, order, point, terms);
-  return coeffs * terms;
+  int n = countPolynomialTerms(dim, order);
+  double value = 0;
+  for (int i = 0; i < n; ++i)
+    value += coeffs[i] * terms[i];
+  return value;
 }
 
 static bool prepareSpr(Patch* p)
@@ -333,24 +368,25 @@ static void runSpr(Patch* p)
   getSampleValues(p);
   int num_components = apf::countComponents(r->f_star);
   int num_nodes = m->getShape()->countNodesOn(m->getType(p->entity));
-  mth::Vector<double> values(s->num_points);
+  int n = r->polynomial_terms;
   apf::NewArray<apf::Vector3> nodal_points(num_nodes);
-  apf::NewArray<apf::NewArray<double> > recovered_values(num_nodes);
-  for (int i = 0; i < num_nodes; ++i) {
-    recovered_values[i].allocate(num_components);
+  apf::NewArray<double> recovered_values(num_nodes * num_components);
+  for (int i = 0; i < num_nodes; ++i)
     m->getPoint(p->entity, i, nodal_points[i]);
-  }
+  std::vector<double>& values = p->qr.b;
+  values.resize(s->num_points);
   for (int i = 0; i < num_components; ++i) {
     for (int j = 0; j < s->num_points; ++j)
-      values(j) = s->values[j][i];
-    mth::Vector<double> coeffs;
-    runPolynomialFit(p->qr, values, coeffs);
+      values[j] = s->values[j * s->num_components + i];
+    double coeffs[MAX_POLYNOMIAL_TERMS];
+    solveFit(n, s->num_points, &p->qr.a[0], p->qr.tau, &values[0], coeffs);
     for (int j = 0; j < num_nodes; ++j)
-      recovered_values[j][i] = evalPolynomial(
+      recovered_values[j * num_components + i] = evalPolynomial(
           r->dim, r->order, nodal_points[j], coeffs);
   }
   for (int i = 0; i < num_nodes; ++i)
-    apf::setComponents(r->f_star, p->entity, i, &(recovered_values[i][0]));
+    apf::setComponents(r->f_star, p->entity, i,
+        &(recovered_values[i * num_components]));
 }
 
 static bool hasEnoughPoints(Patch* p)
@@ -0,0 +1,160 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfShape.h>
+#include <gmi.h>
+#include <pumi.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+#include "parallelBox.h"
+
+namespace {
+
+/* values differ on every part so the sums depend on their order */
+double fn(apf::Mesh* m, apf::MeshEntity* e, int node)
+{
+  apf::Vector3 x = apf::getLinearCentroid(m, e);
+  return std::sin(x[0] + 2 * x[1] + 3 * x[2] + node + PCU_Comm_Self()) / 3;
+}
+
+apf::Field* makeField(apf::Mesh* m, const char* name, apf::FieldShape* s,
+    bool ones)
+{
+  apf::Field* f = apf::createField(m, name, apf::SCALAR, s);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it)))
+      for (int i = 0; i < s->countNodesOn(m->getType(e)); ++i)
+        apf::setScalar(f, e, i, ones ? 1 : fn(m, e, i));
+    m->end(it);
+  }
+  return f;
+}
+
+void expectEqual(apf::Mesh* m, apf::Field* a, apf::Field* b, double tol)
+{
+  apf::FieldShape* s = apf::getShape(a);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it)))
+      for (int i = 0; i < s->countNodesOn(m->getType(e)); ++i)
+        PCU_ALWAYS_ASSERT(std::fabs(apf::getScalar(a, e, i) -
+              apf::getScalar(b, e, i)) <= tol);
+    m->end(it);
+  }
+}
+
+/* the exchange gives the sums of the Sharing based accumulate,
+   exactly so when adding in part order as PCU delivers by default */
+void testSums(apf::Mesh* m, apf::FieldShape* s)
+{
+  apf::Field* expected = makeField(m, "expected", s, false);
+  apf::accumulate(expected);
+  apf::Exchange* x = apf::makeExchange(expected);
+  apf::Field* f = makeField(m, "exchange", s, false);
+  apf::accumulate(f, x);
+  expectEqual(m, f, expected, 1e-14);
+  apf::destroyField(f);
+  f = makeField(m, "deterministic", s, false);
+  apf::accumulate(f, x, false, true);
+  expectEqual(m, f, expected, 0);
+  apf::destroyField(f);
+  apf::destroyExchange(x);
+  apf::destroyField(expected);
+}
+
+/* accumulating ones counts the copies of each owned entity,
+   including ghosts when they contribute, and every copy and
+   ghost receives the owner's count */
+void testCounts(apf::Mesh* m, apf::FieldShape* s, bool ghosts)
+{
+  apf::Field* f = makeField(m, "counts", s, true);
+  apf::Exchange* x = apf::makeExchange(f);
+  apf::accumulate(f, x, ghosts);
+  apf::destroyExchange(x);
+  PCU_Comm_Begin();
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      int nn = s->countNodesOn(m->getType(e));
+      if (!nn || m->isGhost(e) || !m->isOwned(e))
+        continue;
+      apf::Copies remotes;
+      apf::Copies ghostCopies;
+      m->getRemotes(e, remotes);
+      m->getGhosts(e, ghostCopies);
+      double count = 1 + remotes.size();
+      if (ghosts)
+        count += ghostCopies.size();
+      for (int i = 0; i < nn; ++i)
+        PCU_ALWAYS_ASSERT(apf::getScalar(f, e, i) == count);
+      APF_ITERATE(apf::Copies, remotes, rit) {
+        PCU_COMM_PACK(rit->first, rit->second);
+        PCU_COMM_PACK(rit->first, count);
+      }
+      APF_ITERATE(apf::Copies, ghostCopies, git) {
+        PCU_COMM_PACK(git->first, git->second);
+        PCU_COMM_PACK(git->first, count);
+      }
+    }
+    m->end(it);
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    apf::MeshEntity* e;
+    double count;
+    PCU_COMM_UNPACK(e);
+    PCU_COMM_UNPACK(count);
+    for (int i = 0; i < s->countNodesOn(m->getType(e)); ++i)
+      PCU_ALWAYS_ASSERT(apf::getScalar(f, e, i) == count);
+  }
+  apf::destroyField(f);
+}
+
+long countGhosts(apf::Mesh* m)
+{
+  long n = 0;
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it)))
+    if (m->isGhost(e))
+      ++n;
+  m->end(it);
+  return n;
+}
+
+void test(apf::Mesh* m, apf::FieldShape* s)
+{
+  testSums(m, s);
+  testCounts(m, s, false);
+  testCounts(m, s, true);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(4, 4, 4, &g);
+  test(m, m->getShape());
+  test(m, apf::getLagrange(2));
+  /* pumi ghosting works on the mesh it holds */
+  pumi::instance()->mesh = m;
+  pumi_ghost_createLayer(m, 0, m->getDimension(), 1, 1);
+  if (PCU_Comm_Peers() > 1)
+    PCU_ALWAYS_ASSERT(PCU_Add_Long(countGhosts(m)) > 0);
+  test(m, m->getShape());
+  test(m, apf::getLagrange(2));
+  pumi_ghost_delete(m);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,103 @@
+#include <crv.h>
+#include <crvBezier.h>
+#include <crvBezierShapes.h>
+#include <apfMesh.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+
+/* times the Bezier basis values and gradients of orders 1 to 6
+   and checks that they are a partition of unity whose gradients
+   agree with finite differences of the values */
+
+namespace {
+
+int const types[3] = {apf::Mesh::EDGE, apf::Mesh::TRIANGLE, apf::Mesh::TET};
+
+apf::Vector3 getPoint(int type)
+{
+  double x = double(rand()) / RAND_MAX;
+  double y = double(rand()) / RAND_MAX;
+  double z = double(rand()) / RAND_MAX;
+  if (type == apf::Mesh::EDGE)
+    return apf::Vector3(2 * x - 1, 0, 0);
+  if (type == apf::Mesh::TRIANGLE)
+    return apf::Vector3(x, y, 0) * (1. / (1 + x + y + z));
+  return apf::Vector3(x, y, z) * (1. / (1 + x + y + z));
+}
+
+void check(int type, int P)
+{
+  int n = crv::getNumControlPoints(type, P);
+  int dim = apf::Mesh::typeDimension[type];
+  apf::NewArray<double> values(n);
+  apf::NewArray<double> plus(n);
+  apf::NewArray<double> minus(n);
+  apf::NewArray<apf::Vector3> grads(n);
+  double h = 1e-6;
+  for (int s = 0; s < 10; ++s) {
+    apf::Vector3 xi = getPoint(type);
+    crv::bezier[type](P, xi, values);
+    crv::bezierGrads[type](P, xi, grads);
+    double sum = 0;
+    apf::Vector3 gsum(0, 0, 0);
+    for (int i = 0; i < n; ++i) {
+      sum += values[i];
+      gsum += grads[i];
+    }
+    PCU_ALWAYS_ASSERT(std::fabs(sum - 1) < 1e-13);
+    PCU_ALWAYS_ASSERT(gsum.getLength() < 1e-11);
+    for (int d = 0; d < dim; ++d) {
+      apf::Vector3 dx(0, 0, 0);
+      dx[d] = h;
+      crv::bezier[type](P, xi + dx, plus);
+      crv::bezier[type](P, xi - dx, minus);
+      for (int i = 0; i < n; ++i)
+        PCU_ALWAYS_ASSERT(std::fabs((plus[i] - minus[i]) / (2 * h)
+              - grads[i][d]) < 1e-6);
+    }
+  }
+}
+
+void time(int type, int P, int iterations)
+{
+  int n = crv::getNumControlPoints(type, P);
+  apf::NewArray<double> values(n);
+  apf::NewArray<apf::Vector3> grads(n);
+  apf::Vector3 xi = getPoint(type);
+  double sum = 0;
+  double t0 = PCU_Time();
+  for (int i = 0; i < iterations; ++i) {
+    crv::bezier[type](P, xi, values);
+    sum += values[i % n];
+  }
+  double t1 = PCU_Time();
+  for (int i = 0; i < iterations; ++i) {
+    crv::bezierGrads[type](P, xi, grads);
+    sum += grads[i % n][0];
+  }
+  double t2 = PCU_Time();
+  printf("%s order %d: values %f us, gradients %f us (checksum %g)\n",
+      apf::Mesh::typeName[type], P, (t1 - t0) / iterations * 1e6,
+      (t2 - t1) / iterations * 1e6, sum);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 2);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  int iterations = atoi(argv[1]);
+  for (int t = 0; t < 3; ++t)
+    for (int P = 1; P <= 6; ++P) {
+      check(types[t], P);
+      time(types[t], P, iterations);
+    }
+  PCU_Comm_Free();
+  MPI_Finalize();
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfShape.h>
+#include <apfBlockIntegrator.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+
+namespace {
+
+void fn(apf::Vector3 const& x, apf::Vector3& v)
+{
+  v[0] = x[0] * x[0] + 2 * x[1] * x[2] - x[2];
+  v[1] = x[0] - 3 * x[1];
+  v[2] = x[0] * x[1];
+}
+
+apf::Field* makeField(apf::Mesh* m, apf::FieldShape* s)
+{
+  apf::Field* f = apf::createField(m, "f", apf::VECTOR, s);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    if (!s->hasNodesIn(d))
+      continue;
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      int n = s->countNodesOn(m->getType(e));
+      for (int i = 0; i < n; ++i) {
+        apf::Vector3 xi, x, v;
+        s->getNodeXi(m->getType(e), i, xi);
+        apf::MeshElement* me = apf::createMeshElement(m, e);
+        apf::mapLocalToGlobal(me, xi, x);
+        apf::destroyMeshElement(me);
+        fn(x, v);
+        apf::setVector(f, e, i, v);
+      }
+    }
+    m->end(it);
+  }
+  return f;
+}
+
+enum { VOLUME, VALUE, GRAD, MOMENT, RESULTS };
+
+/* integrates the volume, the field components, the squared gradient
+   and the field dotted with the coordinates one element at a time */
+class Reference : public apf::Integrator
+{
+  public:
+    Reference(apf::Field* field, int order):
+      apf::Integrator(order), f(field), e(0), me(0)
+    {
+      for (int i = 0; i < RESULTS; ++i)
+        r[i] = 0;
+    }
+    void inElement(apf::MeshElement* m)
+    {
+      me = m;
+      e = apf::createElement(f, me);
+    }
+    void outElement()
+    {
+      apf::destroyElement(e);
+    }
+    void atPoint(apf::Vector3 const& p, double w, double dV)
+    {
+      apf::Vector3 v;
+      apf::getVector(e, p, v);
+      apf::Matrix3x3 g;
+      apf::getVectorGrad(e, p, g);
+      apf::Vector3 x;
+      apf::mapLocalToGlobal(me, p, x);
+      r[VOLUME] += w * dV;
+      r[VALUE] += (v[0] + v[1] + v[2]) * w * dV;
+      for (int i = 0; i < 3; ++i)
+        r[GRAD] += (g[i] * g[i]) * w * dV;
+      r[MOMENT] += (v * x) * w * dV;
+    }
+    apf::Field* f;
+    apf::Element* e;
+    apf::MeshElement* me;
+    double r[RESULTS];
+};
+
+class Blocked : public apf::BlockIntegrator
+{
+  public:
+    Blocked(apf::Field* f, int order):
+      apf::BlockIntegrator(order, 7)
+    {
+      field = addField(f);
+      for (int i = 0; i < RESULTS; ++i)
+        r[i] = 0;
+    }
+    void atBlock(apf::IntegrationBlock const& b)
+    {
+      int n = b.count();
+      int s = b.getStride();
+      for (int p = 0; p < b.countPoints(); ++p) {
+        double w = b.getWeight(p);
+        double const* dV = b.getDV(p);
+        double const* v = b.getValues(field, p);
+        double const* g = b.getGrads(field, p);
+        double const* x = b.getCoordinates(p);
+        for (int e = 0; e < n; ++e) {
+          double wdV = w * dV[e];
+          r[VOLUME] += wdV;
+          r[VALUE] += (v[e] + v[s + e] + v[2 * s + e]) * wdV;
+          for (int i = 0; i < 9; ++i)
+            r[GRAD] += g[i * s + e] * g[i * s + e] * wdV;
+          for (int i = 0; i < 3; ++i)
+            r[MOMENT] += v[i * s + e] * x[i * s + e] * wdV;
+        }
+      }
+    }
+    int field;
+    double r[RESULTS];
+};
+
+void check(apf::Mesh* m, apf::FieldShape* s, int order)
+{
+  apf::Field* f = makeField(m, s);
+  Reference reference(f, order);
+  reference.process(m);
+  Blocked blocked(f, order);
+  blocked.process(m);
+  for (int i = 0; i < RESULTS; ++i)
+    PCU_ALWAYS_ASSERT(std::fabs(reference.r[i] - blocked.r[i]) <
+        1e-12 * (1 + std::fabs(reference.r[i])));
+  apf::destroyField(f);
+}
+
+void test(int dim, bool simplex)
+{
+  int nz = dim == 3 ? 3 : 0;
+  apf::Mesh2* m = apf::makeMdsBox(4, 3, nz, 2, 1, 1, simplex);
+  /* skew the box so that the Jacobians are not diagonal */
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* v;
+  while ((v = m->iterate(it))) {
+    apf::Vector3 x;
+    m->getPoint(v, 0, x);
+    x[0] += 0.3 * x[1] + 0.1 * x[2] * x[2];
+    x[1] += 0.2 * x[2];
+    m->setPoint(v, 0, x);
+  }
+  m->end(it);
+  int order = (dim == 3 && !simplex) ? 3 : 4;
+  check(m, apf::getLagrange(1), order);
+  if (simplex || dim == 2)
+    check(m, apf::getLagrange(2), order);
+  if (dim == 2 && !simplex)
+    check(m, apf::getSerendipity(), order);
+  m->destroyNative();
+  apf::destroyMesh(m);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 1);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  test(2, true);
+  test(2, false);
+  test(3, true);
+  test(3, false);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
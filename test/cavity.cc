@@ -0,0 +1,80 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfCavityOp.h>
+#include <gmi.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parallelBox.h"
+
+namespace {
+
+/* applies once to every vertex, after pulling
+   all its adjacent elements onto one part */
+class VertexOp : public apf::CavityOp
+{
+  public:
+    VertexOp(apf::Mesh* m, bool canModify, bool incremental):
+      apf::CavityOp(m, canModify, incremental),
+      applied(0)
+    {
+      done = m->createIntTag("cavity_done", 1);
+    }
+    ~VertexOp()
+    {
+      apf::removeTagFromDimension(mesh, done, 0);
+      mesh->destroyTag(done);
+    }
+    Outcome setEntity(apf::MeshEntity* e)
+    {
+      if (mesh->hasTag(e, done))
+        return SKIP;
+      if ( ! requestLocality(&e, 1))
+        return REQUEST;
+      vertex = e;
+      return OK;
+    }
+    void apply()
+    {
+      PCU_ALWAYS_ASSERT(sharing->isOwned(vertex));
+      PCU_ALWAYS_ASSERT( ! mesh->hasTag(vertex, done));
+      int dummy = 1;
+      mesh->setIntTag(vertex, done, &dummy);
+      ++applied;
+    }
+    long applied;
+  private:
+    apf::MeshTag* done;
+    apf::MeshEntity* vertex;
+};
+
+/* every vertex is applied exactly once across all parts */
+void test(apf::Mesh* m, bool canModify, bool incremental)
+{
+  VertexOp op(m, canModify, incremental);
+  op.applyToDimension(0);
+  long expected = apf::countOwned(m, 0);
+  PCU_ALWAYS_ASSERT(PCU_Add_Long(op.applied) == PCU_Add_Long(expected));
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(6, 6, 6, &g);
+  /* each run migrates the mesh, so later runs
+     start from a different partition */
+  test(m, false, false);
+  test(m, false, true);
+  test(m, true, true);
+  test(m, true, false);
+  m->verify();
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
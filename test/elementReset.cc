@@ -0,0 +1,138 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfShape.h>
+#include <PCU.h>
+#include <pcu_util.h>
+
+namespace {
+
+apf::Field* makeField(apf::Mesh* m)
+{
+  apf::FieldShape* s = apf::getLagrange(2);
+  apf::Field* f = apf::createField(m, "f", apf::SCALAR, s);
+  for (int d = 0; d <= 1; ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      apf::Vector3 x;
+      if (d == 0)
+        m->getPoint(e, 0, x);
+      else
+        x = apf::getLinearCentroid(m, e);
+      apf::setScalar(f, e, 0, x[0] * x[1] + x[2] * x[2]);
+    }
+    m->end(it);
+  }
+  return f;
+}
+
+/* reports the value and gradient of a fresh element at the center */
+void evaluate(apf::Mesh* m, apf::Field* f, apf::MeshEntity* e,
+    double& v, apf::Vector3& g, apf::Vector3& x)
+{
+  apf::Vector3 xi(0.25, 0.25, 0.25);
+  apf::MeshElement* me = apf::createMeshElement(m, e);
+  apf::Element* fe = apf::createElement(f, me);
+  v = apf::getScalar(fe, xi);
+  apf::getGrad(fe, xi, g);
+  apf::mapLocalToGlobal(me, xi, x);
+  apf::destroyElement(fe);
+  apf::destroyMeshElement(me);
+}
+
+/* elements rebound to other entities, including entities of another
+   type, evaluate the same as new ones */
+void checkReset(apf::Mesh2* m, apf::Field* f)
+{
+  apf::Vector3 xi(0.25, 0.25, 0.25);
+  apf::MeshEntity* first = apf::getMdsEntity(m, 3, 0);
+  apf::MeshElement* me = apf::createMeshElement(m, first);
+  apf::Element* fe = apf::createElement(f, me);
+  apf::Element* plain = apf::createElement(f, first);
+  for (int d = 3; d >= 1; d -= 2) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      apf::resetMeshElement(me, e);
+      apf::resetElement(fe, me);
+      apf::resetElement(plain, e);
+      double v;
+      apf::Vector3 g, x;
+      evaluate(m, f, e, v, g, x);
+      PCU_ALWAYS_ASSERT(apf::getScalar(fe, xi) == v);
+      PCU_ALWAYS_ASSERT(apf::getMeshEntity(me) == e);
+      apf::Vector3 g2, x2;
+      apf::getGrad(fe, xi, g2);
+      PCU_ALWAYS_ASSERT((g2 - g).getLength() == 0);
+      apf::mapLocalToGlobal(me, xi, x2);
+      PCU_ALWAYS_ASSERT((x2 - x).getLength() == 0);
+      double c[1];
+      apf::getComponents(plain, xi, c);
+      PCU_ALWAYS_ASSERT(c[0] == v);
+    }
+    m->end(it);
+  }
+  apf::destroyElement(plain);
+  apf::destroyElement(fe);
+  apf::destroyMeshElement(me);
+}
+
+/* destroyed elements are handed out again by the next create */
+void checkReuse(apf::Mesh2* m, apf::Field* f)
+{
+  apf::MeshEntity* e = apf::getMdsEntity(m, 3, 0);
+  apf::MeshElement* me = apf::createMeshElement(m, e);
+  apf::Element* fe = apf::createElement(f, me);
+  apf::destroyElement(fe);
+  apf::destroyMeshElement(me);
+  apf::MeshEntity* e2 = apf::getMdsEntity(m, 3, 1);
+  apf::MeshElement* me2 = apf::createMeshElement(m, e2);
+  apf::Element* fe2 = apf::createElement(f, me2);
+  PCU_ALWAYS_ASSERT(me2 == me);
+  PCU_ALWAYS_ASSERT(fe2 == fe);
+  PCU_ALWAYS_ASSERT(apf::getMeshElement(fe2) == me2);
+  PCU_ALWAYS_ASSERT(apf::getMeshEntity(me2) == e2);
+  apf::destroyElement(fe2);
+  apf::destroyMeshElement(me2);
+}
+
+/* elements may outlive their field and the coordinate field
+   they were created on, destroying them then frees them */
+void checkOutlive(apf::Mesh2* m)
+{
+  apf::MeshEntity* e = apf::getMdsEntity(m, 3, 0);
+  apf::Field* f = makeField(m);
+  apf::MeshElement* me = apf::createMeshElement(m, e);
+  apf::Element* fe = apf::createElement(f, me);
+  apf::Element* plain = apf::createElement(f, e);
+  apf::MeshElement* pooled = apf::createMeshElement(m, e);
+  apf::destroyMeshElement(pooled);
+  apf::destroyField(f);
+  apf::destroyElement(plain);
+  apf::destroyElement(fe);
+  m->changeShape(apf::getLagrange(1), true);
+  apf::destroyMeshElement(me);
+  me = apf::createMeshElement(m, e);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  apf::destroyMeshElement(me);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 1);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  apf::Mesh2* m = apf::makeMdsBox(3, 3, 3, 1, 1, 1, true);
+  apf::Field* f = makeField(m);
+  checkReset(m, f);
+  checkReuse(m, f);
+  apf::destroyField(f);
+  checkOutlive(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
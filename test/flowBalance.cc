@@ -0,0 +1,95 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <parma.h>
+#include <parma_balancer.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cstdio>
+#include "parallelBox.h"
+
+namespace {
+
+double const tolerance = 1.05;
+
+/* RIB balances a weight that grows toward the x = y = 1 edge,
+   which leaves the uniform weights of the returned tag
+   badly imbalanced */
+apf::Mesh2* makeImbalancedBox(gmi_model** g, apf::MeshTag** w)
+{
+  apf::Mesh2* m = makeExpandedBox(12, 12, 12, g);
+  int dim = m->getDimension();
+  apf::MeshTag* graded = m->createDoubleTag("graded", 1);
+  apf::MeshIterator* it = m->begin(dim);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    apf::Vector3 c = apf::getLinearCentroid(m, e);
+    double x = 1 + 9 * c[0] * c[0] * c[1] * c[1];
+    m->setDoubleTag(e, graded, &x);
+  }
+  m->end(it);
+  apf::Balancer* b = Parma_MakeRibBalancer(m);
+  b->balance(graded, 1.01);
+  delete b;
+  apf::removeTagFromDimension(m, graded, dim);
+  m->destroyTag(graded);
+  *w = m->createDoubleTag("uniform", 1);
+  double one = 1;
+  for (int d = 0; d <= dim; ++d) {
+    it = m->begin(d);
+    while ((e = m->iterate(it)))
+      m->setDoubleTag(e, *w, &one);
+    m->end(it);
+  }
+  return m;
+}
+
+/* the imbalance of dimension (dim) after at most (steps) steps */
+double run(bool flow, int dim, int steps)
+{
+  gmi_model* g;
+  apf::MeshTag* w;
+  apf::Mesh2* m = makeImbalancedBox(&g, &w);
+  double before = Parma_GetWeightedEntImbalance(m, w, dim);
+  PCU_ALWAYS_ASSERT(before > 1.2);
+  apf::Balancer* b;
+  if (dim)
+    b = flow ? Parma_MakeElmFlowBalancer(m) : Parma_MakeElmBalancer(m);
+  else
+    b = flow ? Parma_MakeVtxFlowBalancer(m) : Parma_MakeVtxBalancer(m);
+  static_cast<parma::Balancer*>(b)->maxStep = steps;
+  b->balance(w, tolerance);
+  delete b;
+  double after = Parma_GetWeightedEntImbalance(m, w, dim);
+  if (!PCU_Comm_Self())
+    printf("%s dimension %d: imbalance %f to %f\n",
+        flow ? "flow" : "step factor", dim, before, after);
+  for (int d = 0; d <= m->getDimension(); ++d)
+    apf::removeTagFromDimension(m, w, d);
+  m->destroyTag(w);
+  m->verify();
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  return after;
+}
+
+}
+
+/* planning the migrations from the part graph reaches the
+   tolerance within a few steps, where the step factor
+   balancers are still far from it */
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  int const steps = 8;
+  int dims[2] = {3, 0};
+  for (int i = 0; i < 2; ++i) {
+    PCU_ALWAYS_ASSERT(run(true, dims[i], steps) <= tolerance);
+    PCU_ALWAYS_ASSERT(run(false, dims[i], steps) > tolerance);
+  }
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
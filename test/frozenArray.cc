@@ -0,0 +1,109 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfShape.h>
+#include <apfNumbering.h>
+#include <PCU.h>
+#include <pcu_util.h>
+
+namespace {
+
+apf::Vector3 fn(apf::MeshEntity* e, int d, int node)
+{
+  double x = d * 1000 + node;
+  double y = reinterpret_cast<std::size_t>(e) % 997;
+  return apf::Vector3(x, y, x - y);
+}
+
+apf::Field* makeField(apf::Mesh* m)
+{
+  apf::Field* f = apf::createField(m, "f", apf::VECTOR,
+      apf::getLagrange(2));
+  for (int d = 0; d <= 1; ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it)))
+      apf::setVector(f, e, 0, fn(e, d, 0));
+    m->end(it);
+  }
+  return f;
+}
+
+/* the array holds the field values where getArrayIndex says,
+   and writes through apf::setVector land in the array */
+void checkArray(apf::Mesh* m, apf::Field* f, int layout)
+{
+  apf::freeze(f, layout);
+  PCU_ALWAYS_ASSERT(apf::isFrozen(f));
+  PCU_ALWAYS_ASSERT(apf::getArrayLayout(f) == layout);
+  double* a = apf::getArrayData(f);
+  int size = apf::countArrayData(f);
+  for (int d = 0; d <= 1; ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      apf::Vector3 v;
+      apf::getVector(f, e, 0, v);
+      PCU_ALWAYS_ASSERT((v - fn(e, d, 0)).getLength() == 0);
+      for (int c = 0; c < 3; ++c) {
+        int i = apf::getArrayIndex(f, e, 0, c);
+        PCU_ALWAYS_ASSERT(0 <= i && i < size);
+        PCU_ALWAYS_ASSERT(a[i] == v[c]);
+      }
+      apf::setVector(f, e, 0, v * 2);
+      PCU_ALWAYS_ASSERT(a[apf::getArrayIndex(f, e, 0, 1)] == v[1] * 2);
+      apf::setVector(f, e, 0, v);
+    }
+    m->end(it);
+  }
+}
+
+/* on a mesh without destroyed entities the node order matches
+   the overlap numbering used for meshes without dense indices */
+void checkOrder(apf::Mesh* m, apf::Field* f)
+{
+  apf::freeze(f, apf::NODE_MAJOR);
+  apf::Numbering* n = apf::numberOverlapNodes(m, "order",
+      apf::getShape(f));
+  PCU_ALWAYS_ASSERT(apf::countArrayData(f) == apf::countNodes(n) * 3);
+  for (int d = 0; d <= 1; ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it)))
+      for (int c = 0; c < 3; ++c)
+        PCU_ALWAYS_ASSERT(apf::getArrayIndex(f, e, 0, c) ==
+            apf::getNumber(n, e, 0, 0) * 3 + c);
+    m->end(it);
+  }
+  apf::destroyNumbering(n);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 1);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  apf::Mesh2* m = apf::makeMdsBox(3, 2, 2, 1, 1, 1, true);
+  apf::Field* f = makeField(m);
+  checkArray(m, f, apf::NODE_MAJOR);
+  checkArray(m, f, apf::COMPONENT_MAJOR);
+  checkOrder(m, f);
+  apf::unfreeze(f);
+  PCU_ALWAYS_ASSERT(!apf::isFrozen(f));
+  checkArray(m, f, apf::COMPONENT_MAJOR);
+  /* modifying the mesh returns fields to tags */
+  apf::MeshEntity* v = apf::getMdsEntity(m, 0, 0);
+  m->createVert(m->toModel(v));
+  PCU_ALWAYS_ASSERT(!apf::isFrozen(f));
+  apf::Vector3 value;
+  apf::getVector(f, v, 0, value);
+  PCU_ALWAYS_ASSERT((value - fn(v, 0, 0)).getLength() == 0);
+  apf::destroyField(f);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
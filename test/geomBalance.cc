@@ -0,0 +1,100 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfZoltan.h>
+#include <gmi.h>
+#include <parma.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "parallelBox.h"
+
+namespace {
+
+enum Method { SFC, RIB, GRAPH };
+
+Method method = SFC;
+
+void getConfig(int argc, char** argv)
+{
+  const char* names[3] = {"sfc", "rib", "graph"};
+  int i = 0;
+  if (argc == 2)
+    while (i < 3 && strcmp(argv[1], names[i]))
+      ++i;
+  if (argc != 2 || i == 3) {
+    if (!PCU_Comm_Self())
+      printf("Usage: %s <sfc|rib|graph>\n", argv[0]);
+    MPI_Finalize();
+    exit(EXIT_FAILURE);
+  }
+  method = static_cast<Method>(i);
+}
+
+/* checks the split of one part, the curve and graph
+   splitters are given a factor that is not a power of two */
+void checkSplit(apf::Mesh2* m)
+{
+  int factor = 3;
+  double bound = 1.01;
+  apf::Splitter* splitter;
+  if (method == RIB) {
+    factor = 4;
+    splitter = Parma_MakeRibSplitter(m, false);
+  } else if (method == GRAPH) {
+    bound = 1.05;
+    splitter = apf::makeGraphSplitter(m, false);
+  } else {
+    splitter = Parma_MakeSfcSplitter(m, false);
+  }
+  apf::Migration* plan = splitter->split(0, 1.05, factor);
+  delete splitter;
+  int dim = m->getDimension();
+  std::vector<int> counts(factor, 0);
+  apf::MeshIterator* it = m->begin(dim);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int p = plan->has(e) ? plan->sending(e) : 0;
+    PCU_ALWAYS_ASSERT(p >= 0 && p < factor);
+    ++counts[p];
+  }
+  m->end(it);
+  delete plan;
+  double avg = double(m->count(dim)) / factor;
+  for (int i = 0; i < factor; ++i)
+    PCU_ALWAYS_ASSERT(counts[i] <= bound * avg + 1);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  getConfig(argc, argv);
+  gmi_model* g;
+  apf::Mesh2* m = makeExpandedBox(6, 6, 6, &g);
+  if (!PCU_Comm_Self())
+    checkSplit(m);
+  apf::Balancer* balancer;
+  if (method == RIB)
+    balancer = Parma_MakeRibBalancer(m, 1);
+  else if (method == GRAPH)
+    balancer = apf::makeGraphBalancer(m);
+  else
+    balancer = Parma_MakeSfcBalancer(m, 1);
+  balancer->balance(0, 1.05);
+  delete balancer;
+  m->verify();
+  int n = m->count(m->getDimension());
+  int max = PCU_Max_Int(n);
+  int total = PCU_Add_Int(n);
+  PCU_ALWAYS_ASSERT(max <= 1.05 * total / PCU_Comm_Peers() + 1);
+  Parma_PrintPtnStats(m, "");
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,84 @@
+#include <gmi.h>
+#include <gmi_analytic.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+/* part of a sphere of radius (u) */
+void sphere(double const p[2], double x[3], void* u)
+{
+  double r = *static_cast<double*>(u);
+  x[0] = r * std::cos(p[0]) * std::sin(p[1]);
+  x[1] = r * std::sin(p[0]) * std::sin(p[1]);
+  x[2] = r * std::cos(p[1]);
+}
+
+void sphereBatch(int n, double const* p, double* x, void* u)
+{
+  for (int i = 0; i < n; ++i)
+    sphere(p + 2 * i, x + 3 * i, u);
+}
+
+void circle(double const p[2], double x[3], void* u)
+{
+  double r = *static_cast<double*>(u);
+  x[0] = r * std::cos(p[0]);
+  x[1] = r * std::sin(p[0]);
+  x[2] = 0;
+}
+
+void check(gmi_model* m, gmi_ent* e, int n, double const* p)
+{
+  std::vector<double> x(3 * n);
+  gmi_eval_batch(m, e, n, p, &x[0]);
+  for (int i = 0; i < n; ++i) {
+    double expected[3];
+    gmi_eval(m, e, p + 2 * i, expected);
+    for (int j = 0; j < 3; ++j)
+      PCU_ALWAYS_ASSERT(std::fabs(x[3 * i + j] - expected[j]) < 1e-14);
+  }
+}
+
+}
+
+/* the batched evaluation agrees with gmi_eval for an entity with
+   a batched parameterization, for one without, and for a model
+   that does not implement the batched operation at all */
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  double radius = 2;
+  int periodic[2] = {1, 0};
+  double ranges[2][2] = {{0, 2 * M_PI}, {0, M_PI}};
+  gmi_model* m = gmi_make_analytic();
+  gmi_ent* face = gmi_add_analytic(m, 2, 0, sphere, periodic, ranges,
+      &radius);
+  gmi_add_analytic_batch(m, face, sphereBatch);
+  gmi_ent* edge = gmi_add_analytic(m, 1, 0, circle, periodic, ranges,
+      &radius);
+  int const n = 37;
+  std::vector<double> p(2 * n);
+  for (int i = 0; i < n; ++i) {
+    p[2 * i] = 2 * M_PI * double(rand()) / RAND_MAX;
+    p[2 * i + 1] = M_PI * double(rand()) / RAND_MAX;
+  }
+  check(m, face, n, &p[0]);
+  check(m, edge, n, &p[0]);
+  check(m, face, 1, &p[0]);
+  gmi_model_ops const* ops = m->ops;
+  gmi_model_ops perPoint = *ops;
+  perPoint.eval_batch = 0;
+  m->ops = &perPoint;
+  check(m, face, n, &p[0]);
+  check(m, edge, n, &p[0]);
+  m->ops = ops;
+  gmi_destroy(m);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,58 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <ma.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parallelBox.h"
+
+namespace {
+
+void refine(int dim, int iterations, int budget, long counts[4])
+{
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(4, 4, dim == 3 ? 4 : 0, &g);
+  ma::Input* in = ma::configureUniformRefine(m, iterations);
+  in->shouldFixShape = false;
+  in->maximumSplitElements = budget;
+  in->shouldBalanceRefineBatches = (budget != 0);
+  ma::adapt(in);
+  m->verify();
+  for (int d = 0; d <= dim; ++d)
+    counts[d] = PCU_Add_Long(apf::countOwned(m, d));
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+}
+
+/* splitting the same edges in batches gives the same vertices,
+   and with budgets below an edge's element count every batch
+   still makes progress. the triangle count follows from the
+   vertex counts, but the tet count depends on the order of the
+   splits, and so do the edges marked by later iterations */
+void test(int dim, int iterations)
+{
+  long expected[4];
+  refine(dim, iterations, 0, expected);
+  int budgets[2] = {50, 1};
+  for (int i = 0; i < 2; ++i) {
+    long counts[4];
+    refine(dim, iterations, budgets[i], counts);
+    PCU_ALWAYS_ASSERT(counts[0] == expected[0]);
+    if (dim == 2)
+      PCU_ALWAYS_ASSERT(counts[2] == expected[2]);
+  }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  test(2, 2);
+  test(3, 1);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,53 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <ma.h>
+#include <maAdapt.h>
+#include <maBalance.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parallelBox.h"
+
+/* asks for much finer elements near x = 0,
+   so parts there will receive most of the new elements */
+class Graded : public ma::IsotropicFunction
+{
+  public:
+    Graded(ma::Mesh* m):mesh(m) {}
+    double getValue(ma::Entity* v)
+    {
+      apf::Vector3 p = ma::getPosition(mesh, v);
+      return p[0] < 0.25 ? 0.05 : 0.25;
+    }
+  private:
+    ma::Mesh* mesh;
+};
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(8, 8, 8, &g);
+  Graded f(m);
+  ma::Input* in = ma::configure(m, &f);
+  in->shouldRunPrePredictive = true;
+  in->maximumImbalance = 1.10;
+  ma::Adapt* a = new ma::Adapt(in);
+  double before = ma::getPredictedImbalance(a);
+  PCU_ALWAYS_ASSERT(before > in->maximumImbalance);
+  ma::runPredictive(a);
+  double after = ma::getPredictedImbalance(a);
+  if ( ! PCU_Comm_Self())
+    printf("predicted imbalance %f before, %f after\n", before, after);
+  PCU_ALWAYS_ASSERT(after < before);
+  delete a;
+  delete in;
+  m->verify();
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
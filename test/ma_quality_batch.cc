@@ -0,0 +1,93 @@
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfMesh2.h>
+#include <apf.h>
+#include <gmi_null.h>
+#include <maShape.h>
+#include <maSize.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <vector>
+
+class Stretch : public ma::AnisotropicFunction
+{
+  public:
+    void getValue(ma::Entity* v, ma::Matrix& r, ma::Vector& h)
+    {
+      (void)v;
+      double c = std::cos(0.3);
+      double s = std::sin(0.3);
+      r = ma::Matrix(c, -s, 0,
+                     s,  c, 0,
+                     0,  0, 1);
+      h = ma::Vector(0.1, 0.4, 0.2);
+    }
+};
+
+static void perturb(apf::Mesh2* m)
+{
+  apf::MeshIterator* it = m->begin(0);
+  apf::MeshEntity* v;
+  int i = 0;
+  while ((v = m->iterate(it))) {
+    apf::Vector3 p;
+    m->getPoint(v, 0, p);
+    p = p + apf::Vector3(0.01 * (i % 3), 0.02 * (i % 5), 0);
+    m->setPoint(v, 0, p);
+    ++i;
+  }
+  m->end(it);
+}
+
+static void compare(apf::Mesh2* m, ma::SizeField* f)
+{
+  int dim = m->getDimension();
+  std::vector<ma::Entity*> elems;
+  apf::MeshIterator* it = m->begin(dim);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it)))
+    elems.push_back(e);
+  m->end(it);
+  std::vector<double> q(elems.size());
+  ma::measureElementQualities(m, f, &elems[0], elems.size(), &q[0]);
+  for (size_t i = 0; i < elems.size(); ++i) {
+    double expected = ma::measureElementQuality(m, f, elems[i]);
+    PCU_ALWAYS_ASSERT(std::fabs(q[i] - expected) < 1e-10);
+  }
+  if (dim == 3) {
+    ma::measureLinearTetQualities(m, &elems[0], elems.size(), &q[0]);
+    for (size_t i = 0; i < elems.size(); ++i) {
+      ma::Vector xyz[4];
+      ma::getVertPoints(m, elems[i], xyz);
+      double expected = ma::measureLinearTetQuality(xyz);
+      PCU_ALWAYS_ASSERT(std::fabs(q[i] - expected) < 1e-10);
+    }
+  }
+}
+
+static void test(int nz)
+{
+  apf::Mesh2* m = apf::makeMdsBox(5, 4, nz, 1, 1, nz ? 1 : 0, true);
+  perturb(m);
+  ma::SizeField* f = new ma::IdentitySizeField(m);
+  compare(m, f);
+  delete f;
+  Stretch stretch;
+  f = ma::makeSizeField(m, &stretch);
+  compare(m, f);
+  delete f;
+  m->destroyNative();
+  apf::destroyMesh(m);
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  gmi_register_null();
+  test(0);
+  test(3);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
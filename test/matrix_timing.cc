@@ -0,0 +1,134 @@
+#include <apfMatrix.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+
+/* times the closed form determinants, inverses and batched
+   variants in apfMatrix.h against the generic cofactor expansion
+   they replaced, and checks that they agree */
+
+namespace {
+
+template <std::size_t N>
+struct Generic
+{
+  static double det(apf::Matrix<N,N> const& A)
+  {
+    double d = 0;
+    for (std::size_t i = 0; i < N; ++i) {
+      apf::Matrix<N-1,N-1> B;
+      for (std::size_t k = 0, m = 0; k < N; ++k)
+        if (k != i) {
+          for (std::size_t l = 1; l < N; ++l)
+            B[m][l - 1] = A[k][l];
+          ++m;
+        }
+      double sign = (i % 2) ? -1 : 1;
+      d += A[i][0] * sign * Generic<N-1>::det(B);
+    }
+    return d;
+  }
+  static apf::Matrix<N,N> invert(apf::Matrix<N,N> const& A)
+  {
+    apf::Matrix<N,N> r;
+    for (std::size_t i = 0; i < N; ++i)
+    for (std::size_t j = 0; j < N; ++j) {
+      apf::Matrix<N-1,N-1> B;
+      for (std::size_t k = 0, m = 0; k < N; ++k)
+        if (k != i) {
+          for (std::size_t l = 0, n = 0; l < N; ++l)
+            if (l != j)
+              B[m][n++] = A[k][l];
+          ++m;
+        }
+      double sign = ((i + j) % 2) ? -1 : 1;
+      r[j][i] = sign * Generic<N-1>::det(B);
+    }
+    return r / det(A);
+  }
+};
+
+template <>
+struct Generic<1>
+{
+  static double det(apf::Matrix<1,1> const& A) {return A[0][0];}
+};
+
+template <std::size_t N>
+void fill(std::vector<apf::Matrix<N,N> >& a)
+{
+  for (std::size_t i = 0; i < a.size(); ++i)
+    for (std::size_t j = 0; j < N; ++j)
+    for (std::size_t k = 0; k < N; ++k)
+      a[i][j][k] = (j == k ? N : 0) + double(rand()) / RAND_MAX - 0.5;
+}
+
+bool close(double a, double b)
+{
+  return std::fabs(a - b) <= 1e-12 * (1 + std::fabs(a) + std::fabs(b));
+}
+
+template <std::size_t N>
+void run(int iterations)
+{
+  std::vector<apf::Matrix<N,N> > a(1000), inv(a.size()), inv2(a.size());
+  std::vector<apf::Matrix<N,N> > prod(a.size());
+  std::vector<double> d(a.size()), d2(a.size());
+  fill(a);
+  double sum = 0;
+  double t0 = PCU_Time();
+  for (int it = 0; it < iterations; ++it)
+    for (std::size_t i = 0; i < a.size(); ++i)
+      sum += Generic<N>::det(a[i]);
+  double t1 = PCU_Time();
+  for (int it = 0; it < iterations; ++it) {
+    apf::getDeterminants(a.size(), &a[0], &d[0]);
+    sum += d[it % a.size()];
+  }
+  double t2 = PCU_Time();
+  for (int it = 0; it < iterations; ++it)
+    for (std::size_t i = 0; i < a.size(); ++i)
+      inv2[i] = Generic<N>::invert(a[i]);
+  double t3 = PCU_Time();
+  for (int it = 0; it < iterations; ++it)
+    apf::invert(a.size(), &a[0], &inv[0]);
+  double t4 = PCU_Time();
+  for (int it = 0; it < iterations; ++it)
+    apf::multiply(a.size(), &a[0], &inv[0], &prod[0]);
+  double t5 = PCU_Time();
+  printf("%dx%d: determinant %f s generic, %f s closed form\n",
+      int(N), int(N), t1 - t0, t2 - t1);
+  printf("%dx%d: inverse %f s generic, %f s closed form\n",
+      int(N), int(N), t3 - t2, t4 - t3);
+  printf("%dx%d: batched product %f s (checksum %g)\n",
+      int(N), int(N), t5 - t4, sum);
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    d2[i] = Generic<N>::det(a[i]);
+    PCU_ALWAYS_ASSERT(close(d[i], d2[i]));
+    PCU_ALWAYS_ASSERT(close(apf::getDeterminant(a[i]), d2[i]));
+    for (std::size_t j = 0; j < N; ++j)
+    for (std::size_t k = 0; k < N; ++k) {
+      PCU_ALWAYS_ASSERT(close(inv[i][j][k], inv2[i][j][k]));
+      PCU_ALWAYS_ASSERT(close(prod[i][j][k], j == k ? 1 : 0));
+    }
+  }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 2);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  int iterations = atoi(argv[1]);
+  run<2>(iterations);
+  run<3>(iterations);
+  run<4>(iterations);
+  PCU_Comm_Free();
+  MPI_Finalize();
+  return 0;
+}
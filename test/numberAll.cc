@@ -0,0 +1,118 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfShape.h>
+#include <apfNumbering.h>
+#include <gmi.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "parallelBox.h"
+
+namespace {
+
+/* owned nodes come first in the overlap numbering, the numbers on
+   each part are a permutation, the global numbers are a permutation
+   over all parts and all copies of a node agree */
+void checkNumbers(apf::Mesh* m, apf::NodeNumberings& n)
+{
+  apf::DynamicArray<apf::Node> nodes;
+  apf::getNodes(n.overlap, nodes);
+  PCU_ALWAYS_ASSERT(static_cast<int>(nodes.getSize()) == n.overlapCount);
+  std::vector<int> seen(n.overlapCount, 0);
+  long sum = 0;
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < nodes.getSize(); ++i) {
+    apf::MeshEntity* e = nodes[i].entity;
+    int node = nodes[i].node;
+    int local = apf::getNumber(n.overlap, e, node, 0);
+    ++seen[local];
+    long global = apf::getNumber(n.global, e, node);
+    PCU_ALWAYS_ASSERT(0 <= global && global < n.globalCount);
+    if (m->isOwned(e)) {
+      PCU_ALWAYS_ASSERT(local < n.ownedCount);
+      PCU_ALWAYS_ASSERT(apf::getNumber(n.owned, e, node, 0) == local);
+      PCU_ALWAYS_ASSERT(global == n.globalStart + local);
+      sum += global;
+    } else {
+      PCU_ALWAYS_ASSERT(local >= n.ownedCount);
+      PCU_ALWAYS_ASSERT(!apf::isNumbered(n.owned, e, node, 0));
+    }
+    apf::Copies remotes;
+    m->getRemotes(e, remotes);
+    APF_ITERATE(apf::Copies, remotes, it) {
+      PCU_COMM_PACK(it->first, it->second);
+      PCU_COMM_PACK(it->first, node);
+      PCU_COMM_PACK(it->first, global);
+    }
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    apf::MeshEntity* e;
+    int node;
+    long global;
+    PCU_COMM_UNPACK(e);
+    PCU_COMM_UNPACK(node);
+    PCU_COMM_UNPACK(global);
+    PCU_ALWAYS_ASSERT(apf::getNumber(n.global, e, node) == global);
+  }
+  for (int i = 0; i < n.overlapCount; ++i)
+    PCU_ALWAYS_ASSERT(seen[i] == 1);
+  PCU_ALWAYS_ASSERT(n.globalCount == PCU_Add_Long(n.ownedCount));
+  sum = PCU_Add_Long(sum);
+  PCU_ALWAYS_ASSERT(sum == n.globalCount * (n.globalCount - 1) / 2);
+}
+
+/* the largest difference between owned nodes of an element */
+int getBandwidth(apf::Mesh* m, apf::NodeNumberings& n)
+{
+  int bandwidth = 0;
+  apf::NewArray<int> numbers;
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int nn = apf::getElementNumbers(n.overlap, e, numbers);
+    for (int i = 0; i < nn; ++i)
+      for (int j = 0; j < nn; ++j)
+        if (numbers[i] < n.ownedCount && numbers[j] < n.ownedCount)
+          bandwidth = std::max(bandwidth,
+              std::abs(numbers[i] - numbers[j]));
+  }
+  m->end(it);
+  return bandwidth;
+}
+
+void test(apf::Mesh* m, apf::FieldShape* s)
+{
+  apf::NodeNumberings plain;
+  apf::numberAllNodes(m, "plain", plain, apf::ITERATION_ORDER, s);
+  checkNumbers(m, plain);
+  apf::NodeNumberings rcm;
+  apf::numberAllNodes(m, "rcm", rcm, apf::RCM_ORDER, s);
+  checkNumbers(m, rcm);
+  PCU_ALWAYS_ASSERT(rcm.ownedCount == plain.ownedCount);
+  PCU_ALWAYS_ASSERT(rcm.globalStart == plain.globalStart);
+  PCU_ALWAYS_ASSERT(getBandwidth(m, rcm) < getBandwidth(m, plain));
+  apf::destroyNodeNumberings(plain);
+  apf::destroyNodeNumberings(rcm);
+  PCU_ALWAYS_ASSERT(!rcm.owned && !rcm.overlap && !rcm.global);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(8, 8, 8, &g);
+  test(m, 0);
+  test(m, apf::getLagrange(2));
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
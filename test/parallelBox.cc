@@ -0,0 +1,31 @@
+#include "parallelBox.h"
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <parma.h>
+#include <PCU.h>
+
+apf::Mesh2* makeExpandedBox(int nx, int ny, int nz, gmi_model** g)
+{
+  PCU_Switch_Comm(MPI_COMM_SELF);
+  apf::Mesh2* m = apf::makeMdsBox(nx, ny, nz, 1, 1, 1, true);
+  *g = m->getModel();
+  apf::disownMdsModel(m);
+  PCU_Switch_Comm(MPI_COMM_WORLD);
+  if (PCU_Comm_Self()) {
+    m->destroyNative();
+    apf::destroyMesh(m);
+    m = 0;
+  }
+  m = apf::expandMdsMesh(m, *g, 1);
+  apf::disownMdsModel(m);
+  return m;
+}
+
+apf::Mesh2* makeBalancedBox(int nx, int ny, int nz, gmi_model** g)
+{
+  apf::Mesh2* m = makeExpandedBox(nx, ny, nz, g);
+  apf::Balancer* balancer = Parma_MakeSfcBalancer(m, 0);
+  balancer->balance(0, 1.05);
+  delete balancer;
+  return m;
+}
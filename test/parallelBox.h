@@ -0,0 +1,17 @@
+#ifndef PARALLEL_BOX_H
+#define PARALLEL_BOX_H
+
+#include <apfMesh2.h>
+#include <gmi.h>
+
+/* builds a box of (nx) by (ny) by (nz) elements, or a square when
+   (nz) is zero, and expands it over all ranks. every rank builds the
+   box to obtain the same model, only the first one keeps its mesh,
+   so the other parts are empty. the caller owns the model (g). */
+apf::Mesh2* makeExpandedBox(int nx, int ny, int nz, gmi_model** g);
+
+/* the same box with its elements spread over the parts
+   by the curve balancer */
+apf::Mesh2* makeBalancedBox(int nx, int ny, int nz, gmi_model** g);
+
+#endif
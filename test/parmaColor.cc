@@ -0,0 +1,93 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <parma.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include "parallelBox.h"
+
+namespace {
+
+/* neighboring parts get different numbers */
+void checkParts(apf::Mesh* m)
+{
+  int color = Parma_MisNumbering(m, 0);
+  PCU_ALWAYS_ASSERT(color >= 0);
+  apf::Parts peers;
+  apf::getPeers(m, 0, peers);
+  PCU_Comm_Begin();
+  APF_ITERATE(apf::Parts, peers, it)
+    PCU_COMM_PACK(*it, color);
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    int other;
+    PCU_COMM_UNPACK(other);
+    PCU_ALWAYS_ASSERT(other != color);
+  }
+}
+
+/* entities sharing a bridge have different colors, color zero is
+   maximal, and the copies of an entity agree on its color */
+void checkEntities(apf::Mesh* m, int d, int b)
+{
+  int colors;
+  apf::MeshTag* tag = Parma_ColorEntities(m, d, b, &colors);
+  PCU_ALWAYS_ASSERT(colors > 1);
+  PCU_Comm_Begin();
+  apf::MeshIterator* it = m->begin(d);
+  apf::MeshEntity* e;
+  apf::Adjacent adj;
+  while ((e = m->iterate(it))) {
+    int color;
+    m->getIntTag(e, tag, &color);
+    PCU_ALWAYS_ASSERT(color >= 0 && color < colors);
+    apf::getBridgeAdjacent(m, e, b, d, adj);
+    bool hasZero = (color == 0);
+    for (size_t i = 0; i < adj.size(); ++i) {
+      int other;
+      m->getIntTag(adj[i], tag, &other);
+      PCU_ALWAYS_ASSERT(other != color);
+      hasZero = hasZero || (other == 0);
+    }
+    /* a neighbor in color zero may be across a part boundary */
+    PCU_ALWAYS_ASSERT(hasZero || m->isShared(e));
+    apf::Copies remotes;
+    m->getRemotes(e, remotes);
+    APF_ITERATE(apf::Copies, remotes, rit) {
+      PCU_COMM_PACK(rit->first, rit->second);
+      PCU_COMM_PACK(rit->first, color);
+    }
+  }
+  m->end(it);
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    apf::MeshEntity* r;
+    int color;
+    PCU_COMM_UNPACK(r);
+    PCU_COMM_UNPACK(color);
+    int mine;
+    m->getIntTag(r, tag, &mine);
+    PCU_ALWAYS_ASSERT(mine == color);
+  }
+  apf::removeTagFromDimension(m, tag, d);
+  m->destroyTag(tag);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(6, 6, 6, &g);
+  checkParts(m);
+  checkEntities(m, 0, 1);
+  checkEntities(m, 3, 2);
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
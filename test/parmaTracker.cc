@@ -0,0 +1,123 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <parma_tracker.h>
+#include <parma_sides.h>
+#include <parma_weights.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+#include "parallelBox.h"
+
+namespace {
+
+/* the tracked sides and weights of dimension (dim)
+   match a full recount */
+void check(apf::Mesh* m, apf::MeshTag* w, parma::Tracker* t, int dim)
+{
+  parma::Sides* expected = parma::makeVtxSides(m);
+  parma::Sides* tracked = t->makeVtxSides();
+  PCU_ALWAYS_ASSERT(tracked->total() == expected->total());
+  PCU_ALWAYS_ASSERT(tracked->size() == expected->size());
+  const parma::Sides::Item* side;
+  expected->begin();
+  while ((side = expected->iterate()))
+    PCU_ALWAYS_ASSERT(tracked->get(side->first) == side->second);
+  expected->end();
+  parma::Weights* ew = parma::makeEntWeights(m, w, expected, dim);
+  parma::Weights* tw = t->makeEntWeights(tracked);
+  PCU_ALWAYS_ASSERT(std::fabs(tw->self() - ew->self()) < 1e-9);
+  delete ew;
+  delete tw;
+  delete expected;
+  delete tracked;
+}
+
+/* moves the elements in a slab that changes with (step)
+   to the next part */
+void migrate(apf::Mesh2* m, int step)
+{
+  int dim = m->getDimension();
+  apf::Migration* plan = new apf::Migration(m);
+  apf::MeshIterator* it = m->begin(dim);
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    apf::Vector3 c = apf::getLinearCentroid(m, e);
+    int slab = int(c[(step % 3)] * 8);
+    if (slab % 3 == step % 3)
+      plan->send(e, (PCU_Comm_Self() + 1) % PCU_Comm_Peers());
+  }
+  m->end(it);
+  m->migrate(plan);
+}
+
+/* counts the calls it receives */
+class Counter : public apf::MigrationObserver
+{
+  public:
+    Counter():calls(0) {}
+    void before(apf::Mesh2*, apf::MeshEntity*) { ++calls; }
+    void after(apf::Mesh2*, apf::MeshEntity*) { ++calls; }
+    long calls;
+};
+
+apf::MeshTag* makeWeights(apf::Mesh* m)
+{
+  apf::MeshTag* w = m->createDoubleTag("weight", 1);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      apf::Vector3 c = apf::getLinearCentroid(m, e);
+      double x = 1 + c[0] + 2 * c[1] * c[2];
+      m->setDoubleTag(e, w, &x);
+    }
+    m->end(it);
+  }
+  return w;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(6, 6, 6, &g);
+  apf::MeshTag* w = makeWeights(m);
+  /* an outer observer and two nested trackers, of the elements
+     and of the vertices, all see every migration, and each one
+     restores the previous */
+  int dim = m->getDimension();
+  Counter counter;
+  PCU_ALWAYS_ASSERT(apf::setMigrationObserver(&counter) == 0);
+  parma::Tracker* outer = new parma::Tracker(m, w, dim);
+  check(m, w, outer, dim);
+  for (int step = 0; step < 3; ++step) {
+    migrate(m, step);
+    check(m, w, outer, dim);
+  }
+  parma::Tracker* inner = new parma::Tracker(m, w, 0);
+  for (int step = 3; step < 6; ++step) {
+    migrate(m, step);
+    check(m, w, inner, 0);
+    check(m, w, outer, dim);
+  }
+  delete inner;
+  migrate(m, 6);
+  check(m, w, outer, dim);
+  delete outer;
+  PCU_ALWAYS_ASSERT(PCU_Add_Long(counter.calls) > 0);
+  PCU_ALWAYS_ASSERT(apf::setMigrationObserver(0) == &counter);
+  for (int d = 0; d <= m->getDimension(); ++d)
+    apf::removeTagFromDimension(m, w, d);
+  m->destroyTag(w);
+  m->verify();
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
@@ -0,0 +1,134 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <gmi.h>
+#include <parma.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "parallelBox.h"
+
+namespace {
+
+const char* entNames[4] = {"vtx", "edge", "face", "rgn"};
+
+typedef std::vector<std::string> Row;
+
+/* splits a line of the report at its commas */
+Row readRow(FILE* file)
+{
+  Row row;
+  std::string cell;
+  int c;
+  while ((c = fgetc(file)) != EOF && c != '\n') {
+    if (c == ',') {
+      row.push_back(cell);
+      cell.clear();
+    } else {
+      cell += char(c);
+    }
+  }
+  row.push_back(cell);
+  return row;
+}
+
+double getValue(Row const& header, Row const& row, std::string const& name)
+{
+  PCU_ALWAYS_ASSERT(header.size() == row.size());
+  for (size_t i = 0; i < header.size(); ++i)
+    if (header[i] == name)
+      return atof(row[i].c_str());
+  fprintf(stderr, "the report has no %s column\n", name.c_str());
+  abort();
+}
+
+bool isClose(double a, double b)
+{
+  return std::fabs(a - b) <= 1e-8 * std::fabs(b);
+}
+
+/* the values of a report row that can be recomputed directly */
+struct Expected {
+  double tot[4];
+  double max[4];
+  double min[4];
+  double imb[4];
+  int empty;
+};
+
+void getExpected(apf::Mesh* m, Expected& x)
+{
+  for (int d = 0; d < 4; ++d)
+    x.tot[d] = x.max[d] = x.min[d] = m->count(d);
+  PCU_Add_Doubles(x.tot, 4);
+  PCU_Max_Doubles(x.max, 4);
+  PCU_Min_Doubles(x.min, 4);
+  Parma_GetEntImbalance(m, &x.imb);
+  x.empty = PCU_Add_Int(m->count(m->getDimension()) == 0);
+}
+
+void check(int dim, Row const& header, Row const& row, Expected const& x)
+{
+  PCU_ALWAYS_ASSERT(row[0] == "test");
+  PCU_ALWAYS_ASSERT(atoi(row[1].c_str()) == PCU_Comm_Peers());
+  for (int d = 0; d <= dim; ++d) {
+    std::string n(entNames[d]);
+    PCU_ALWAYS_ASSERT(getValue(header, row, n + "_tot") == x.tot[d]);
+    PCU_ALWAYS_ASSERT(getValue(header, row, n + "_max") == x.max[d]);
+    PCU_ALWAYS_ASSERT(getValue(header, row, n + "_min") == x.min[d]);
+    PCU_ALWAYS_ASSERT(isClose(getValue(header, row, n + "_imb"), x.imb[d]));
+  }
+  PCU_ALWAYS_ASSERT(getValue(header, row, "empty_parts") == x.empty);
+}
+
+}
+
+/* reports of a box on the first part only, and after balancing it,
+   read back to compare with the entity counts of the mesh */
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  /* only the first rank writes the report */
+  char path[] = "/tmp/ptnReportXXXXXX.csv";
+  if (!PCU_Comm_Self()) {
+    int fd = mkstemps(path, 4);
+    PCU_ALWAYS_ASSERT(fd != -1);
+    close(fd);
+  }
+  gmi_model* g;
+  apf::Mesh2* m = makeExpandedBox(4, 4, 4, &g);
+  Expected expanded;
+  getExpected(m, expanded);
+  PCU_ALWAYS_ASSERT(expanded.empty == PCU_Comm_Peers() - 1);
+  Parma_WritePtnReport(m, 0, 0, "test", path);
+  apf::Balancer* balancer = Parma_MakeSfcBalancer(m, 0);
+  balancer->balance(0, 1.05);
+  delete balancer;
+  Expected balanced;
+  getExpected(m, balanced);
+  PCU_ALWAYS_ASSERT(balanced.empty == 0);
+  Parma_WritePtnReport(m, 0, 0, "test", path);
+  int dim = m->getDimension();
+  if (!PCU_Comm_Self()) {
+    FILE* file = fopen(path, "r");
+    PCU_ALWAYS_ASSERT(file);
+    Row header = readRow(file);
+    PCU_ALWAYS_ASSERT(header[0] == "key");
+    check(dim, header, readRow(file), expanded);
+    check(dim, header, readRow(file), balanced);
+    PCU_ALWAYS_ASSERT(fgetc(file) == EOF);
+    fclose(file);
+    remove(path);
+  }
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
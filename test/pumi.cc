@@ -62,6 +62,7 @@ void TEST_MESH_TAG(pMesh m);
 void TEST_NEW_MESH(pMesh m);
 void TEST_GHOSTING(pMesh m);
 void TEST_FIELD(pMesh m);
+void TEST_GHOST_UPDATE(pMesh m);
 
 //*********************************************************
 int main(int argc, char** argv)
@@ -707,6 +708,58 @@ void TEST_FIELD(pMesh m)
   pumi_field_verify(m, f);
 }
 
+void TEST_GHOST_UPDATE(pMesh m)
+{
+  // values are set on non-ghost copies only and the update is repeated
+  // so that the second one reuses the recorded ghost copies
+  int mesh_dim=pumi_mesh_getDim(m);
+  std::vector<pMeshTag> tags(1,
+      pumi_mesh_createIntTag(m, "ghost_update_tag", 1));
+  std::vector<pField> fields(1, pumi_field_create(m, "ghost_update_field", 1));
+  pMeshEnt e;
+  pMeshIter it;
+  for (int step=1; step<=2; ++step)
+  {
+    it = m->begin(mesh_dim);
+    while ((e = m->iterate(it)))
+    {
+      if (pumi_ment_isGhost(e)) continue;
+      int value = pumi_ment_getGlobalID(e)*step;
+      pumi_ment_setIntTag(e, tags[0], &value);
+    }
+    m->end(it);
+    it = m->begin(0);
+    while ((e = m->iterate(it)))
+    {
+      if (pumi_ment_isGhost(e)) continue;
+      double value = pumi_ment_getGlobalID(e)*step;
+      pumi_ment_setField(e, fields[0], 0, &value);
+    }
+    m->end(it);
+
+    pumi_ghost_update(m, tags, fields);
+
+    it = m->begin(mesh_dim);
+    while ((e = m->iterate(it)))
+    {
+      int value;
+      pumi_ment_getIntTag(e, tags[0], &value);
+      PCU_ALWAYS_ASSERT(value == pumi_ment_getGlobalID(e)*step);
+    }
+    m->end(it);
+    it = m->begin(0);
+    while ((e = m->iterate(it)))
+    {
+      double value;
+      pumi_ment_getField(e, fields[0], 0, &value);
+      PCU_ALWAYS_ASSERT(value == pumi_ment_getGlobalID(e)*step);
+    }
+    m->end(it);
+  }
+  pumi_field_delete(fields[0]);
+  pumi_mesh_deleteTag(m, tags[0], true /* force_delete*/);
+}
+
 Ghosting* getGhostingPlan(pMesh m)
 {
   int mesh_dim=pumi_mesh_getDim(m);
@@ -780,6 +833,7 @@ void TEST_GHOSTING(pMesh m)
         if (!pumi_rank()) std::cout<<"\n[test_pumi] layer-wise pumi_ghost_createLayer (bd "<<brg_dim<<", gd "<<mesh_dim<<", nl "<<num_layer<<", ic"<<include_copy<<"), #ghost increase="<<total_mcount_diff<<"\n";
         pumi_mesh_verify(m);
         TEST_FIELD(m);
+        TEST_GHOST_UPDATE(m);
         pumi_ghost_delete(m);
         for (int i=0; i<4; ++i)
           PCU_ALWAYS_ASSERT(org_mcount[i] == pumi_mesh_getNumEnt(m, i));
@@ -55,6 +55,31 @@ static void testSolveQR()
     PCU_ALWAYS_ASSERT(fabs(kx(i) - x(i)) < 1e-15);
 }
 
+/* the same fit through the compact column-major factorization,
+   plus a rank deficient matrix with a repeated column */
+static void testHouseholder()
+{
+  double a[16 * 10];
+  double b[16];
+  for (unsigned i = 0; i < 16; ++i) {
+    b[i] = 0;
+    for (unsigned j = 0; j < 10; ++j) {
+      a[j * 16 + i] = a_data[i][j];
+      b[i] += a_data[i][j] * x_data[j];
+    }
+  }
+  double tau[10];
+  PCU_ALWAYS_ASSERT(mth::decomposeHouseholder<10>(16, a, tau) == 10);
+  double x[10];
+  mth::solveHouseholder<10>(16, a, tau, b, x);
+  for (unsigned i = 0; i < 10; ++i)
+    PCU_ALWAYS_ASSERT(fabs(x_data[i] - x[i]) < 1e-14);
+  for (unsigned i = 0; i < 16; ++i)
+  for (unsigned j = 0; j < 3; ++j)
+    a[j * 16 + i] = a_data[i][j == 2 ? 1 : j];
+  PCU_ALWAYS_ASSERT(mth::decomposeHouseholder<3>(16, a, tau) == 2);
+}
+
 void testHessenberg()
 {
   mth::Matrix3x3<double> a(
@@ -111,6 +136,7 @@ void testEigenQR()
 int main()
 {
   testSolveQR();
+  testHouseholder();
   std::cout << std::scientific << std::setprecision(6);
   testHessenberg();
   testEigenQR();
@@ -0,0 +1,175 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfMDS.h>
+#include <apfBox.h>
+#include <apfShape.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <cmath>
+
+namespace {
+
+double fn(apf::Vector3 const& x)
+{
+  return x[0] * x[0] + 2 * x[1] * x[2] - x[2];
+}
+
+apf::Field* makeField(apf::Mesh* m, apf::FieldShape* s)
+{
+  apf::Field* f = apf::createField(m, "f", apf::SCALAR, s);
+  for (int d = 0; d <= m->getDimension(); ++d) {
+    if (!s->hasNodesIn(d))
+      continue;
+    apf::MeshIterator* it = m->begin(d);
+    apf::MeshEntity* e;
+    while ((e = m->iterate(it))) {
+      int n = s->countNodesOn(m->getType(e));
+      for (int i = 0; i < n; ++i) {
+        apf::Vector3 xi, x;
+        s->getNodeXi(m->getType(e), i, xi);
+        apf::MeshElement* me = apf::createMeshElement(m, e);
+        apf::mapLocalToGlobal(me, xi, x);
+        apf::destroyMeshElement(me);
+        apf::setScalar(f, e, i, fn(x));
+      }
+    }
+    m->end(it);
+  }
+  return f;
+}
+
+void expectSame(double a, double b)
+{
+  PCU_ALWAYS_ASSERT(a == b);
+}
+
+void expectSame(apf::Vector3 const& a, apf::Vector3 const& b)
+{
+  for (int i = 0; i < 3; ++i)
+    expectSame(a[i], b[i]);
+}
+
+/* evaluations at integration points, which use the tabulated shape
+   functions, agree exactly with evaluations at the same points given
+   by coordinates only */
+void checkElement(apf::Mesh* m, apf::MeshEntity* e, apf::Field* f,
+    int order)
+{
+  apf::MeshElement* tme = apf::createMeshElement(m, e);
+  apf::Element* te = apf::createElement(f, tme);
+  apf::MeshElement* me = apf::createMeshElement(m, e);
+  apf::Element* fe = apf::createElement(f, me);
+  int np = apf::countIntPoints(tme, order);
+  for (int p = 0; p < np; ++p) {
+    apf::Vector3 xi;
+    apf::getIntPoint(tme, order, p, xi);
+    apf::Vector3 xi2;
+    apf::getGaussPoint(m->getType(e), order, p, xi2);
+    expectSame(apf::getDV(tme, xi), apf::getDV(me, xi2));
+    expectSame(apf::getScalar(te, xi), apf::getScalar(fe, xi2));
+    apf::Vector3 g, g2;
+    apf::getGrad(te, xi, g);
+    apf::getGrad(fe, xi2, g2);
+    expectSame(g, g2);
+    apf::NewArray<double> v, v2;
+    apf::getShapeValues(te, xi, v);
+    apf::getShapeValues(fe, xi2, v2);
+    apf::NewArray<apf::Vector3> sg, sg2;
+    apf::getShapeGrads(te, xi, sg);
+    apf::getShapeGrads(fe, xi2, sg2);
+    for (int i = 0; i < apf::countNodes(te); ++i) {
+      expectSame(v[i], v2[i]);
+      expectSame(sg[i], sg2[i]);
+    }
+    /* other points still evaluate the shape functions */
+    apf::Vector3 other = xi * 0.5;
+    expectSame(apf::getScalar(te, other), apf::getScalar(fe, other));
+  }
+  apf::destroyElement(te);
+  apf::destroyMeshElement(tme);
+  apf::destroyElement(fe);
+  apf::destroyMeshElement(me);
+}
+
+void checkShape(apf::Mesh* m, apf::FieldShape* s, int maxOrder)
+{
+  apf::Field* f = makeField(m, s);
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it)))
+    for (int order = 1; order <= maxOrder; ++order)
+      checkElement(m, e, f, order);
+  m->end(it);
+  apf::destroyField(f);
+}
+
+/* integrating the square of a quadratic field over tetrahedra
+   is exact */
+class Integral : public apf::Integrator
+{
+  public:
+    Integral(apf::Field* field):
+      apf::Integrator(4), f(field), e(0), sum(0) {}
+    void inElement(apf::MeshElement* me)
+    {
+      e = apf::createElement(f, me);
+    }
+    void outElement()
+    {
+      apf::destroyElement(e);
+    }
+    void atPoint(apf::Vector3 const& p, double w, double dV)
+    {
+      double v = apf::getScalar(e, p);
+      sum += v * v * w * dV;
+    }
+    apf::Field* f;
+    apf::Element* e;
+    double sum;
+};
+
+void checkIntegral(apf::Mesh* m)
+{
+  apf::Field* f = makeField(m, apf::getLagrange(2));
+  Integral integral(f);
+  integral.process(m);
+  /* the integral of (x^2 + 2yz - z)^2 over the unit cube */
+  double expected = 14.0 / 45;
+  PCU_ALWAYS_ASSERT(fabs(integral.sum - expected) < 1e-12);
+  apf::destroyField(f);
+}
+
+void test(int dim, bool simplex)
+{
+  int nz = dim == 3 ? 3 : 0;
+  apf::Mesh2* m = apf::makeMdsBox(3, 3, nz, 1, 1, 1, simplex);
+  /* the hexahedron rules are accurate up to order 3 */
+  int maxOrder = (dim == 3 && !simplex) ? 3 : 4;
+  checkShape(m, apf::getLagrange(1), maxOrder);
+  if (simplex) {
+    checkShape(m, apf::getLagrange(2), maxOrder);
+    checkShape(m, apf::getLagrange(3), maxOrder);
+  } else if (dim == 2) {
+    checkShape(m, apf::getLagrange(2), maxOrder);
+    checkShape(m, apf::getSerendipity(), maxOrder);
+  }
+  if (dim == 3 && simplex)
+    checkIntegral(m);
+  m->destroyNative();
+  apf::destroyMesh(m);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  PCU_ALWAYS_ASSERT(argc == 1);
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  test(2, true);
+  test(2, false);
+  test(3, true);
+  test(3, false);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
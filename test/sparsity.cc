@@ -0,0 +1,143 @@
+#include <apf.h>
+#include <apfMesh2.h>
+#include <apfShape.h>
+#include <apfNumbering.h>
+#include <gmi.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "parallelBox.h"
+
+namespace {
+
+typedef std::set<std::pair<long, long> > Pairs;
+
+/* the structure matches the pairs, row by row */
+void expectPairs(apf::Sparsity const& s, Pairs const& pairs)
+{
+  size_t n = 0;
+  PCU_ALWAYS_ASSERT(s.offsets.size() == s.rows.size() + 1);
+  PCU_ALWAYS_ASSERT(s.offsets.back() == static_cast<int>(s.columns.size()));
+  for (size_t i = 0; i < s.rows.size(); ++i) {
+    PCU_ALWAYS_ASSERT(s.findRow(s.rows[i]) == static_cast<int>(i));
+    for (int j = s.offsets[i]; j < s.offsets[i + 1]; ++j) {
+      std::pair<long, long> p(s.rows[i], s.columns[j]);
+      PCU_ALWAYS_ASSERT(pairs.count(p));
+      if (j > s.offsets[i])
+        PCU_ALWAYS_ASSERT(s.columns[j - 1] < s.columns[j]);
+      ++n;
+    }
+  }
+  PCU_ALWAYS_ASSERT(n == pairs.size());
+}
+
+void checkLocal(apf::Mesh* m, apf::NodeNumberings& n)
+{
+  apf::Sparsity s;
+  apf::getSparsity(n.overlap, m->getDimension(), s);
+  PCU_ALWAYS_ASSERT(static_cast<int>(s.rows.size()) == n.overlapCount);
+  Pairs pairs;
+  apf::NewArray<int> numbers;
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int nn = apf::getElementNumbers(n.overlap, e, numbers);
+    for (int i = 0; i < nn; ++i)
+      for (int j = 0; j < nn; ++j)
+        pairs.insert(std::make_pair(numbers[i], numbers[j]));
+  }
+  m->end(it);
+  expectPairs(s, pairs);
+  for (size_t i = 0; i < s.rows.size(); ++i)
+    PCU_ALWAYS_ASSERT(s.offDiagonalCounts[i] == 0);
+}
+
+/* every part sends the couplings of its elements to the owners of
+   the rows, which numberAllNodes numbers in contiguous ranges */
+void checkGlobal(apf::Mesh* m, apf::NodeNumberings& n)
+{
+  apf::Sparsity s;
+  apf::getSparsity(n.global, m->getDimension(), s);
+  PCU_ALWAYS_ASSERT(static_cast<int>(s.rows.size()) == n.ownedCount);
+  int peers = PCU_Comm_Peers();
+  std::vector<long> starts(peers + 1);
+  PCU_Comm_Begin();
+  for (int p = 0; p < peers; ++p)
+    PCU_COMM_PACK(p, n.globalStart);
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    long start;
+    PCU_COMM_UNPACK(start);
+    starts[PCU_Comm_Sender()] = start;
+  }
+  starts[peers] = n.globalCount;
+  PCU_Comm_Begin();
+  apf::NewArray<long> numbers;
+  apf::MeshIterator* it = m->begin(m->getDimension());
+  apf::MeshEntity* e;
+  while ((e = m->iterate(it))) {
+    int nn = apf::getElementNumbers(n.global, e, numbers);
+    for (int i = 0; i < nn; ++i) {
+      int owner = std::upper_bound(starts.begin(), starts.end(),
+          numbers[i]) - starts.begin() - 1;
+      for (int j = 0; j < nn; ++j) {
+        PCU_COMM_PACK(owner, numbers[i]);
+        PCU_COMM_PACK(owner, numbers[j]);
+      }
+    }
+  }
+  m->end(it);
+  PCU_Comm_Send();
+  Pairs pairs;
+  while (PCU_Comm_Receive()) {
+    long row, column;
+    PCU_COMM_UNPACK(row);
+    PCU_COMM_UNPACK(column);
+    pairs.insert(std::make_pair(row, column));
+  }
+  expectPairs(s, pairs);
+  long end = n.globalStart + n.ownedCount;
+  long off = 0;
+  for (size_t i = 0; i < s.rows.size(); ++i) {
+    PCU_ALWAYS_ASSERT(s.rows[i] == n.globalStart + static_cast<long>(i));
+    int diagonal = 0;
+    for (int j = s.offsets[i]; j < s.offsets[i + 1]; ++j)
+      if (n.globalStart <= s.columns[j] && s.columns[j] < end)
+        ++diagonal;
+    PCU_ALWAYS_ASSERT(s.diagonalCounts[i] == diagonal);
+    PCU_ALWAYS_ASSERT(s.diagonalCounts[i] + s.offDiagonalCounts[i] ==
+        s.offsets[i + 1] - s.offsets[i]);
+    off += s.offDiagonalCounts[i];
+  }
+  if (PCU_Comm_Peers() > 1)
+    PCU_ALWAYS_ASSERT(PCU_Add_Long(off) > 0);
+}
+
+void test(apf::Mesh* m, apf::FieldShape* s)
+{
+  apf::NodeNumberings n;
+  apf::numberAllNodes(m, "sparsity", n, apf::RCM_ORDER, s);
+  checkLocal(m, n);
+  checkGlobal(m, n);
+  apf::destroyNodeNumberings(n);
+}
+
+}
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  PCU_Comm_Init();
+  PCU_ALWAYS_ASSERT(argc == 1);
+  gmi_model* g;
+  apf::Mesh2* m = makeBalancedBox(5, 5, 5, &g);
+  test(m, 0);
+  test(m, apf::getLagrange(2));
+  m->destroyNative();
+  apf::destroyMesh(m);
+  gmi_destroy(g);
+  PCU_Comm_Free();
+  MPI_Finalize();
+}
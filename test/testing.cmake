@@ -15,11 +15,27 @@ mpi_test(bezierMisc 1 ./bezierMisc)
 mpi_test(bezierRefine 1 ./bezierRefine)
 mpi_test(bezierSubdivision 1 ./bezierSubdivision)
 mpi_test(bezierValidity 1 ./bezierValidity)
+mpi_test(bezier_timing 1 ./bezier_timing 1000)
 
 mpi_test(align 1 ./align)
 mpi_test(eigen_test 1 ./eigen_test)
 mpi_test(integrate 1 ./integrate)
+mpi_test(shapeTable 1 ./shapeTable)
+mpi_test(blockIntegrate 1 ./blockIntegrate)
+mpi_test(elementReset 1 ./elementReset)
+mpi_test(frozenArray 1 ./frozenArray)
+mpi_test(numberAll 4
+  ./numberAll)
+mpi_test(sparsity 4
+  ./sparsity)
+mpi_test(accumulate 4
+  ./accumulate)
+mpi_test(cavity 4
+  ./cavity)
+mpi_test(matrix_timing 1
+  ./matrix_timing 10)
 mpi_test(qr_test 1 ./qr)
+mpi_test(gmi_batch 1 ./gmi_batch)
 mpi_test(base64 1 ./base64)
 mpi_test(tensor_test 1 ./tensor)
 
@@ -282,6 +298,10 @@ mpi_test(vtxBalance 4
   "${MDIR}/afosr.${GXT}"
   "${MDIR}/4imb/"
   "afosrBal4p/")
+mpi_test(flowBalance 4
+  ./flowBalance)
+mpi_test(parmaTracker 4
+  ./parmaTracker)
 mpi_test(vtxEdgeElmBalance 4
   ./vtxEdgeElmBalance
   "${MDIR}/afosr.${GXT}"
@@ -399,6 +419,22 @@ mpi_test(change_dim 1
   ./newdim)
 mpi_test(ma_insphere 1
   ./ma_insphere)
+mpi_test(ma_quality_batch 1
+  ./ma_quality_batch)
+mpi_test(ma_predictive 4
+  ./ma_predictive)
+mpi_test(ma_batch_refine 4
+  ./ma_batch_refine)
+mpi_test(sfcBalance 4
+  ./geomBalance sfc)
+mpi_test(ribBalance 3
+  ./geomBalance rib)
+mpi_test(graphBalance 4
+  ./geomBalance graph)
+mpi_test(parmaColor 4
+  ./parmaColor)
+mpi_test(ptnReport 4
+  ./ptnReport)
 if(ENABLE_SIMMETRIX)
   set(MDIR ${MESHES}/upright)
   mpi_test(parallel_meshgen 4
@@ -0,0 +1,535 @@
+/*
+ * Copyright (C) 2014 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "apfZoltan.h"
+#include "apfGraphPartition.h"
+#include <apfPartition.h>
+#include <apfMesh.h>
+#include <apf.h>
+#include <PCU.h>
+#include <pcu_util.h>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace apf {
+
+enum {
+  /* size of the global coarse graph partitioned by the first rank */
+  GLOBAL_COARSE = 20000,
+  /* coarse vertices per target part */
+  COARSE_PER_PART = 16,
+  /* rounds of parallel boundary refinement */
+  REFINE_ROUNDS = 8
+};
+
+/* the element dual graph of the part, elements sharing a side are
+   adjacent. (ids) is set to the local index of each element */
+struct DualGraph
+{
+  std::vector<MeshEntity*> elements;
+  Graph graph;
+};
+
+static void getDualGraph(Mesh* m, MeshTag* weights, MeshTag* ids,
+    DualGraph& d)
+{
+  int dim = m->getDimension();
+  std::vector<double> w;
+  MeshIterator* it = m->begin(dim);
+  MeshEntity* e;
+  int i = 0;
+  while ((e = m->iterate(it))) {
+    m->setIntTag(e, ids, &i);
+    ++i;
+    d.elements.push_back(e);
+    double x = 1;
+    if (weights)
+      m->getDoubleTag(e, weights, &x);
+    w.push_back(x);
+  }
+  m->end(it);
+  std::vector<GraphEdge> edges;
+  for (i = 0; i < static_cast<int>(d.elements.size()); ++i) {
+    Downward sides;
+    int ns = m->getDownward(d.elements[i], dim - 1, sides);
+    for (int s = 0; s < ns; ++s) {
+      Up up;
+      m->getUp(sides[s], up);
+      for (int k = 0; k < up.n; ++k) {
+        if (up.e[k] == d.elements[i])
+          continue;
+        GraphEdge edge;
+        edge.from = i;
+        m->getIntTag(up.e[k], ids, &edge.to);
+        edge.weight = 1;
+        edges.push_back(edge);
+      }
+    }
+  }
+  makeGraph(w, edges, d.graph);
+}
+
+static MeshTag* getDualGraph(Mesh* m, MeshTag* weights, DualGraph& d)
+{
+  MeshTag* ids = m->createIntTag("apf_graph_id", 1);
+  getDualGraph(m, weights, ids, d);
+  return ids;
+}
+
+static void destroyIds(Mesh* m, MeshTag* ids)
+{
+  removeTagFromDimension(m, ids, m->getDimension());
+  m->destroyTag(ids);
+}
+
+/* the shared sides of the part, each with a slot tag holding its
+   index and the local index of the element it bounds */
+struct Boundary
+{
+  std::vector<MeshEntity*> sides;
+  std::vector<int> elements;
+  MeshTag* slots;
+};
+
+static void getBoundary(Mesh* m, MeshTag* ids, Boundary& b)
+{
+  b.slots = m->createIntTag("apf_graph_slot", 1);
+  MeshEntity* s;
+  MeshIterator* it = m->begin(m->getDimension() - 1);
+  while ((s = m->iterate(it))) {
+    if (!m->isShared(s))
+      continue;
+    int slot = static_cast<int>(b.sides.size());
+    int i;
+    m->getIntTag(m->getUpward(s, 0), ids, &i);
+    m->setIntTag(s, b.slots, &slot);
+    b.sides.push_back(s);
+    b.elements.push_back(i);
+  }
+  m->end(it);
+}
+
+static void destroyBoundary(Mesh* m, Boundary& b)
+{
+  for (size_t k = 0; k < b.sides.size(); ++k)
+    m->removeTag(b.sides[k], b.slots);
+  m->destroyTag(b.slots);
+}
+
+/* sends one value per shared side to the other copy,
+   across[k] receives the value of the other side of slot k */
+static void exchange(Mesh* m, Boundary const& b,
+    std::vector<int> const& values, std::vector<int>& across)
+{
+  across.resize(b.sides.size());
+  PCU_Comm_Begin();
+  for (size_t k = 0; k < b.sides.size(); ++k) {
+    Copy other = getOtherCopy(m, b.sides[k]);
+    PCU_COMM_PACK(other.peer, other.entity);
+    PCU_COMM_PACK(other.peer, values[k]);
+  }
+  PCU_Comm_Send();
+  while (PCU_Comm_Receive()) {
+    MeshEntity* s;
+    int value, slot;
+    PCU_COMM_UNPACK(s);
+    PCU_COMM_UNPACK(value);
+    m->getIntTag(s, b.slots, &slot);
+    across[slot] = value;
+  }
+}
+
+/* coarse graph edges between parts, found through shared sides */
+static void getCrossEdges(Mesh* m, Boundary const& b,
+    std::vector<int> const& vertices, int first,
+    std::vector<GraphEdge>& edges)
+{
+  std::vector<int> gids(vertices.size());
+  for (size_t k = 0; k < vertices.size(); ++k)
+    gids[k] = first + vertices[k];
+  std::vector<int> across;
+  exchange(m, b, gids, across);
+  for (size_t k = 0; k < gids.size(); ++k) {
+    GraphEdge e;
+    e.from = gids[k];
+    e.to = across[k];
+    e.weight = 1;
+    edges.push_back(e);
+  }
+}
+
+/* every rank sends its coarse graph to the first rank, which
+   partitions their union and returns the label of each coarse vertex */
+static void partitionOnFirst(Graph const& coarse, int first, long total,
+    std::vector<GraphEdge>& edges, int parts, double tolerance,
+    std::vector<int>& labels)
+{
+  int nc = coarse.count();
+  size_t ne = edges.size();
+  PCU_Comm_Begin();
+  PCU_COMM_PACK(0, first);
+  PCU_COMM_PACK(0, nc);
+  PCU_COMM_PACK(0, ne);
+  if (nc)
+    PCU_Comm_Pack(0, &coarse.weights[0], nc * sizeof(double));
+  if (ne)
+    PCU_Comm_Pack(0, &edges[0], ne * sizeof(GraphEdge));
+  PCU_Comm_Send();
+  std::vector<int> senders, firsts, counts;
+  std::vector<double> weights(PCU_Comm_Self() ? 0 : total);
+  std::vector<GraphEdge> allEdges;
+  while (PCU_Comm_Receive()) {
+    int from, n;
+    size_t m;
+    PCU_COMM_UNPACK(from);
+    PCU_COMM_UNPACK(n);
+    PCU_COMM_UNPACK(m);
+    if (n)
+      PCU_Comm_Unpack(&weights[from], n * sizeof(double));
+    size_t old = allEdges.size();
+    allEdges.resize(old + m);
+    if (m)
+      PCU_Comm_Unpack(&allEdges[old], m * sizeof(GraphEdge));
+    senders.push_back(PCU_Comm_Sender());
+    firsts.push_back(from);
+    counts.push_back(n);
+  }
+  std::vector<int> all;
+  if (!PCU_Comm_Self()) {
+    Graph g;
+    makeGraph(weights, allEdges, g);
+    partitionGraph(g, parts, tolerance, all);
+  }
+  PCU_Comm_Begin();
+  for (size_t i = 0; i < senders.size(); ++i)
+    if (counts[i])
+      PCU_Comm_Pack(senders[i], &all[firsts[i]], counts[i] * sizeof(int));
+  PCU_Comm_Send();
+  labels.resize(nc);
+  while (PCU_Comm_Receive())
+    PCU_Comm_Unpack(&labels[0], nc * sizeof(int));
+}
+
+struct Move
+{
+  long gain;
+  int element;
+  int to;
+  bool balance;
+};
+
+static bool operator<(Move const& a, Move const& b)
+{
+  if (a.gain != b.gain)
+    return a.gain > b.gain;
+  return a.element < b.element;
+}
+
+/* greedy boundary refinement of the labels of one level over all
+   ranks. (vertices) holds the vertex bounded by each shared side.
+   labels across shared sides are exchanged every round and each rank
+   gets a share of the room left in a part proportional to the weight
+   it asks to move there. moves go only up in label in even rounds and
+   only down in odd rounds so that neighbors do not swap vertices */
+static void refineLevel(Mesh* m, Boundary const& b,
+    std::vector<int> const& vertices, Graph const& g, int parts,
+    double maxWeight, std::vector<int>& part)
+{
+  int n = g.count();
+  std::vector<int> sideOffsets(n + 1, 0);
+  for (size_t k = 0; k < vertices.size(); ++k)
+    ++sideOffsets[vertices[k] + 1];
+  for (int i = 0; i < n; ++i)
+    sideOffsets[i + 1] += sideOffsets[i];
+  std::vector<int> slots(vertices.size());
+  {
+    std::vector<int> next(sideOffsets.begin(), sideOffsets.end() - 1);
+    for (size_t k = 0; k < vertices.size(); ++k)
+      slots[next[vertices[k]]++] = static_cast<int>(k);
+  }
+  std::vector<int> labels(vertices.size()), across;
+  std::vector<double> pw(parts), wanted(parts), room(parts);
+  std::vector<long> conn(parts, 0);
+  std::vector<int> touched;
+  for (int round = 0; round < REFINE_ROUNDS; ++round) {
+    for (size_t k = 0; k < vertices.size(); ++k)
+      labels[k] = part[vertices[k]];
+    exchange(m, b, labels, across);
+    std::fill(pw.begin(), pw.end(), 0.0);
+    for (int v = 0; v < n; ++v)
+      pw[part[v]] += g.weights[v];
+    PCU_Add_Doubles(&pw[0], parts);
+    bool up = !(round % 2);
+    std::vector<Move> moves;
+    for (int v = 0; v < n; ++v) {
+      int a = part[v];
+      touched.clear();
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+        int p = part[g.adjacency[j]];
+        if (!conn[p])
+          touched.push_back(p);
+        conn[p] += g.edgeWeights[j];
+      }
+      for (int j = sideOffsets[v]; j < sideOffsets[v + 1]; ++j) {
+        int p = across[slots[j]];
+        if (!conn[p])
+          touched.push_back(p);
+        ++conn[p];
+      }
+      long internal = conn[a];
+      bool over = pw[a] > maxWeight;
+      double w = g.weights[v];
+      Move best;
+      best.to = a;
+      best.gain = 0;
+      for (size_t i = 0; i < touched.size(); ++i) {
+        int p = touched[i];
+        if (p == a || (p > a) != up || pw[p] + w > maxWeight)
+          continue;
+        long gain = conn[p] - internal;
+        bool better;
+        if (best.to == a)
+          better = gain > 0 || over || (gain == 0 && pw[p] + w < pw[a]);
+        else
+          better = gain > best.gain ||
+            (gain == best.gain && pw[p] < pw[best.to]);
+        if (better) {
+          best.to = p;
+          best.gain = gain;
+        }
+      }
+      for (size_t i = 0; i < touched.size(); ++i)
+        conn[touched[i]] = 0;
+      if (best.to == a)
+        continue;
+      best.element = v;
+      best.balance = best.gain <= 0;
+      moves.push_back(best);
+    }
+    std::fill(wanted.begin(), wanted.end(), 0.0);
+    for (size_t i = 0; i < moves.size(); ++i)
+      wanted[moves[i].to] += g.weights[moves[i].element];
+    room = wanted;
+    PCU_Add_Doubles(&wanted[0], parts);
+    for (int p = 0; p < parts; ++p) {
+      double left = std::max(0.0, maxWeight - pw[p]);
+      if (wanted[p] > left)
+        room[p] *= left / wanted[p];
+    }
+    std::sort(moves.begin(), moves.end());
+    int moved = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+      Move const& mv = moves[i];
+      int v = mv.element;
+      double w = g.weights[v];
+      if (w > room[mv.to])
+        continue;
+      /* earlier moves may have changed the gain */
+      long gain = 0;
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+        int p = part[g.adjacency[j]];
+        if (p == mv.to)
+          gain += g.edgeWeights[j];
+        else if (p == part[v])
+          gain -= g.edgeWeights[j];
+      }
+      for (int j = sideOffsets[v]; j < sideOffsets[v + 1]; ++j) {
+        int p = across[slots[j]];
+        if (p == mv.to)
+          ++gain;
+        else if (p == part[v])
+          --gain;
+      }
+      if (gain < mv.gain || (!mv.balance && gain <= 0))
+        continue;
+      part[v] = mv.to;
+      room[mv.to] -= w;
+      ++moved;
+    }
+    if (!PCU_Add_Int(moved))
+      break;
+  }
+}
+
+/* partitions the element dual graph of the whole mesh.
+   each rank coarsens the graph of its own elements level by level,
+   the first rank partitions the union of the coarsest graphs and the
+   labels are refined in parallel at every level on the way back */
+static void partitionGlobally(Mesh* m, MeshTag* weights, double tolerance,
+    int parts, DualGraph& d, std::vector<int>& part)
+{
+  MeshTag* ids = getDualGraph(m, weights, d);
+  Boundary b;
+  getBoundary(m, ids, b);
+  destroyIds(m, ids);
+  int peers = PCU_Comm_Peers();
+  int target = std::max(COARSE_PER_PART * parts, int(GLOBAL_COARSE)) / peers;
+  std::vector<Graph*> levels(1, &d.graph);
+  std::vector<std::vector<int> > maps;
+  std::vector<std::vector<int> > vertices(1, b.elements);
+  while (levels.back()->count() > target) {
+    Graph const& fine = *levels.back();
+    std::vector<int> map;
+    Graph* coarse = new Graph();
+    coarsenGraph(fine, std::max(target, fine.count() / 2), map, *coarse);
+    if (coarse->count() == fine.count()) {
+      delete coarse;
+      break;
+    }
+    std::vector<int> coarseVertices(b.sides.size());
+    for (size_t k = 0; k < b.sides.size(); ++k)
+      coarseVertices[k] = map[vertices.back()[k]];
+    vertices.push_back(coarseVertices);
+    maps.push_back(map);
+    levels.push_back(coarse);
+  }
+  Graph const& coarsest = *levels.back();
+  long total = PCU_Add_Long(coarsest.count());
+  PCU_ALWAYS_ASSERT(total < INT_MAX);
+  int first = static_cast<int>(PCU_Exscan_Long(coarsest.count()));
+  std::vector<GraphEdge> edges;
+  getCrossEdges(m, b, vertices.back(), first, edges);
+  for (int v = 0; v < coarsest.count(); ++v)
+    for (int j = coarsest.offsets[v]; j < coarsest.offsets[v + 1]; ++j) {
+      GraphEdge e;
+      e.from = first + v;
+      e.to = first + coarsest.adjacency[j];
+      e.weight = coarsest.edgeWeights[j];
+      edges.push_back(e);
+    }
+  partitionOnFirst(coarsest, first, total, edges, parts, tolerance, part);
+  double local = 0;
+  for (int v = 0; v < d.graph.count(); ++v)
+    local += d.graph.weights[v];
+  double maxWeight = tolerance * PCU_Add_Double(local) / parts;
+  /* ranks may coarsen to different depths, the shallower ones
+     refine their coarsest level again to stay in step */
+  int depth = static_cast<int>(levels.size());
+  int maxDepth = PCU_Max_Int(depth);
+  for (int l = maxDepth - 1; l >= 0; --l) {
+    int i = std::min(l, depth - 1);
+    if (l < depth - 1) {
+      std::vector<int> finer(levels[l]->count());
+      for (int v = 0; v < levels[l]->count(); ++v)
+        finer[v] = part[maps[l][v]];
+      part.swap(finer);
+    }
+    refineLevel(m, b, vertices[i], *levels[i], parts, maxWeight, part);
+  }
+  for (size_t l = 1; l < levels.size(); ++l)
+    delete levels[l];
+  destroyBoundary(m, b);
+}
+
+class GraphSplitter : public Splitter
+{
+  public:
+    GraphSplitter(Mesh* m, bool sync):
+      mesh(m),
+      isSynchronous(sync)
+    {}
+    virtual ~GraphSplitter() {}
+    virtual Migration* split(MeshTag* weights, double tolerance, int multiple)
+    {
+      double t0 = PCU_Time();
+      DualGraph d;
+      destroyIds(mesh, getDualGraph(mesh, weights, d));
+      std::vector<int> part;
+      partitionGraph(d.graph, multiple, tolerance, part);
+      int offset = isSynchronous ? PCU_Proc_Self() * multiple : 0;
+      Migration* plan = new Migration(mesh);
+      for (size_t i = 0; i < d.elements.size(); ++i)
+        if (part[i])
+          plan->send(d.elements[i], part[i] + offset);
+      double t1 = PCU_Time();
+      if (!PCU_Comm_Self())
+        fprintf(stdout, "planned graph split factor %d to target"
+            " imbalance %f in %f seconds\n", multiple, tolerance, t1 - t0);
+      return plan;
+    }
+  private:
+    Mesh* mesh;
+    bool isSynchronous;
+};
+
+class GraphGlobalSplitter : public Splitter
+{
+  public:
+    GraphGlobalSplitter(Mesh* m):
+      mesh(m)
+    {}
+    virtual ~GraphGlobalSplitter() {}
+    virtual Migration* split(MeshTag* weights, double tolerance, int multiple)
+    {
+      double t0 = PCU_Time();
+      DualGraph d;
+      std::vector<int> part;
+      partitionGlobally(mesh, weights, tolerance,
+          multiple * PCU_Comm_Peers(), d, part);
+      Migration* plan = new Migration(mesh);
+      for (size_t i = 0; i < d.elements.size(); ++i)
+        if (part[i] != PCU_Comm_Self())
+          plan->send(d.elements[i], part[i]);
+      double t1 = PCU_Time();
+      if (!PCU_Comm_Self())
+        fprintf(stdout, "planned graph global split factor %d to target"
+            " imbalance %f in %f seconds\n", multiple, tolerance, t1 - t0);
+      return plan;
+    }
+  private:
+    Mesh* mesh;
+};
+
+class GraphBalancer : public Balancer
+{
+  public:
+    GraphBalancer(Mesh* m):
+      mesh(m)
+    {}
+    virtual ~GraphBalancer() {}
+    virtual void balance(MeshTag* weights, double tolerance)
+    {
+      double t0 = PCU_Time();
+      DualGraph d;
+      std::vector<int> part;
+      partitionGlobally(mesh, weights, tolerance, PCU_Comm_Peers(), d, part);
+      Migration* plan = new Migration(mesh);
+      for (size_t i = 0; i < d.elements.size(); ++i)
+        if (part[i] != PCU_Comm_Self())
+          plan->send(d.elements[i], part[i]);
+      plan = remapMigration(plan, weights);
+      if (!PCU_Comm_Self())
+        fprintf(stdout, "planned graph balance to target "
+            "imbalance %f in %f seconds\n",
+            tolerance, PCU_Time() - t0);
+      mesh->migrate(plan);
+      double t1 = PCU_Time();
+      if (!PCU_Comm_Self())
+        printf("graph balanced to %f in %f seconds\n",
+            tolerance, t1-t0);
+    }
+  private:
+    Mesh* mesh;
+};
+
+Splitter* makeGraphSplitter(Mesh* mesh, bool sync)
+{
+  return new GraphSplitter(mesh, sync);
+}
+
+Splitter* makeGraphGlobalSplitter(Mesh* mesh)
+{
+  return new GraphGlobalSplitter(mesh);
+}
+
+Balancer* makeGraphBalancer(Mesh* mesh)
+{
+  return new GraphBalancer(mesh);
+}
+
+}
@@ -0,0 +1,542 @@
+/*
+ * Copyright (C) 2014 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#include "apfGraphPartition.h"
+#include <pcu_util.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace apf {
+
+enum {
+  /* a bisection coarsens down to about this many vertices */
+  COARSEST = 64,
+  /* initial bisections grown from different seeds */
+  TRIALS = 8,
+  /* Fiduccia-Mattheyses passes per level */
+  FM_PASSES = 4,
+  /* moves without improvement after which a pass stops */
+  FM_PATIENCE = 64,
+  /* passes of greedy k-way boundary refinement */
+  KWAY_PASSES = 8
+};
+
+static bool operator<(GraphEdge const& a, GraphEdge const& b)
+{
+  if (a.from != b.from)
+    return a.from < b.from;
+  return a.to < b.to;
+}
+
+void makeGraph(std::vector<double> const& weights,
+    std::vector<GraphEdge>& edges, Graph& g)
+{
+  std::sort(edges.begin(), edges.end());
+  int n = static_cast<int>(weights.size());
+  g.weights = weights;
+  g.offsets.assign(n + 1, 0);
+  g.adjacency.clear();
+  g.edgeWeights.clear();
+  size_t i = 0;
+  for (int v = 0; v < n; ++v) {
+    for (; i < edges.size() && edges[i].from == v; ++i) {
+      GraphEdge const& e = edges[i];
+      if (e.to == v)
+        continue;
+      if (static_cast<int>(g.adjacency.size()) > g.offsets[v] &&
+          g.adjacency.back() == e.to) {
+        g.edgeWeights.back() += e.weight;
+      } else {
+        g.adjacency.push_back(e.to);
+        g.edgeWeights.push_back(e.weight);
+      }
+    }
+    g.offsets[v + 1] = static_cast<int>(g.adjacency.size());
+  }
+  PCU_ALWAYS_ASSERT(i == edges.size());
+}
+
+/* a small generator so that partitions are reproducible */
+class Random
+{
+  public:
+    Random(unsigned long seed):state(seed) {}
+    int next(int n)
+    {
+      state = state * 6364136223846793005UL + 1442695040888963407UL;
+      return static_cast<int>((state >> 33) % n);
+    }
+  private:
+    unsigned long state;
+};
+
+static double getTotalWeight(Graph const& g)
+{
+  double total = 0;
+  for (int v = 0; v < g.count(); ++v)
+    total += g.weights[v];
+  return total;
+}
+
+/* visits the vertices in random order and matches each one to the
+   unmatched neighbor across its heaviest edge. returns the number of
+   coarse vertices and fills map with the coarse vertex of each vertex */
+static int matchHeavyEdges(Graph const& g, double maxWeight, Random& r,
+    std::vector<int>& map)
+{
+  int n = g.count();
+  std::vector<int> order(n);
+  for (int i = 0; i < n; ++i)
+    order[i] = i;
+  for (int i = n - 1; i > 0; --i)
+    std::swap(order[i], order[r.next(i + 1)]);
+  std::vector<int> mate(n, -1);
+  for (int i = 0; i < n; ++i) {
+    int v = order[i];
+    if (mate[v] != -1)
+      continue;
+    int best = v;
+    int bestWeight = 0;
+    for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+      int u = g.adjacency[j];
+      if (mate[u] != -1 || g.weights[v] + g.weights[u] > maxWeight)
+        continue;
+      if (g.edgeWeights[j] > bestWeight) {
+        best = u;
+        bestWeight = g.edgeWeights[j];
+      }
+    }
+    mate[v] = best;
+    mate[best] = v;
+  }
+  map.assign(n, -1);
+  int nc = 0;
+  for (int v = 0; v < n; ++v)
+    if (map[v] == -1)
+      map[v] = map[mate[v]] = nc++;
+  return nc;
+}
+
+static void contract(Graph const& g, std::vector<int> const& map, int nc,
+    Graph& coarse)
+{
+  std::vector<double> weights(nc, 0.0);
+  std::vector<GraphEdge> edges;
+  edges.reserve(g.adjacency.size());
+  for (int v = 0; v < g.count(); ++v) {
+    weights[map[v]] += g.weights[v];
+    for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+      GraphEdge e;
+      e.from = map[v];
+      e.to = map[g.adjacency[j]];
+      e.weight = g.edgeWeights[j];
+      if (e.from != e.to)
+        edges.push_back(e);
+    }
+  }
+  makeGraph(weights, edges, coarse);
+}
+
+/* one level of coarsening, returns false if the graph stopped shrinking */
+static bool coarsen(Graph const& g, double maxWeight, Random& r,
+    std::vector<int>& map, Graph& coarse)
+{
+  int nc = matchHeavyEdges(g, maxWeight, r, map);
+  if (nc > 0.95 * g.count())
+    return false;
+  contract(g, map, nc, coarse);
+  return true;
+}
+
+void coarsenGraph(Graph const& g, int target, std::vector<int>& map,
+    Graph& coarse)
+{
+  int n = g.count();
+  map.resize(n);
+  for (int i = 0; i < n; ++i)
+    map[i] = i;
+  coarse = g;
+  target = std::max(target, 1);
+  double maxWeight = 1.5 * getTotalWeight(g) / target;
+  Random r(n);
+  while (coarse.count() > target) {
+    std::vector<int> level;
+    Graph next;
+    if (!coarsen(coarse, maxWeight, r, level, next))
+      break;
+    for (int i = 0; i < n; ++i)
+      map[i] = level[map[i]];
+    std::swap(coarse, next);
+  }
+}
+
+long getEdgeCut(Graph const& g, std::vector<int> const& part)
+{
+  long cut = 0;
+  for (int v = 0; v < g.count(); ++v)
+    for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+      if (part[v] != part[g.adjacency[j]])
+        cut += g.edgeWeights[j];
+  return cut / 2;
+}
+
+struct Balance
+{
+  double max[2];
+  double getViolation(double const w[2]) const
+  {
+    return std::max(0.0, w[0] - max[0]) + std::max(0.0, w[1] - max[1]);
+  }
+};
+
+static void getSideWeights(Graph const& g, std::vector<int> const& side,
+    double w[2])
+{
+  w[0] = w[1] = 0;
+  for (int v = 0; v < g.count(); ++v)
+    w[side[v]] += g.weights[v];
+}
+
+/* edge weight to the other side minus edge weight to the same side */
+static long getGain(Graph const& g, std::vector<int> const& side, int v)
+{
+  long gain = 0;
+  for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+    if (side[g.adjacency[j]] == side[v])
+      gain -= g.edgeWeights[j];
+    else
+      gain += g.edgeWeights[j];
+  return gain;
+}
+
+typedef std::set<std::pair<long, int> > GainQueue;
+
+/* picks the side to move a vertex from. an overweight side sheds
+   vertices first, otherwise the higher gain wins among the moves
+   that keep the receiving side within its bound */
+static int pickSide(Graph const& g, Balance const& b, double const w[2],
+    GainQueue const q[2])
+{
+  bool can[2];
+  for (int s = 0; s < 2; ++s) {
+    can[s] = false;
+    if (q[s].empty())
+      continue;
+    int v = q[s].begin()->second;
+    can[s] = (w[1 - s] + g.weights[v] <= b.max[1 - s]) || (w[s] > b.max[s]);
+  }
+  for (int s = 0; s < 2; ++s)
+    if (can[s] && w[s] > b.max[s])
+      return s;
+  if (can[0] && can[1])
+    return (q[0].begin()->first <= q[1].begin()->first) ? 0 : 1;
+  if (can[0])
+    return 0;
+  if (can[1])
+    return 1;
+  return -1;
+}
+
+/* Fiduccia-Mattheyses refinement of a bisection. each pass moves every
+   vertex at most once, highest gain first, and then rolls back to the
+   best prefix of moves, preferring balance over cut */
+static void refineBisection(Graph const& g, Balance const& b,
+    std::vector<int>& side)
+{
+  int n = g.count();
+  std::vector<long> gain(n);
+  std::vector<bool> locked(n);
+  for (int pass = 0; pass < FM_PASSES; ++pass) {
+    double w[2];
+    getSideWeights(g, side, w);
+    GainQueue q[2];
+    long cut = 0;
+    for (int v = 0; v < n; ++v) {
+      gain[v] = getGain(g, side, v);
+      locked[v] = false;
+      long external = 0;
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j)
+        if (side[g.adjacency[j]] != side[v])
+          external += g.edgeWeights[j];
+      cut += external;
+      if (external)
+        q[side[v]].insert(std::make_pair(-gain[v], v));
+    }
+    cut /= 2;
+    long bestCut = cut;
+    double bestViolation = b.getViolation(w);
+    std::vector<int> moves;
+    size_t best = 0;
+    int from;
+    while ((from = pickSide(g, b, w, q)) != -1) {
+      int v = q[from].begin()->second;
+      q[from].erase(q[from].begin());
+      int to = 1 - from;
+      side[v] = to;
+      w[from] -= g.weights[v];
+      w[to] += g.weights[v];
+      cut -= gain[v];
+      locked[v] = true;
+      moves.push_back(v);
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+        int u = g.adjacency[j];
+        if (locked[u])
+          continue;
+        q[side[u]].erase(std::make_pair(-gain[u], u));
+        if (side[u] == to)
+          gain[u] -= 2 * g.edgeWeights[j];
+        else
+          gain[u] += 2 * g.edgeWeights[j];
+        q[side[u]].insert(std::make_pair(-gain[u], u));
+      }
+      double violation = b.getViolation(w);
+      if (violation < bestViolation ||
+          (violation == bestViolation && cut < bestCut)) {
+        best = moves.size();
+        bestCut = cut;
+        bestViolation = violation;
+      } else if (moves.size() - best > FM_PATIENCE) {
+        break;
+      }
+    }
+    for (size_t i = moves.size(); i > best; --i)
+      side[moves[i - 1]] ^= 1;
+    if (!best)
+      break;
+  }
+}
+
+/* grows side zero breadth first from the seed until it holds the
+   target weight, jumping to unvisited vertices if the graph is not
+   connected */
+static void growBisection(Graph const& g, double target, int seed,
+    std::vector<int>& side)
+{
+  int n = g.count();
+  side.assign(n, 1);
+  std::vector<bool> seen(n, false);
+  std::vector<int> queue;
+  queue.push_back(seed);
+  seen[seed] = true;
+  size_t head = 0;
+  int next = 0;
+  double weight = 0;
+  while (weight < target) {
+    if (head == queue.size()) {
+      while (next < n && seen[next])
+        ++next;
+      if (next == n)
+        break;
+      seen[next] = true;
+      queue.push_back(next);
+    }
+    int v = queue[head++];
+    side[v] = 0;
+    weight += g.weights[v];
+    for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+      int u = g.adjacency[j];
+      if (!seen[u]) {
+        seen[u] = true;
+        queue.push_back(u);
+      }
+    }
+  }
+}
+
+/* multilevel bisection giving side zero (fraction) of the weight */
+static void bisect(Graph const& g, double fraction, double eps,
+    std::vector<int>& side)
+{
+  int n = g.count();
+  side.assign(n, 1);
+  if (!n)
+    return;
+  double total = getTotalWeight(g);
+  Balance b;
+  b.max[0] = fraction * total * (1 + eps);
+  b.max[1] = (1 - fraction) * total * (1 + eps);
+  std::vector<std::vector<int> > maps;
+  std::vector<Graph*> levels;
+  Graph const* coarsest = &g;
+  double maxWeight = 1.5 * total / COARSEST;
+  Random r(n);
+  while (coarsest->count() > COARSEST) {
+    std::vector<int> map;
+    Graph* next = new Graph();
+    if (!coarsen(*coarsest, maxWeight, r, map, *next)) {
+      delete next;
+      break;
+    }
+    maps.push_back(map);
+    levels.push_back(next);
+    coarsest = next;
+  }
+  long bestCut = 0;
+  double bestViolation = 0;
+  for (int t = 0; t < TRIALS; ++t) {
+    std::vector<int> trial;
+    growBisection(*coarsest, fraction * total,
+        r.next(coarsest->count()), trial);
+    refineBisection(*coarsest, b, trial);
+    double w[2];
+    getSideWeights(*coarsest, trial, w);
+    double violation = b.getViolation(w);
+    long cut = getEdgeCut(*coarsest, trial);
+    if (!t || violation < bestViolation ||
+        (violation == bestViolation && cut < bestCut)) {
+      side = trial;
+      bestCut = cut;
+      bestViolation = violation;
+    }
+  }
+  for (size_t l = maps.size(); l > 0; --l) {
+    Graph const* finer = (l > 1) ? levels[l - 2] : &g;
+    std::vector<int> projected(finer->count());
+    for (int v = 0; v < finer->count(); ++v)
+      projected[v] = side[maps[l - 1][v]];
+    side.swap(projected);
+    refineBisection(*finer, b, side);
+  }
+  for (size_t l = 0; l < levels.size(); ++l)
+    delete levels[l];
+}
+
+/* the subgraph induced by (vertices), local[v] must be -1 for all
+   vertices on entry and is again on exit */
+static void getSubgraph(Graph const& g, std::vector<int> const& vertices,
+    std::vector<int>& local, Graph& sub)
+{
+  int n = static_cast<int>(vertices.size());
+  for (int i = 0; i < n; ++i)
+    local[vertices[i]] = i;
+  std::vector<double> weights(n);
+  std::vector<GraphEdge> edges;
+  for (int i = 0; i < n; ++i) {
+    int v = vertices[i];
+    weights[i] = g.weights[v];
+    for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+      int u = local[g.adjacency[j]];
+      if (u == -1)
+        continue;
+      GraphEdge e;
+      e.from = i;
+      e.to = u;
+      e.weight = g.edgeWeights[j];
+      edges.push_back(e);
+    }
+  }
+  makeGraph(weights, edges, sub);
+  for (int i = 0; i < n; ++i)
+    local[vertices[i]] = -1;
+}
+
+static void partitionRecursively(Graph const& g,
+    std::vector<int> const& vertices, int parts, int first, double eps,
+    std::vector<int>& local, std::vector<int>& part)
+{
+  if (parts == 1) {
+    for (size_t i = 0; i < vertices.size(); ++i)
+      part[vertices[i]] = first;
+    return;
+  }
+  int left = parts / 2;
+  std::vector<int> halves[2];
+  {
+    Graph sub;
+    getSubgraph(g, vertices, local, sub);
+    std::vector<int> side;
+    bisect(sub, double(left) / parts, eps, side);
+    for (size_t i = 0; i < vertices.size(); ++i)
+      halves[side[i]].push_back(vertices[i]);
+  }
+  partitionRecursively(g, halves[0], left, first, eps, local, part);
+  partitionRecursively(g, halves[1], parts - left, first + left, eps,
+      local, part);
+}
+
+/* moves boundary vertices to the neighboring part they share the most
+   edge weight with, as long as that part stays below maxWeight.
+   moves without gain are taken only if they improve the balance */
+static void refineKway(Graph const& g, int parts, double maxWeight,
+    std::vector<int>& part)
+{
+  int n = g.count();
+  std::vector<double> pw(parts, 0.0);
+  for (int v = 0; v < n; ++v)
+    pw[part[v]] += g.weights[v];
+  std::vector<long> conn(parts, 0);
+  std::vector<int> touched;
+  for (int pass = 0; pass < KWAY_PASSES; ++pass) {
+    int moved = 0;
+    for (int v = 0; v < n; ++v) {
+      int a = part[v];
+      double w = g.weights[v];
+      touched.clear();
+      for (int j = g.offsets[v]; j < g.offsets[v + 1]; ++j) {
+        int p = part[g.adjacency[j]];
+        if (!conn[p])
+          touched.push_back(p);
+        conn[p] += g.edgeWeights[j];
+      }
+      long internal = conn[a];
+      bool over = pw[a] > maxWeight;
+      int best = a;
+      long bestGain = 0;
+      for (size_t i = 0; i < touched.size(); ++i) {
+        int p = touched[i];
+        if (p == a || pw[p] + w > maxWeight)
+          continue;
+        long gain = conn[p] - internal;
+        bool better;
+        if (best == a)
+          better = gain > 0 || over || (gain == 0 && pw[p] + w < pw[a]);
+        else
+          better = gain > bestGain ||
+            (gain == bestGain && pw[p] < pw[best]);
+        if (better) {
+          best = p;
+          bestGain = gain;
+        }
+      }
+      for (size_t i = 0; i < touched.size(); ++i)
+        conn[touched[i]] = 0;
+      if (best == a)
+        continue;
+      part[v] = best;
+      pw[a] -= w;
+      pw[best] += w;
+      ++moved;
+    }
+    if (!moved)
+      break;
+  }
+}
+
+void partitionGraph(Graph const& g, int parts, double tolerance,
+    std::vector<int>& part)
+{
+  int n = g.count();
+  part.assign(n, 0);
+  if (parts < 2 || !n)
+    return;
+  /* the imbalance of nested bisections compounds */
+  int depth = 0;
+  while ((1 << depth) < parts)
+    ++depth;
+  double eps = std::pow(std::max(tolerance, 1.0), 1.0 / depth) - 1;
+  eps = std::max(eps, 0.001);
+  std::vector<int> vertices(n);
+  for (int i = 0; i < n; ++i)
+    vertices[i] = i;
+  std::vector<int> local(n, -1);
+  partitionRecursively(g, vertices, parts, 0, eps, local, part);
+  double maxWeight = tolerance * getTotalWeight(g) / parts;
+  refineKway(g, parts, maxWeight, part);
+}
+
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2014 Scientific Computation Research Center
+ *
+ * This work is open source software, licensed under the terms of the
+ * BSD license as described in the LICENSE file in the top-level directory.
+ */
+
+#ifndef APF_GRAPH_PARTITION_H
+#define APF_GRAPH_PARTITION_H
+
+#include <vector>
+
+namespace apf {
+
+/* a weighted undirected graph in compressed sparse row form.
+   the neighbors of vertex i are adjacency[offsets[i]] up to
+   adjacency[offsets[i + 1]], every edge is stored in both directions */
+struct Graph
+{
+  std::vector<int> offsets;
+  std::vector<int> adjacency;
+  std::vector<int> edgeWeights;
+  std::vector<double> weights;
+  int count() const {return static_cast<int>(weights.size());}
+};
+
+struct GraphEdge
+{
+  int from;
+  int to;
+  int weight;
+};
+
+/* builds the graph of (weights.size()) vertices from edges given in both
+   directions. duplicate edges are merged by adding their weights and
+   self loops are dropped. (edges) is sorted */
+void makeGraph(std::vector<double> const& weights,
+    std::vector<GraphEdge>& edges, Graph& g);
+
+/* contracts the graph by repeated heavy edge matching until it has no
+   more than (target) vertices or stops shrinking. map[i] is the coarse
+   vertex of vertex i */
+void coarsenGraph(Graph const& g, int target, std::vector<int>& map,
+    Graph& coarse);
+
+/* multilevel recursive bisection into (parts) parts followed by k-way
+   boundary refinement. part weights aim to stay below (tolerance) times
+   the average. part[i] is in [0, parts) */
+void partitionGraph(Graph const& g, int parts, double tolerance,
+    std::vector<int>& part);
+
+/* number of edges, counted with their weights, between parts */
+long getEdgeCut(Graph const& g, std::vector<int> const& part);
+
+}
+
+#endif
@@ -56,6 +56,7 @@ class ZoltanBalancer : public Balancer
     {
       double t0 = PCU_Time();
       Migration* plan = bridge.run(weights, tolerance, 1);
+      plan = remapMigration(plan, weights);
       if (!PCU_Comm_Self())
         fprintf(stdout, "planned Zoltan balance to target "
             "imbalance %f in %f seconds\n",
@@ -70,6 +71,11 @@ class ZoltanBalancer : public Balancer
     ZoltanMesh bridge;
 };
 
+bool hasZoltan()
+{
+  return true;
+}
+
 Splitter* makeZoltanSplitter(Mesh* mesh, int method, int approach,
     bool debug, bool sync)
 {
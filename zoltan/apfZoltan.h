@@ -105,6 +105,33 @@ Splitter* makeZoltanGlobalSplitter(Mesh* mesh, int method, int approach,
 Balancer* makeZoltanBalancer(Mesh* mesh, int method, int approach,
     bool debug = true);
 
+/** \brief return true iff apf_zoltan was built with Zoltan support
+  \details when this is false, the make functions above serve
+  apf::GRAPH with the native graph partitioner below, ignoring
+  the approach, and fail for every other method */
+bool hasZoltan();
+
+/** \brief Make a native graph partitioning Splitter object
+  \details the resulting splitter applies multilevel recursive
+  bisection to the element dual graph of the local mesh part.
+  It needs neither Zoltan nor ParMETIS.
+  \param sync all parts are splitting by the same factor,
+              multiply the part ids in the resulting apf::Migration
+              accordingly */
+Splitter* makeGraphSplitter(Mesh* mesh, bool sync = true);
+
+/** \brief Make a native graph partitioning Splitter for the global mesh
+  \details each part coarsens the dual graph of its elements, the
+  union of the coarse graphs is partitioned on the first rank and
+  the result is refined in parallel on the elements */
+Splitter* makeGraphGlobalSplitter(Mesh* mesh);
+
+/** \brief Make a native graph partitioning Balancer object
+  \details partitions the global mesh as makeGraphGlobalSplitter
+  does into as many parts as there are ranks, then renumbers the
+  new parts to keep most elements in place */
+Balancer* makeGraphBalancer(Mesh* mesh);
+
 /** \brief Tag global ids of opposite elements to boundary faces
   \details this function creates a LONG tag of one value
   and attaches to all partition boundary faces the global
@@ -10,20 +10,34 @@
 
 namespace apf {
 
-Splitter* makeZoltanSplitter(Mesh*, int, int, bool, bool)
+bool hasZoltan()
 {
+  return false;
+}
+
+/* only GRAPH has a native counterpart, the other methods
+   still require Zoltan */
+
+Splitter* makeZoltanSplitter(Mesh* mesh, int method, int, bool, bool sync)
+{
+  if (method == GRAPH)
+    return makeGraphSplitter(mesh, sync);
   fail("apf_zoltan compiled empty !");
   return 0;
 }
 
-Splitter* makeZoltanGlobalSplitter(Mesh*, int, int, bool)
+Splitter* makeZoltanGlobalSplitter(Mesh* mesh, int method, int, bool)
 {
+  if (method == GRAPH)
+    return makeGraphGlobalSplitter(mesh);
   fail("apf_zoltan compiled empty !");
   return 0;
 }
 
-Balancer* makeZoltanBalancer(Mesh*, int, int, bool)
+Balancer* makeZoltanBalancer(Mesh* mesh, int method, int, bool)
 {
+  if (method == GRAPH)
+    return makeGraphBalancer(mesh);
   fail("apf_zoltan compiled empty !");
   return 0;
 }
@@ -7,12 +7,16 @@ include_directories("${CMAKE_CURRENT_SOURCE_DIR}")
 if(ENABLE_ZOLTAN)
   set(SOURCES
     apfInterElement.cc
+    apfGraphPartition.cc
+    apfGraphMesh.cc
     apfZoltan.cc
     apfZoltanMesh.cc
     apfZoltanCallbacks.cc)
 else()
   set(SOURCES
     apfInterElement.cc
+    apfGraphPartition.cc
+    apfGraphMesh.cc
     apfZoltanEmpty.cc)
 endif()
 